@@ -0,0 +1,94 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <time.h>
+
+#include "../inc/bytes.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+int read_u16(const unsigned char *p) { return p[0] | p[1] << 8; }
+
+int read_i32(const unsigned char *p) {
+  return (int)((unsigned)p[0] | (unsigned)p[1] << 8 | (unsigned)p[2] << 16 |
+               (unsigned)p[3] << 24);
+}
+
+unsigned long long read_u64(const unsigned char *p) {
+  const unsigned long long low = (unsigned)read_i32(p);
+  const unsigned long long high = (unsigned)read_i32(p + 4);
+  return high << 32 | low;
+}
+
+time_t read_time(const unsigned char *p) {
+  return (time_t)(long long)read_u64(p);
+}
+
+unsigned char *write_u16(unsigned char *cursor, const int value) {
+  cursor[0] = value & 0xFF;
+  cursor[1] = (value >> 8) & 0xFF;
+  return cursor + 2;
+}
+
+unsigned char *write_i32(unsigned char *cursor, const int value) {
+  const unsigned bits = (unsigned)value;
+  cursor[0] = bits & 0xFF;
+  cursor[1] = (bits >> 8) & 0xFF;
+  cursor[2] = (bits >> 16) & 0xFF;
+  cursor[3] = (bits >> 24) & 0xFF;
+  return cursor + 4;
+}
+
+unsigned char *write_u64(unsigned char *cursor,
+                         const unsigned long long value) {
+  cursor = write_i32(cursor, (int)(value & 0xFFFFFFFF));
+  return write_i32(cursor, (int)(value >> 32));
+}
+
+unsigned char *write_time(unsigned char *cursor, const time_t value) {
+  return write_u64(cursor, (unsigned long long)(long long)value);
+}
+
+const unsigned char *read_varint(const unsigned char *p,
+                                 const unsigned char *end, unsigned *value) {
+  *value = 0;
+  int shift = 0;
+  while (p < end && shift < 7 * VARINT_MAX_SIZE) {
+    // the last byte only has room for the 4 highest bits of the integer
+    if (shift == 7 * (VARINT_MAX_SIZE - 1) && *p > 0x0F) {
+      return NULL;
+    }
+    *value = *value | (unsigned)(*p & 0x7F) << shift;
+    if (!(*p & 0x80)) {
+      return p + 1;
+    }
+    p = p + 1;
+    shift = shift + 7;
+  }
+  return NULL;
+}
+
+int varint_size(unsigned value) {
+  int size = 1;
+  while (value >= 0x80) {
+    value = value >> 7;
+    size = size + 1;
+  }
+  return size;
+}
+
+unsigned char *write_varint(unsigned char *cursor, unsigned value) {
+  while (value >= 0x80) {
+    *cursor = (value & 0x7F) | 0x80;
+    cursor = cursor + 1;
+    value = value >> 7;
+  }
+  *cursor = value;
+  return cursor + 1;
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <limits.h>
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/bytes.h"
+#include "../inc/string.h"
+
+#include "../inc/codec.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Maps a signed integer to an unsigned one, so that integers close to
+ *        zero, negative or not, are mapped to small integers.
+ */
+static unsigned zigzag(const int value) {
+  return ((unsigned)value << 1) ^ (unsigned)(value < 0 ? -1 : 0);
+}
+
+/**
+ * @brief Inverts @c zigzag().
+ */
+static int unzigzag(const unsigned value) {
+  return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+int get_player_state_size(const Player *pl) {
+  return varint_size(get_position(pl)) + varint_size(zigzag(get_score(pl))) +
+         1;
+}
+
+unsigned char *encode_player_state(unsigned char *cursor, const Player *pl) {
+  cursor = write_varint(cursor, get_position(pl));
+  cursor = write_varint(cursor, zigzag(get_score(pl)));
+
+  const int turns_blocked = get_turns_blocked(pl);
+  if (turns_blocked == INDEF_BLOCK) {
+    *cursor = CODEC_INDEF_BLOCK;
+  } else if (turns_blocked > CODEC_MAX_BLOCK) {
+    *cursor = CODEC_MAX_BLOCK;  // players are blocked for a few turns at most
+  } else {
+    *cursor = turns_blocked;
+  }
+  return cursor + 1;
+}
+
+const unsigned char *decode_player_state(const unsigned char *p,
+                                         const unsigned char *end,
+                                         Player *pl) {
+  unsigned position;
+  unsigned score;
+  p = read_varint(p, end, &position);
+  if (!p || position > INT_MAX) {
+    return NULL;
+  }
+  p = read_varint(p, end, &score);
+  if (!p || p >= end) {
+    return NULL;
+  }
+
+  set_position(pl, position);
+  set_score(pl, unzigzag(score));
+  set_turns_blocked(pl, *p == CODEC_INDEF_BLOCK ? INDEF_BLOCK
+                                                : *p & CODEC_MAX_BLOCK);
+  return p + 1;
+}
+
+int get_game_size(GameState *gs) {
+  Players pls = get_players(gs);
+  const int name_len = strlen(get_game_name(gs));
+
+  int size = varint_size(name_len) + name_len + 1;
+  int i = 0;
+  while (i < get_players_num(&pls)) {
+    size = size + MAX_USERNAME_LENGTH +
+           get_player_state_size(get_player(&pls, i));
+    i = i + 1;
+  }
+  return size + 1;
+}
+
+unsigned char *encode_game(unsigned char *cursor, GameState *gs) {
+  Players pls = get_players(gs);
+  const Board board = get_board(gs);
+  const int name_len = strlen(get_game_name(gs));
+
+  cursor = write_varint(cursor, name_len);
+  cursor = (unsigned char *)str_put((char *)cursor, get_game_name(gs),
+                                    name_len);
+
+  *cursor = get_players_num(&pls);
+  cursor = cursor + 1;
+  int i = 0;
+  while (i < get_players_num(&pls)) {
+    const Player *pl = get_player(&pls, i);
+    // usernames are always padded to their maximum length
+    memset(cursor, STR_END, MAX_USERNAME_LENGTH);
+    memcpy(cursor, get_username(pl), strlen(get_username(pl)));
+    cursor = encode_player_state(cursor + MAX_USERNAME_LENGTH, pl);
+    i = i + 1;
+  }
+
+  *cursor = get_dim(&board);
+  return cursor + 1;
+}
+
+int decode_game(const unsigned char data[], const int size, GameState *gs) {
+  const unsigned char *end = data + size;
+  unsigned name_len;
+  const unsigned char *p = read_varint(data, end, &name_len);
+  if (!p || name_len >= MAX_BUFFER_LEN || (int)name_len >= end - p) {
+    return FALSE;
+  }
+  char game_name[MAX_BUFFER_LEN];
+  memcpy(game_name, p, name_len);
+  game_name[name_len] = STR_END;
+  set_game_name(gs, game_name);
+  p = p + name_len;
+
+  Players pls;
+  if (*p > MAX_NUM_PLAYERS) {
+    return FALSE;
+  }
+  set_players_num(&pls, *p);
+  p = p + 1;
+  int i = 0;
+  while (i < get_players_num(&pls)) {
+    if (end - p < MAX_USERNAME_LENGTH) {
+      return FALSE;
+    }
+    char username[MAX_USERNAME_LENGTH + 1];
+    memcpy(username, p, MAX_USERNAME_LENGTH);
+    username[MAX_USERNAME_LENGTH] = STR_END;
+
+    Player *pl = get_player(&pls, i);
+    set_username(pl, username);
+    set_id(pl);
+    p = decode_player_state(p + MAX_USERNAME_LENGTH, end, pl);
+    if (!p) {
+      return FALSE;
+    }
+    i = i + 1;
+  }
+  set_players(gs, &pls);
+
+  if (end - p != 1 || *p < MIN_NUM_SQUARES || *p > MAX_NUM_SQUARES) {
+    return FALSE;
+  }
+  Board board;
+  set_dim(&board, *p);
+  set_board(gs, &board);
+  return TRUE;
+}
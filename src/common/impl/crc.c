@@ -0,0 +1,144 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <nmmintrin.h>
+#define HAS_CRC_INTRINSICS 1
+#else
+#define HAS_CRC_INTRINSICS 0
+#endif
+
+#include "../inc/crc.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The bit of the @c ecx register set by @c cpuid when SSE4.2 is
+ *        supported.
+ */
+#define SSE42_CPUID_BIT (1 << 20)
+
+/**
+ * @brief Whether the processor supports SSE4.2, set once by @c init_crc().
+ */
+static int has_sse42 = FALSE;
+
+/**
+ * @brief The state of the one-time initialization of the checksums.
+ */
+static INIT_ONCE crc_init = INIT_ONCE_STATIC_INIT;
+
+/**
+ * @brief The checksum of every byte, used when SSE4.2 is not supported.
+ */
+static unsigned crc_table[256];
+
+/**
+ * @brief Builds the lookup table of the checksum of every byte.
+ */
+static void build_crc_table(void) {
+  int i = 0;
+  while (i < 256) {
+    unsigned crc = i;
+    int bit = 0;
+    while (bit < 8) {
+      crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+      bit = bit + 1;
+    }
+    crc_table[i] = crc;
+    i = i + 1;
+  }
+}
+
+/**
+ * @brief Updates a checksum one byte at a time with the lookup table.
+ */
+static unsigned crc32c_table(unsigned crc, const unsigned char data[],
+                             const int size) {
+  int i = 0;
+  while (i < size) {
+    crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    i = i + 1;
+  }
+  return crc;
+}
+
+#if HAS_CRC_INTRINSICS
+/**
+ * @brief Updates a checksum with the @c crc32 instruction, eight bytes at a
+ *        time on 64 bit builds and four bytes at a time otherwise.
+ */
+static unsigned crc32c_sse42(unsigned crc, const unsigned char data[],
+                             const int size) {
+  int i = 0;
+#if defined(_M_X64)
+  unsigned long long crc64 = crc;
+  while (i + 8 <= size) {
+    unsigned long long word;
+    memcpy(&word, data + i, 8);
+    crc64 = _mm_crc32_u64(crc64, word);
+    i = i + 8;
+  }
+  crc = (unsigned)crc64;
+#endif
+  while (i + 4 <= size) {
+    unsigned word;
+    memcpy(&word, data + i, 4);
+    crc = _mm_crc32_u32(crc, word);
+    i = i + 4;
+  }
+  while (i < size) {
+    crc = _mm_crc32_u8(crc, data[i]);
+    i = i + 1;
+  }
+  return crc;
+}
+#endif
+
+/**
+ * @brief Checks whether the processor supports SSE4.2, and builds the lookup
+ *        table if it does not.
+ *
+ * It is run once by @c InitOnceExecuteOnce(), which makes the table and the
+ * flag visible to every thread before any of them computes a checksum.
+ */
+static BOOL CALLBACK init_crc(PINIT_ONCE once, PVOID param, PVOID *context) {
+  // the signature is the one InitOnceExecuteOnce() expects, nothing is passed
+  (void)once;
+  (void)param;
+  (void)context;
+
+  int is_supported = FALSE;
+#if HAS_CRC_INTRINSICS
+  int regs[4];
+  __cpuid(regs, 1);
+  is_supported = (regs[2] & SSE42_CPUID_BIT) != 0;
+#endif
+  if (!is_supported) {
+    build_crc_table();
+  }
+  has_sse42 = is_supported;
+  return TRUE;
+}
+
+unsigned crc32c(const unsigned char data[], const int size) {
+  // threads may compute their first checksums at the same time
+  InitOnceExecuteOnce(&crc_init, init_crc, NULL, NULL);
+
+#if HAS_CRC_INTRINSICS
+  if (has_sse42) {
+    return ~crc32c_sse42(0xFFFFFFFFu, data, size);
+  }
+#endif
+  return ~crc32c_table(0xFFFFFFFFu, data, size);
+}
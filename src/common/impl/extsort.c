@@ -0,0 +1,343 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/merge.h"
+#include "../inc/ranktree.h"
+#include "../inc/string.h"
+#include "../inc/types/entry.h"
+
+#include "../inc/extsort.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Rebuilds an entry from its order (see @c rank_key()).
+ */
+static void decode_key(const unsigned long long key, Entry *e) {
+  char name[MAX_USERNAME_LENGTH + 1];
+  int i = 0;
+  while (i < MAX_USERNAME_LENGTH) {
+    name[i] = (char)(key >> (8 * (MAX_USERNAME_LENGTH - 1 - i)));
+    i = i + 1;
+  }
+  name[MAX_USERNAME_LENGTH] = STR_END;
+  set_name(e, name);
+  set_final_score(e, (int)(~(unsigned)(key >> 32) ^ 0x80000000u));
+}
+
+/**
+ * @brief Sorts the orders of entries, one byte at a time from the last one,
+ *        skipping the bytes every order has the same.
+ *
+ * Scores are mostly small, so most of their bytes are skipped.
+ *
+ * @return Either @e keys or @e tmp, whichever holds the sorted orders.
+ */
+static unsigned long long *sort_keys(unsigned long long keys[],
+                                     unsigned long long tmp[],
+                                     const int num_keys) {
+  unsigned long long *from = keys;
+  unsigned long long *to = tmp;
+  int byte = 0;
+  while (byte < 8) {
+    const int shift = 8 * byte;
+    int starts[256];
+    memset(starts, 0, sizeof(starts));
+    int i = 0;
+    while (i < num_keys) {
+      const int digit = (from[i] >> shift) & 0xFF;
+      starts[digit] = starts[digit] + 1;
+      i = i + 1;
+    }
+    if (num_keys == 0 || starts[(from[0] >> shift) & 0xFF] == num_keys) {
+      byte = byte + 1;
+      continue;
+    }
+    int start = 0;
+    i = 0;
+    while (i < 256) {
+      const int count = starts[i];
+      starts[i] = start;
+      start = start + count;
+      i = i + 1;
+    }
+    i = 0;
+    while (i < num_keys) {
+      const int digit = (from[i] >> shift) & 0xFF;
+      to[starts[digit]] = from[i];
+      starts[digit] = starts[digit] + 1;
+      i = i + 1;
+    }
+    unsigned long long *sorted = to;
+    to = from;
+    from = sorted;
+    byte = byte + 1;
+  }
+  return from;
+}
+
+/**
+ * @brief Sorts a run in order of rank, keeps the first entry of each player,
+ *        the one with the best score, and writes it to its file.
+ *
+ * @return @c TRUE if the run has been written, @c FALSE otherwise.
+ */
+static int write_run(SortJob *job) {
+  const int n = job->num_entries;
+  unsigned long long *keys = (unsigned long long *)malloc(  // NOLINT
+      (n + 1) * sizeof(unsigned long long));
+  unsigned long long *tmp = (unsigned long long *)malloc(  // NOLINT
+      (n + 1) * sizeof(unsigned long long));
+  unsigned char *seen = (unsigned char *)calloc(  // NOLINT
+      SORT_BYTES_PER_RUN, 1);
+  if (!keys || !tmp || !seen) {
+    free(keys);
+    free(tmp);
+    free(seen);
+    return FALSE;
+  }
+  int i = 0;
+  while (i < n) {
+    keys[i] = rank_key(&job->entries[i]);
+    i = i + 1;
+  }
+  const unsigned long long *sorted = sort_keys(keys, tmp, n);
+
+  int num_players = 0;
+  i = 0;
+  while (i < n) {
+    const unsigned name = (unsigned)sorted[i];
+    const unsigned char bit = 1 << (name % 8);
+    if (!(seen[name / 8] & bit)) {
+      seen[name / 8] = seen[name / 8] | bit;
+      decode_key(sorted[i], &job->entries[num_players]);
+      num_players = num_players + 1;
+    }
+    i = i + 1;
+  }
+  job->num_entries = num_players;
+  free(keys);
+  free(tmp);
+  free(seen);
+
+  int size;
+  unsigned char *data = layout_rank_tree(job->entries, num_players, &size);
+  if (!data) {
+    return FALSE;
+  }
+  FILE *fp;
+  if (fopen_s(&fp, job->path, "wb")) {
+    free(data);
+    return FALSE;
+  }
+  const int written = fwrite(data, 1, size, fp);
+  const int is_closed = fclose(fp) == 0;
+  free(data);
+  return written == size && is_closed;
+}
+
+/**
+ * @brief The body of a thread sorting a run.
+ */
+static DWORD WINAPI sort_run(LPVOID arg) {
+  SortJob *job = (SortJob *)arg;
+  job->is_written = write_run(job);
+  return 0;
+}
+
+/**
+ * @brief Waits for the thread sorting a run, if any.
+ *
+ * @return @c FALSE if the run could not be written, @c TRUE otherwise.
+ */
+static int wait_job(SortJob *job) {
+  if (!job->thread) {
+    return TRUE;
+  }
+  WaitForSingleObject(job->thread, INFINITE);
+  CloseHandle(job->thread);
+  job->thread = NULL;
+  return job->is_written;
+}
+
+/**
+ * @brief Builds the path of the file of a run.
+ */
+static void run_path(const EntrySorter *s, const int run, char path[]) {
+  snprintf(path, MAX_BUFFER_LEN, "%s%s%i", s->prefix, SORT_RUN_SUFFIX, run);
+}
+
+/**
+ * @brief Hands the entries added over to a thread, as a new run.
+ */
+static void hand_over(EntrySorter *s) {
+  logger.enter_fn(__func__);
+
+  SortJob *job = &s->jobs[s->next_job];
+  s->next_job = (s->next_job + 1) % SORT_THREADS;
+  if (!wait_job(job)) {
+    logger.log("can not write run to %s", job->path);
+    logger.stop();
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+  if (!job->entries) {
+    job->entries = (Entry *)malloc(  // NOLINT
+        s->run_capacity * sizeof(Entry));
+    if (!job->entries) {
+      logger.stop();
+      throw_err(ALLOCATION_ERROR);
+    }
+  }
+
+  // the buffers are swapped, so the one the run was in is filled again
+  Entry *entries = job->entries;
+  job->entries = s->entries;
+  job->num_entries = s->num_entries;
+  s->entries = entries;
+  s->num_entries = 0;
+  run_path(s, s->num_runs, job->path);
+  job->is_written = FALSE;
+  logger.log("sorting run %i of %i entries", s->num_runs, job->num_entries);
+  s->num_runs = s->num_runs + 1;
+
+  job->thread = CreateThread(NULL, 0, sort_run, job, 0, NULL);
+  if (!job->thread) {
+    logger.log("can not start the thread");
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  logger.exit_fn();
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+EntrySorter *new_entry_sorter(const char prefix[], const int budget) {
+  logger.enter_fn(__func__);
+
+  EntrySorter *s = (EntrySorter *)malloc(sizeof(EntrySorter));  // NOLINT
+  if (!s) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  snprintf(s->prefix, MAX_BUFFER_LEN, "%s", prefix);
+  const int entries_budget = budget - SORT_THREADS * SORT_BYTES_PER_RUN;
+  s->run_capacity = 0;
+  if (entries_budget > 0) {
+    s->run_capacity =
+        entries_budget / (sizeof(Entry) + SORT_THREADS * SORT_BYTES_PER_ENTRY);
+  }
+  if (s->run_capacity < SORT_MIN_RUN_ENTRIES) {
+    s->run_capacity = SORT_MIN_RUN_ENTRIES;
+  }
+  s->entries = (Entry *)malloc(s->run_capacity * sizeof(Entry));  // NOLINT
+  if (!s->entries) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  s->num_entries = 0;
+  int i = 0;
+  while (i < SORT_THREADS) {
+    s->jobs[i].entries = NULL;
+    s->jobs[i].num_entries = 0;
+    s->jobs[i].path[0] = STR_END;
+    s->jobs[i].is_written = FALSE;
+    s->jobs[i].thread = NULL;
+    i = i + 1;
+  }
+  s->next_job = 0;
+  s->num_runs = 0;
+  s->num_added = 0;
+  s->runs = NULL;
+  logger.log("sorting runs of %i entries", s->run_capacity);
+
+  logger.exit_fn();
+  return s;
+}
+
+void add_sort_entry(EntrySorter *s, const Entry *e) {
+  s->entries[s->num_entries] = *e;
+  s->num_entries = s->num_entries + 1;
+  s->num_added = s->num_added + 1;
+  if (s->num_entries == s->run_capacity) {
+    hand_over(s);
+  }
+}
+
+int finish_entry_sort(EntrySorter *s) {
+  logger.enter_fn(__func__);
+
+  if (s->num_entries > 0) {
+    hand_over(s);
+  }
+  int is_written = TRUE;
+  int i = 0;
+  while (i < SORT_THREADS) {
+    is_written = wait_job(&s->jobs[i]) && is_written;
+    i = i + 1;
+  }
+  if (!is_written) {
+    logger.log("can not write runs");
+    logger.stop();
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+
+  // one more item than needed, since malloc() may give NULL for a sort
+  // without runs
+  s->runs = (RankTree **)malloc(  // NOLINT
+      (s->num_runs + 1) * sizeof(RankTree *));
+  if (!s->runs) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  i = 0;
+  while (i < s->num_runs) {
+    char path[MAX_BUFFER_LEN];
+    run_path(s, i, path);
+    s->runs[i] = open_rank_tree(path);
+    i = i + 1;
+  }
+  logger.log("sorted %i entries in %i runs", s->num_added, s->num_runs);
+
+  logger.exit_fn();
+  return s->num_runs;
+}
+
+void free_entry_sorter(EntrySorter *s) {
+  if (!s) {
+    return;
+  }
+  int i = 0;
+  while (i < SORT_THREADS) {
+    wait_job(&s->jobs[i]);
+    free(s->jobs[i].entries);
+    i = i + 1;
+  }
+  i = 0;
+  while (i < s->num_runs) {
+    if (s->runs) {
+      close_rank_tree(s->runs[i]);
+    }
+    char path[MAX_BUFFER_LEN];
+    run_path(s, i, path);
+    remove(path);
+    i = i + 1;
+  }
+  free(s->runs);
+  free(s->entries);
+  free(s);
+}
@@ -0,0 +1,427 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <io.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+
+#include "../inc/iopool.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A thread of the pool and the requests queued to it.
+ */
+typedef struct IoWorker {
+  IoRequest *head;           ///< The next request to carry out.
+  IoRequest *tail;           ///< The last request queued.
+  IoRequest *running;        ///< The request being carried out.
+  CONDITION_VARIABLE queued;  ///< Signalled when a request is queued.
+  void *thread;              ///< The handle of the thread.
+} IoWorker;
+
+static IoWorker workers[IO_POOL_THREADS];
+static CRITICAL_SECTION pool_lock;
+static CONDITION_VARIABLE pool_done;  // signalled when a request is done
+static int is_pool_running = FALSE;
+static int is_pool_stopping = FALSE;
+
+/**
+ * @brief Chooses the thread that writes a file, from its path.
+ */
+static IoWorker *worker_of(const char path[]) {
+  unsigned hash = 0;
+  int i = 0;
+  while (path[i] != STR_END) {
+    hash = hash * 31 + (unsigned char)path[i];
+    i = i + 1;
+  }
+  return &workers[hash % IO_POOL_THREADS];
+}
+
+/**
+ * @brief Writes the buffered bytes of a file through to the disk.
+ *
+ * @c fflush() only hands them over to the system, which may still write them
+ * after bytes written later, so each write that others depend on is committed.
+ *
+ * @return @c TRUE if the bytes are on disk, @c FALSE otherwise.
+ */
+static int commit_file(FILE *fp) {
+  return fflush(fp) == 0 && _commit(_fileno(fp)) == 0;
+}
+
+/**
+ * @brief Writes the segments of a request in place, then cuts the file after
+ *        the last one if the request asks for it.
+ */
+static int write_segments(const IoRequest *req) {
+  FILE *fp;
+  if (fopen_s(&fp, req->path, "r+b")) {
+    return FALSE;
+  }
+  int is_written = TRUE;
+  const unsigned char *data = req->data;
+  int i = 0;
+  while (i < req->num_segments) {
+    const IoSegment *seg = &req->segments[i];
+    fseek(fp, seg->offset, SEEK_SET);
+    is_written = is_written &&
+                 (int)fwrite(data, 1, seg->size, fp) == seg->size &&
+                 commit_file(fp);
+    data = data + seg->size;
+    i = i + 1;
+  }
+  if (req->kind == IO_TRUNCATE && is_written) {
+    const IoSegment *last = &req->segments[req->num_segments - 1];
+    is_written = _chsize_s(_fileno(fp), last->offset + last->size) == 0 &&
+                 commit_file(fp);
+  }
+  return fclose(fp) == 0 && is_written;
+}
+
+/**
+ * @brief Writes a content to a temporary file and renames it over a file.
+ */
+static int replace_content(const char path[], const unsigned char data[],
+                           const int size) {
+  char temp[MAX_BUFFER_LEN];
+  snprintf(temp, MAX_BUFFER_LEN, "%s%s", path, TEMP_FILE_SUFFIX);
+
+  FILE *fp;
+  if (fopen_s(&fp, temp, "wb")) {
+    return FALSE;
+  }
+  const int written = fwrite(data, 1, size, fp);
+  const int is_committed = commit_file(fp);
+  const int is_closed = fclose(fp) == 0;
+
+  // the file is only replaced once the new content is entirely on disk
+  if (written != size || !is_committed || !is_closed ||
+      !MoveFileExA(temp, path,
+                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    remove(temp);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Reads a file back and replaces it with the content computed by the
+ *        function of a request.
+ */
+static int rewrite_content(const IoRequest *req) {
+  FILE *fp;
+  if (fopen_s(&fp, req->path, "rb")) {
+    return FALSE;
+  }
+  fseek(fp, 0L, SEEK_END);
+  const long size = ftell(fp);
+  fseek(fp, 0L, SEEK_SET);
+  unsigned char *content = (unsigned char *)malloc(size + 1);  // NOLINT
+  const int is_read =
+      content && size >= 0 && (long)fread(content, 1, size, fp) == size;
+  fclose(fp);
+  if (!is_read) {
+    free(content);
+    return FALSE;
+  }
+
+  int new_size = 0;
+  unsigned char *rewritten = req->rewrite(content, size, &new_size);
+  free(content);
+  if (!rewritten) {
+    return TRUE;  // the file is left as it is
+  }
+  const int is_replaced = replace_content(req->path, rewritten, new_size);
+  free(rewritten);
+  return is_replaced;
+}
+
+/**
+ * @brief Carries out a request and frees its data.
+ *
+ * @return The status of the request once carried out.
+ */
+static int run_io(IoRequest *req) {
+  int is_written;
+  if (req->kind == IO_REPLACE) {
+    is_written = replace_content(req->path, req->data, req->segments[0].size);
+  } else {
+    is_written = write_segments(req);
+    if (is_written && req->kind == IO_REWRITE) {
+      is_written = rewrite_content(req);
+    }
+  }
+  free(req->data);
+  req->data = NULL;
+  return is_written ? IO_DONE : IO_FAILED;
+}
+
+/**
+ * @brief The body of a thread of the pool.
+ *
+ * It carries out the requests queued to it one at a time, without holding the
+ * lock while writing, until the pool is stopped and its queue is empty.
+ */
+static DWORD WINAPI run_pending(LPVOID arg) {
+  IoWorker *w = (IoWorker *)arg;
+
+  EnterCriticalSection(&pool_lock);
+  while (w->head || !is_pool_stopping) {
+    if (!w->head) {
+      SleepConditionVariableCS(&w->queued, &pool_lock, INFINITE);
+      continue;
+    }
+    IoRequest *req = w->head;
+    w->head = req->next;
+    if (!w->head) {
+      w->tail = NULL;
+    }
+    w->running = req;
+    LeaveCriticalSection(&pool_lock);
+
+    const int status = run_io(req);
+
+    EnterCriticalSection(&pool_lock);
+    req->status = status;
+    w->running = NULL;
+    WakeAllConditionVariable(&pool_done);
+  }
+  LeaveCriticalSection(&pool_lock);
+
+  return 0;
+}
+
+void start_io_pool(void) {
+  logger.enter_fn(__func__);
+  logger.log("starting %i threads", IO_POOL_THREADS);
+
+  InitializeCriticalSection(&pool_lock);
+  InitializeConditionVariable(&pool_done);
+  is_pool_stopping = FALSE;
+
+  int i = 0;
+  while (i < IO_POOL_THREADS) {
+    IoWorker *w = &workers[i];
+    w->head = NULL;
+    w->tail = NULL;
+    w->running = NULL;
+    InitializeConditionVariable(&w->queued);
+    w->thread = CreateThread(NULL, 0, run_pending, w, 0, NULL);
+    if (!w->thread) {
+      logger.log("can not start the thread");
+      logger.stop();
+      throw_err(ALLOCATION_ERROR);
+    }
+    i = i + 1;
+  }
+  is_pool_running = TRUE;
+
+  logger.exit_fn();
+}
+
+void stop_io_pool(void) {
+  logger.enter_fn(__func__);
+
+  EnterCriticalSection(&pool_lock);
+  is_pool_stopping = TRUE;
+  int i = 0;
+  while (i < IO_POOL_THREADS) {
+    WakeConditionVariable(&workers[i].queued);
+    i = i + 1;
+  }
+  LeaveCriticalSection(&pool_lock);
+
+  i = 0;
+  while (i < IO_POOL_THREADS) {
+    WaitForSingleObject(workers[i].thread, INFINITE);
+    CloseHandle(workers[i].thread);
+    i = i + 1;
+  }
+  is_pool_running = FALSE;
+  DeleteCriticalSection(&pool_lock);
+  logger.log("stopped %i threads", IO_POOL_THREADS);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Allocates a request and queues it to the thread of its file, or
+ *        carries it out right away if the pool is not running.
+ */
+static IoRequest *submit_io(const char path[], const int kind,
+                            unsigned char *data, const IoSegment segments[],
+                            const int num_segments, IoRewrite rewrite) {
+  IoRequest *req = (IoRequest *)malloc(sizeof(IoRequest));  // NOLINT
+  if (!req) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  snprintf(req->path, MAX_BUFFER_LEN, "%s", path);
+  req->kind = kind;
+  req->data = data;
+  memcpy(req->segments, segments, num_segments * sizeof(IoSegment));
+  req->num_segments = num_segments;
+  req->rewrite = rewrite;
+  req->status = IO_PENDING;
+  req->next = NULL;
+
+  if (!is_pool_running) {
+    req->status = run_io(req);
+    return req;
+  }
+
+  EnterCriticalSection(&pool_lock);
+  IoWorker *w = worker_of(path);
+  if (w->tail) {
+    w->tail->next = req;
+  } else {
+    w->head = req;
+  }
+  w->tail = req;
+  WakeConditionVariable(&w->queued);
+  LeaveCriticalSection(&pool_lock);
+
+  return req;
+}
+
+IoRequest *submit_write(const char path[], unsigned char *data,
+                        const IoSegment segments[], const int num_segments) {
+  logger.enter_fn(__func__);
+
+  int size = 0;
+  int i = 0;
+  while (i < num_segments) {
+    size = size + segments[i].size;
+    i = i + 1;
+  }
+  IoRequest *req =
+      submit_io(path, IO_WRITE, data, segments, num_segments, NULL);
+  logger.log("queued %i bytes in %i segments of '%s'", size, num_segments,
+             path);
+
+  logger.exit_fn();
+  return req;
+}
+
+IoRequest *submit_truncate(const char path[], unsigned char *data,
+                           const IoSegment segments[], const int num_segments) {
+  logger.enter_fn(__func__);
+
+  const IoSegment *last = &segments[num_segments - 1];
+  IoRequest *req = submit_io(path, IO_TRUNCATE, data, segments, num_segments,
+                             NULL);
+  logger.log("queued %i segments of '%s', cut at %i", num_segments, path,
+             last->offset + last->size);
+
+  logger.exit_fn();
+  return req;
+}
+
+IoRequest *submit_rewrite(const char path[], unsigned char *data,
+                          const IoSegment segments[], const int num_segments,
+                          IoRewrite rewrite) {
+  logger.enter_fn(__func__);
+
+  IoRequest *req =
+      submit_io(path, IO_REWRITE, data, segments, num_segments, rewrite);
+  logger.log("queued %i segments of '%s', then a rewrite", num_segments,
+             path);
+
+  logger.exit_fn();
+  return req;
+}
+
+IoRequest *submit_replace(const char path[], unsigned char *data,
+                          const int size) {
+  logger.enter_fn(__func__);
+
+  const IoSegment content = {0, size};
+  IoRequest *req = submit_io(path, IO_REPLACE, data, &content, 1, NULL);
+  logger.log("queued %i bytes to replace '%s'", size, path);
+
+  logger.exit_fn();
+  return req;
+}
+
+int poll_io(IoRequest *req) {
+  if (!is_pool_running) {
+    return req->status;
+  }
+  EnterCriticalSection(&pool_lock);
+  const int status = req->status;
+  LeaveCriticalSection(&pool_lock);
+  return status;
+}
+
+void finish_io(IoRequest *req) {
+  if (!req) {
+    return;
+  }
+  logger.enter_fn(__func__);
+
+  if (is_pool_running) {
+    EnterCriticalSection(&pool_lock);
+    while (req->status == IO_PENDING) {
+      SleepConditionVariableCS(&pool_done, &pool_lock, INFINITE);
+    }
+    LeaveCriticalSection(&pool_lock);
+  }
+
+  if (req->status == IO_FAILED) {
+    logger.log("can not write '%s'", req->path);
+    logger.stop();
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+  free(req);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Checks whether a thread still has to carry out a request on a file.
+ */
+static int has_pending_io(const IoWorker *w, const char path[]) {
+  if (w->running && strcmp(w->running->path, path) == 0) {
+    return TRUE;
+  }
+  const IoRequest *req = w->head;
+  while (req) {
+    if (strcmp(req->path, path) == 0) {
+      return TRUE;
+    }
+    req = req->next;
+  }
+  return FALSE;
+}
+
+void wait_file_io(const char path[]) {
+  if (!is_pool_running) {
+    return;
+  }
+  logger.enter_fn(__func__);
+
+  const IoWorker *w = worker_of(path);
+  EnterCriticalSection(&pool_lock);
+  if (has_pending_io(w, path)) {
+    logger.log("waiting for the writes of '%s'", path);
+  }
+  while (has_pending_io(w, path)) {
+    SleepConditionVariableCS(&pool_done, &pool_lock, INFINITE);
+  }
+  LeaveCriticalSection(&pool_lock);
+
+  logger.exit_fn();
+}
@@ -0,0 +1,402 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/bytes.h"
+#include "../inc/crc.h"
+#include "../inc/error.h"
+#include "../inc/iopool.h"
+#include "../inc/logger.h"
+#include "../inc/string.h"
+
+#include "../inc/journal.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A record whose checksum matches.
+ */
+#define RECORD_VALID 0
+
+/**
+ * @brief A record whose checksum does not match, followed by other records.
+ */
+#define RECORD_CORRUPTED 1
+
+/**
+ * @brief The tail of an interrupted append, which ends the journal.
+ */
+#define RECORD_TORN 2
+
+/**
+ * @brief The empty slot of the table of the keys of a compacted journal.
+ */
+#define NO_KEY -1
+
+/**
+ * @brief Reads the record at an offset of a journal, with at least
+ *        @c JOURNAL_RECORD_HEADER_SIZE bytes left from there.
+ *
+ * @return One of @c RECORD_VALID, @c RECORD_CORRUPTED or @c RECORD_TORN.
+ */
+static int parse_record(const unsigned char data[], const int size,
+                        const int offset, JournalRecord *rec) {
+  const unsigned char *header = data + offset;
+  rec->size = read_u16(header);
+  rec->data = header + JOURNAL_RECORD_HEADER_SIZE;
+  if (rec->size > size - offset - JOURNAL_RECORD_HEADER_SIZE) {
+    return RECORD_TORN;
+  }
+
+  // the last record may be torn, any other one has been corrupted
+  if ((unsigned)read_i32(header + 2) != crc32c(rec->data, rec->size)) {
+    return offset + JOURNAL_RECORD_HEADER_SIZE + rec->size == size
+               ? RECORD_TORN
+               : RECORD_CORRUPTED;
+  }
+  return RECORD_VALID;
+}
+
+/**
+ * @brief Finds the slot of a key, or the empty slot where it would go, by
+ *        Fibonacci hashing as in nameindex.c.
+ */
+static int find_key_slot(const int slots[], const int bits,
+                         const unsigned char *const latest[],
+                         const unsigned key) {
+  const unsigned mask = (1u << bits) - 1;
+  unsigned slot = (key * 2654435769u) >> (32 - bits);
+  while (slots[slot] != NO_KEY &&
+         (unsigned)read_i32(latest[slots[slot]]) != key) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+/**
+ * @brief Finds the end of a journal compacted by the I/O pool since it was
+ *        last written, which is the end of the file.
+ */
+static void find_journal_end(const char path[], Journal *j) {
+  logger.enter_fn(__func__);
+
+  wait_file_io(path);
+  FILE *fp;
+  if (fopen_s(&fp, path, "rb")) {
+    logger.log("file is not readable");
+    logger.stop();
+    throw_err(FILE_NOT_READABLE_ERROR);
+  }
+  fseek(fp, 0L, SEEK_END);
+  j->size = ftell(fp);
+  j->end = j->size;
+  fclose(fp);
+
+  logger.log("compacted to %i bytes", j->size);
+  logger.exit_fn();
+}
+
+/**
+ * @brief Appends a record to a journal, then has the I/O pool rewrite the
+ *        journal with a function unless it is @c NULL.
+ */
+static IoRequest *append_record(const char path[], Journal *j,
+                                const unsigned char data[], const int size,
+                                IoRewrite compact) {
+  logger.enter_fn(__func__);
+
+  if (j->end == JOURNAL_END_UNKNOWN) {
+    find_journal_end(path, j);
+  }
+  unsigned char *buffer = (unsigned char *)malloc(  // NOLINT
+      JOURNAL_HEADER_SIZE + JOURNAL_RECORD_HEADER_SIZE + size);
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  // the header is only written along with the first record
+  unsigned char *cursor = buffer;
+  if (j->end == 0) {
+    cursor = write_journal_header(cursor);
+  }
+  cursor = write_journal_record(cursor, data, size);
+
+  // bytes left past the last record, such as a torn one, are dropped so that
+  // they are not read back as a corrupted record after this one, and the
+  // compaction waits for the next append
+  const IoSegment appended = {j->end, cursor - buffer};
+  const int is_compacted = compact && j->size <= j->end;
+  IoRequest *req;
+  if (j->size > j->end) {
+    req = submit_truncate(path, buffer, &appended, 1);
+  } else if (is_compacted) {
+    req = submit_rewrite(path, buffer, &appended, 1, compact);
+  } else {
+    req = submit_write(path, buffer, &appended, 1);
+  }
+  logger.log("appending %i bytes to '%s'", size, path);
+
+  if (is_compacted) {
+    // the size of the compacted journal is only known once it is written
+    logger.log("compacting '%s' in the background", path);
+    j->size = JOURNAL_END_UNKNOWN;
+    j->end = JOURNAL_END_UNKNOWN;
+    j->num_records = 0;
+  } else {
+    j->end = j->end + appended.size;
+    j->size = j->end;
+    j->num_records = j->num_records + 1;
+  }
+
+  logger.exit_fn();
+  return req;
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+unsigned char *write_journal_header(unsigned char *cursor) {
+  cursor = (unsigned char *)str_put((char *)cursor, JOURNAL_MAGIC,
+                                    JOURNAL_MAGIC_LEN);
+  cursor = write_u16(cursor, JOURNAL_VERSION);
+  return write_u16(cursor, 0);  // reserved
+}
+
+unsigned char *write_journal_record(unsigned char *cursor,
+                                    const unsigned char data[],
+                                    const int size) {
+  cursor = write_u16(cursor, size);
+  cursor = write_i32(cursor, crc32c(data, size));
+  return (unsigned char *)str_put((char *)cursor, (const char *)data, size);
+}
+
+Journal *open_journal(const char path[]) {
+  logger.enter_fn(__func__);
+  logger.log("attempting to read journal '%s'", path);
+
+  wait_file_io(path);
+  FILE *fp;
+  if (fopen_s(&fp, path, "rb")) {
+    logger.log("file is not readable");
+    logger.stop();
+    throw_err(FILE_NOT_READABLE_ERROR);
+  }
+  fseek(fp, 0L, SEEK_END);
+  const long size = ftell(fp);
+  fseek(fp, 0L, SEEK_SET);
+
+  Journal *j = (Journal *)malloc(sizeof(Journal));  // NOLINT
+  if (!j) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  j->size = size;
+  j->data = (unsigned char *)malloc(j->size + 1);  // NOLINT
+  if (!j->data) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  j->size = fread(j->data, 1, j->size, fp);
+  fclose(fp);
+
+  // a file shorter than the header is the tail of an interrupted first append
+  if (j->size >= JOURNAL_HEADER_SIZE &&
+      (memcmp(j->data, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) != 0 ||
+       read_u16(j->data + JOURNAL_MAGIC_LEN) != JOURNAL_VERSION)) {
+    logger.log("not a journal or unsupported version");
+    logger.stop();
+    throw_err(CORRUPTED_JOURNAL_ERROR);
+  }
+  j->end = j->size >= JOURNAL_HEADER_SIZE ? JOURNAL_HEADER_SIZE : 0;
+  j->num_records = 0;
+  j->num_corrupted = 0;
+
+  logger.log("read %i bytes", j->size);
+  logger.exit_fn();
+  return j;
+}
+
+int next_journal_record(Journal *j, JournalRecord *rec) {
+  while (j->size - j->end >= JOURNAL_RECORD_HEADER_SIZE) {
+    const int kind = parse_record(j->data, j->size, j->end, rec);
+    if (kind == RECORD_TORN) {
+      logger.log("journal ends with a torn record at %i", j->end);
+      return FALSE;
+    }
+    const int next = j->end + JOURNAL_RECORD_HEADER_SIZE + rec->size;
+    if (kind == RECORD_CORRUPTED) {
+      logger.log("skipping corrupted record at %i", j->end);
+      j->num_corrupted = j->num_corrupted + 1;
+      j->end = next;
+      continue;
+    }
+
+    j->end = next;
+    j->num_records = j->num_records + 1;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+void close_journal(Journal *j) {
+  free(j->data);
+  free(j);
+}
+
+void release_journal(Journal *j) {
+  free(j->data);
+  j->data = NULL;
+}
+
+IoRequest *append_journal(const char path[], Journal *j,
+                          const unsigned char data[], const int size) {
+  return append_record(path, j, data, size, NULL);
+}
+
+IoRequest *append_compact_journal(const char path[], Journal *j,
+                                  const unsigned char data[], const int size,
+                                  IoRewrite compact) {
+  return append_record(path, j, data, size, compact);
+}
+
+unsigned char *compact_keyed_journal(const unsigned char content[],
+                                     const int size, const int entry_size,
+                                     const int max_entries,
+                                     JournalCheck is_valid, int *new_size) {
+  if (size < JOURNAL_HEADER_SIZE ||
+      memcmp(content, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) != 0 ||
+      read_u16(content + JOURNAL_MAGIC_LEN) != JOURNAL_VERSION) {
+    return NULL;
+  }
+
+  // there are no more keys than entries fitting in the file, and the table
+  // of the keys is kept at most half full
+  const int max_keys = size / entry_size + 1;
+  int bits = 1;
+  while ((1 << bits) < 2 * max_keys) {
+    bits = bits + 1;
+  }
+  int *slots = (int *)malloc((1 << bits) * sizeof(int));  // NOLINT
+  const unsigned char **latest = (const unsigned char **)malloc(  // NOLINT
+      max_keys * sizeof(const unsigned char *));
+  if (!slots || !latest) {
+    free(slots);
+    free(latest);
+    return NULL;
+  }
+  int i = 0;
+  while (i < (1 << bits)) {
+    slots[i] = NO_KEY;
+    i = i + 1;
+  }
+
+  // the records are read as next_journal_record() does, and the keys keep
+  // the order they first appear in
+  int num_keys = 0;
+  int offset = JOURNAL_HEADER_SIZE;
+  JournalRecord rec;
+  while (size - offset >= JOURNAL_RECORD_HEADER_SIZE) {
+    const int kind = parse_record(content, size, offset, &rec);
+    if (kind == RECORD_TORN) {
+      break;
+    }
+    offset = offset + JOURNAL_RECORD_HEADER_SIZE + rec.size;
+    if (kind == RECORD_CORRUPTED || rec.size % entry_size != 0 ||
+        !is_valid(rec.data, rec.size)) {
+      continue;
+    }
+    i = 0;
+    while (i < rec.size) {
+      const unsigned char *entry = rec.data + i;
+      const int slot =
+          find_key_slot(slots, bits, latest, (unsigned)read_i32(entry));
+      if (slots[slot] == NO_KEY) {
+        slots[slot] = num_keys;
+        num_keys = num_keys + 1;
+      }
+      latest[slots[slot]] = entry;
+      i = i + entry_size;
+    }
+  }
+
+  const int num_records = (num_keys + max_entries - 1) / max_entries;
+  *new_size = JOURNAL_HEADER_SIZE + num_records * JOURNAL_RECORD_HEADER_SIZE +
+              num_keys * entry_size;
+  unsigned char *buffer = (unsigned char *)malloc(*new_size);  // NOLINT
+  if (!buffer) {
+    free(slots);
+    free(latest);
+    return NULL;
+  }
+  unsigned char *cursor = write_journal_header(buffer);
+  int first = 0;
+  while (first < num_keys) {
+    int count = num_keys - first;
+    if (count > max_entries) {
+      count = max_entries;
+    }
+    // the entries are gathered in place, and the header of the record is
+    // written once their checksum is known
+    unsigned char *data = cursor + JOURNAL_RECORD_HEADER_SIZE;
+    i = 0;
+    while (i < count) {
+      memcpy(data + i * entry_size, latest[first + i], entry_size);
+      i = i + 1;
+    }
+    const int rec_size = count * entry_size;
+    cursor = write_u16(cursor, rec_size);
+    cursor = write_i32(cursor, crc32c(data, rec_size));
+    cursor = cursor + rec_size;
+    first = first + count;
+  }
+  free(slots);
+  free(latest);
+  return buffer;
+}
+
+IoRequest *write_journal(const char path[], Journal *j,
+                         const JournalRecord recs[], const int num_records) {
+  logger.enter_fn(__func__);
+
+  int size = JOURNAL_HEADER_SIZE;
+  int i = 0;
+  while (i < num_records) {
+    size = size + JOURNAL_RECORD_HEADER_SIZE + recs[i].size;
+    i = i + 1;
+  }
+
+  unsigned char *buffer = (unsigned char *)malloc(size);  // NOLINT
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  unsigned char *cursor = write_journal_header(buffer);
+  i = 0;
+  while (i < num_records) {
+    cursor = write_journal_record(cursor, recs[i].data, recs[i].size);
+    i = i + 1;
+  }
+
+  IoRequest *req = submit_replace(path, buffer, size);
+  if (j) {
+    j->size = size;
+    j->end = size;
+    j->num_records = num_records;
+    j->num_corrupted = 0;
+  }
+
+  logger.log("compacting '%s' to %i records", path, num_records);
+  logger.exit_fn();
+  return req;
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/journal.h"
+#include "../inc/savefile.h"
+#include "../inc/string.h"
+#include "../inc/types/entries.h"
+#include "../inc/types/gamestates.h"
+
+#include "../inc/legacy.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Checks a username as the game stores it.
+ *
+ * The characters before the padding are the ones accepted by
+ * @c is_username_valid(), uppercased, and the padding is only made of
+ * @c FILLER_CHAR.
+ */
+static int is_stored_username_valid(const char username[]) {
+  if (username[MAX_USERNAME_LENGTH] != STR_END ||
+      username[0] == FILLER_CHAR[0]) {
+    return FALSE;
+  }
+  int is_padding = FALSE;
+  int i = 0;
+  while (i < MAX_USERNAME_LENGTH) {
+    const unsigned char ch = username[i];
+    is_padding = is_padding || ch == FILLER_CHAR[0];
+    if (is_padding ? ch != FILLER_CHAR[0]
+                   : ch == STR_END || ispunct(ch) || isdigit(ch) ||
+                         isspace(ch) || iscntrl(ch) || islower(ch)) {
+      return FALSE;
+    }
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Checks that no two players of a game have the same username.
+ */
+static int are_usernames_unique(const Players *pls) {
+  int i = 0;
+  while (i < pls->players_num) {
+    int j = i + 1;
+    while (j < pls->players_num) {
+      if (strcmp(pls->players[i].username, pls->players[j].username) == 0) {
+        return FALSE;
+      }
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+int check_legacy_game(const GameState *gs) {
+  if (!memchr(gs->game_name, STR_END, MAX_BUFFER_LEN)) {
+    return LEGACY_BAD_NAME;
+  }
+  const Players *pls = &gs->pls;
+  if (pls->players_num < MIN_NUM_PLAYERS ||
+      pls->players_num > MAX_NUM_PLAYERS) {
+    return LEGACY_BAD_PLAYERS;
+  }
+  const int dim = gs->board.dim;
+  if (dim < MIN_NUM_SQUARES || dim > MAX_NUM_SQUARES) {
+    return LEGACY_BAD_DIM;
+  }
+
+  int i = 0;
+  while (i < pls->players_num) {
+    const Player *pl = &pls->players[i];
+    if (!is_stored_username_valid(pl->username)) {
+      return LEGACY_BAD_USERNAME;
+    }
+    if (pl->position < INITIAL_POSITION || pl->position >= dim) {
+      return LEGACY_BAD_POSITION;
+    }
+    if (pl->score < INITIAL_SCORE) {
+      return LEGACY_BAD_SCORE;
+    }
+    if ((pl->turns_blocked < NO_TURNS_BLOCKED ||
+         pl->turns_blocked > TURNS_BLOCKED_BY_INN) &&
+        pl->turns_blocked != INDEF_BLOCK) {
+      return LEGACY_BAD_BLOCK;
+    }
+    i = i + 1;
+  }
+  if (!are_usernames_unique(pls)) {
+    return LEGACY_DUPLICATE_USERNAME;
+  }
+  return LEGACY_VALID;
+}
+
+int check_legacy_entry(const Entry *e) {
+  if (!is_stored_username_valid(e->name)) {
+    return LEGACY_BAD_USERNAME;
+  }
+  if (e->final_score < INITIAL_SCORE) {
+    return LEGACY_BAD_SCORE;
+  }
+  return LEGACY_VALID;
+}
+
+int open_legacy(LegacyFile *lf, const char path[]) {
+  lf->kind = LEGACY_NONE;
+  lf->count = 0;
+  lf->capacity = 0;
+  if (fopen_s(&lf->fp, path, "rb")) {
+    return FALSE;
+  }
+
+  char magic[SAVE_MAGIC_LEN];
+  fseek(lf->fp, 0L, SEEK_END);
+  const long size = ftell(lf->fp);
+  fseek(lf->fp, 0L, SEEK_SET);
+  const int has_magic =
+      fread(magic, 1, SAVE_MAGIC_LEN, lf->fp) == SAVE_MAGIC_LEN &&
+      (memcmp(magic, SAVE_MAGIC, SAVE_MAGIC_LEN) == 0 ||
+       memcmp(magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) == 0);
+
+  // the count is stored after the records
+  long count_offset = -1;
+  if (!has_magic && size == sizeof(GameStates)) {
+    lf->kind = LEGACY_SAVES;
+    lf->capacity = MAX_SAVED_GAMES;
+    count_offset = offsetof(GameStates, num_games);
+  } else if (!has_magic && size == sizeof(Entries)) {
+    lf->kind = LEGACY_LEADERBOARD;
+    lf->capacity = MAX_ENTRIES;
+    count_offset = offsetof(Entries, num_entries);
+  }
+  if (lf->kind != LEGACY_NONE) {
+    fseek(lf->fp, count_offset, SEEK_SET);
+    if (fread(&lf->count, sizeof(lf->count), 1, lf->fp) != 1) {
+      lf->count = -1;
+    }
+  }
+  fseek(lf->fp, 0L, SEEK_SET);
+  return TRUE;
+}
+
+int is_legacy_count_valid(const LegacyFile *lf) {
+  return lf->count >= 0 && lf->count <= lf->capacity;
+}
+
+int next_legacy_game(LegacyFile *lf, GameState *gs) {
+  if (fread(gs, sizeof(*gs), 1, lf->fp) != 1) {
+    return LEGACY_TRUNCATED;
+  }
+  return check_legacy_game(gs);
+}
+
+int next_legacy_entry(LegacyFile *lf, Entry *e) {
+  if (fread(e, sizeof(*e), 1, lf->fp) != 1) {
+    return LEGACY_TRUNCATED;
+  }
+  return check_legacy_entry(e);
+}
+
+void close_legacy(LegacyFile *lf) { fclose(lf->fp); }
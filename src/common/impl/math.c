@@ -6,21 +6,35 @@
 //    Fidanza Simone
 //    Lecini Fabio
 
-#include <stdlib.h>
+#include "../inc/rng.h"
 
 #include "../inc/math.h"
 
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
+/**
+ * @brief The generator of the dice.
+ */
+static Rng dice = RNG_INITIALIZER;
+
 int proportion(const int numerator, const int known_value,
                const int denominator) {
   return (numerator * known_value) / denominator;
 }
 
 int roll_dice() {
-  return (rand() % MAX_DICE_THROW + MIN_DICE_THROW) +  // NOLINT
-         (rand() % MAX_DICE_THROW + MIN_DICE_THROW);   // NOLINT
+  const int first = next_rng_below(&dice, MAX_DICE_THROW) + MIN_DICE_THROW;
+  return first + next_rng_below(&dice, MAX_DICE_THROW) + MIN_DICE_THROW;
+}
+
+void seed_dice(const unsigned long long seed) {
+  seed_rng(&dice, seed, DICE_STREAM);
+}
+
+unsigned long long new_dice_seed(void) {
+  const unsigned long long high = next_rng(&dice);
+  return high << 32 | next_rng(&dice);
 }
 
 void swap_int(int *n, int *m) {
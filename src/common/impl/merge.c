@@ -0,0 +1,182 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/nameindex.h"
+#include "../inc/ranktree.h"
+#include "../inc/types/entry.h"
+
+#include "../inc/merge.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Reads the next entries of a shard once its buffer has been merged,
+ *        and updates the order of its first entry.
+ */
+static void fill_run(Merge *m, const int i) {
+  MergeRun *run = &m->runs[i];
+  if (run->next == run->count) {
+    run->count = get_tree_entries(run->tree, run->read, MERGE_BUFFER_ENTRIES,
+                                  run->buffer);
+    run->next = 0;
+    run->read = run->read + run->count;
+  }
+  if (run->count == 0) {
+    m->heads[i] = MERGE_DONE;
+    return;
+  }
+  m->heads[i] = rank_key(&run->buffer[run->next]);
+}
+
+/**
+ * @brief Checks whether the first entry of a shard comes before the first
+ *        entry of another one.
+ *
+ * Two shards with the same order hold the same entry, so either can go first.
+ */
+static int is_run_before(const Merge *m, const int a, const int b) {
+  return m->heads[a] < m->heads[b];
+}
+
+/**
+ * @brief Plays the matches of a subtree of the loser tree, keeping the loser
+ *        of each one in its node.
+ *
+ * @return The shard winning the subtree.
+ */
+static int play_subtree(Merge *m, const int node) {
+  if (node >= m->num_runs) {
+    return node - m->num_runs;
+  }
+  const int left = play_subtree(m, 2 * node);
+  const int right = play_subtree(m, 2 * node + 1);
+  if (is_run_before(m, left, right)) {
+    m->losers[node] = right;
+    return left;
+  }
+  m->losers[node] = left;
+  return right;
+}
+
+/**
+ * @brief Plays again the matches on the path from a shard to the root, once
+ *        its first entry has changed.
+ */
+static void replay_run(Merge *m, const int run) {
+  // the outcome of a match can not be guessed, so both sides are picked
+  // without branching, which compilers turn into conditional moves
+  int winner = run;
+  unsigned long long head = m->heads[run];
+  int node = (run + m->num_runs) / 2;
+  while (node > 0) {
+    const int loser = m->losers[node];
+    const unsigned long long loser_head = m->heads[loser];
+    const int is_loser_first = loser_head < head;
+    m->losers[node] = is_loser_first ? winner : loser;
+    winner = is_loser_first ? loser : winner;
+    head = is_loser_first ? loser_head : head;
+    node = node / 2;
+  }
+  m->losers[0] = winner;
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+unsigned long long rank_key(const Entry *e) {
+  // flipping the sign bit of a score orders it as an unsigned number, and
+  // flipping every bit puts the highest score first, while packed names are
+  // ordered as their bytes
+  const unsigned score = ~((unsigned)get_final_score(e) ^ 0x80000000u);
+  return ((unsigned long long)score << 32) | pack_name(get_name(e));
+}
+
+Merge *start_merge(RankTree *const shards[], const int num_shards) {
+  logger.enter_fn(__func__);
+
+  if (num_shards < 1) {
+    logger.log("can not merge %i shards", num_shards);
+    logger.stop();
+    throw_err(VALUE_OUT_OF_BOUND_ERROR);
+  }
+  Merge *m = (Merge *)malloc(sizeof(Merge));  // NOLINT
+  if (!m) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  m->runs = (MergeRun *)malloc(  // NOLINT
+      num_shards * sizeof(MergeRun));
+  m->heads = (unsigned long long *)malloc(  // NOLINT
+      num_shards * sizeof(unsigned long long));
+  m->losers = (int *)malloc(num_shards * sizeof(int));  // NOLINT
+  m->merged = (unsigned char *)calloc(  // NOLINT
+      MERGE_NUM_NAMES / 8, 1);
+  if (!m->runs || !m->heads || !m->losers || !m->merged) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  m->num_runs = num_shards;
+  m->num_read = 0;
+
+  int total = 0;
+  int i = 0;
+  while (i < num_shards) {
+    m->runs[i].tree = shards[i];
+    m->runs[i].next = 0;
+    m->runs[i].count = 0;
+    m->runs[i].read = 0;
+    fill_run(m, i);
+    total = total + get_tree_size(shards[i]);
+    i = i + 1;
+  }
+  m->losers[0] = play_subtree(m, 1);
+  logger.log("merging %i shards, %i entries", num_shards, total);
+
+  logger.exit_fn();
+  return m;
+}
+
+int next_merged(Merge *m, Entry *e) {
+  int is_taken = FALSE;
+  while (!is_taken && m->heads[m->losers[0]] != MERGE_DONE) {
+    const int winner = m->losers[0];
+    MergeRun *run = &m->runs[winner];
+    *e = run->buffer[run->next];
+    const unsigned key = (unsigned)m->heads[winner];
+    run->next = run->next + 1;
+    m->num_read = m->num_read + 1;
+    fill_run(m, winner);
+    replay_run(m, winner);
+
+    // the first entry of a player has their best score, the others are dropped
+    const unsigned char bit = 1 << (key % 8);
+    if (!(m->merged[key / 8] & bit)) {
+      m->merged[key / 8] = m->merged[key / 8] | bit;
+      is_taken = TRUE;
+    }
+  }
+  return is_taken;
+}
+
+void end_merge(Merge *m) {
+  if (!m) {
+    return;
+  }
+  free(m->runs);
+  free(m->heads);
+  free(m->losers);
+  free(m->merged);
+  free(m);
+}
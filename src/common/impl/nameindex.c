@@ -0,0 +1,148 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/string.h"
+#include "../inc/types/player.h"
+
+#include "../inc/nameindex.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Finds the slot of a key, or the empty slot where it would go.
+ *
+ * Keys are spread over the table by Fibonacci hashing, which takes the top
+ * bits of the key multiplied by 2^32 divided by the golden ratio.
+ */
+static int find_slot(const NameSlot slots[], const int bits,
+                     const unsigned key) {
+  const unsigned mask = (1u << bits) - 1;
+  unsigned slot = (key * 2654435769u) >> (32 - bits);
+  while (slots[slot].key != NAME_INDEX_EMPTY && slots[slot].key != key) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+static NameSlot *alloc_slots(const int capacity) {
+  NameSlot *slots = (NameSlot *)malloc(  // NOLINT
+      capacity * sizeof(NameSlot));
+  if (!slots) {
+    return NULL;
+  }
+  int i = 0;
+  while (i < capacity) {
+    slots[i].key = NAME_INDEX_EMPTY;
+    i = i + 1;
+  }
+  return slots;
+}
+
+/**
+ * @brief Doubles the number of slots, moving every name to its new slot.
+ */
+static void grow_name_index(NameIndex *ix) {
+  logger.enter_fn(__func__);
+
+  const int bits = ix->bits + 1;
+  const int capacity = 1 << bits;
+  NameSlot *slots = alloc_slots(capacity);
+  if (!slots) {
+    logger.log("can not grow to %i slots", capacity);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < ix->capacity) {
+    if (ix->slots[i].key != NAME_INDEX_EMPTY) {
+      slots[find_slot(slots, bits, ix->slots[i].key)] = ix->slots[i];
+    }
+    i = i + 1;
+  }
+  free(ix->slots);
+  ix->slots = slots;
+  ix->capacity = capacity;
+  ix->bits = bits;
+  logger.log("grown to %i slots", capacity);
+
+  logger.exit_fn();
+}
+
+unsigned pack_name(const char name[]) {
+  unsigned key = 0;
+  int i = 0;
+  int is_end = FALSE;
+  while (i < MAX_USERNAME_LENGTH) {
+    is_end = is_end || name[i] == STR_END;
+    key = (key << 8) | (is_end ? 0 : (unsigned char)name[i]);
+    i = i + 1;
+  }
+  return key;
+}
+
+NameIndex *new_name_index(void) {
+  logger.enter_fn(__func__);
+
+  NameIndex *ix = (NameIndex *)malloc(sizeof(NameIndex));  // NOLINT
+  if (!ix) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  ix->slots = alloc_slots(NAME_INDEX_INITIAL_CAPACITY);
+  if (!ix->slots) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  ix->capacity = NAME_INDEX_INITIAL_CAPACITY;
+  ix->bits = 0;
+  while ((1 << ix->bits) < ix->capacity) {
+    ix->bits = ix->bits + 1;
+  }
+  ix->num_names = 0;
+
+  logger.exit_fn();
+  return ix;
+}
+
+void free_name_index(NameIndex *ix) {
+  if (!ix) {
+    return;
+  }
+  free(ix->slots);
+  free(ix);
+}
+
+int find_name(const NameIndex *ix, const unsigned key, int *value) {
+  const NameSlot *slot = &ix->slots[find_slot(ix->slots, ix->bits, key)];
+  if (slot->key == NAME_INDEX_EMPTY) {
+    return FALSE;
+  }
+  *value = slot->value;
+  return TRUE;
+}
+
+void put_name(NameIndex *ix, const unsigned key, const int value) {
+  NameSlot *slot = &ix->slots[find_slot(ix->slots, ix->bits, key)];
+  if (slot->key == NAME_INDEX_EMPTY) {
+    // the table is kept at most half full, so that probes stay short
+    if (2 * (ix->num_names + 1) > ix->capacity) {
+      grow_name_index(ix);
+      slot = &ix->slots[find_slot(ix->slots, ix->bits, key)];
+    }
+    slot->key = key;
+    ix->num_names = ix->num_names + 1;
+  }
+  slot->value = value;
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/bytes.h"
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/nameindex.h"
+
+#include "../inc/playerstats.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Gives a column the number of slots of the table, keeping its values.
+ *
+ * @return @c FALSE if the column can not grow, @c TRUE otherwise.
+ */
+static int grow_column(int **column, const int capacity) {
+  int *grown = (int *)realloc(*column, capacity * sizeof(int));  // NOLINT
+  if (!grown) {
+    return FALSE;
+  }
+  *column = grown;
+  return TRUE;
+}
+
+/**
+ * @brief Doubles the number of slots of the table.
+ */
+static void grow_player_stats(PlayerStats *s) {
+  logger.enter_fn(__func__);
+
+  const int capacity = 2 * s->capacity;
+  unsigned *keys = (unsigned *)realloc(  // NOLINT
+      s->keys, capacity * sizeof(unsigned));
+  if (keys) {
+    s->keys = keys;
+  }
+  int is_grown = keys != NULL;
+  is_grown = grow_column(&s->games, capacity) && is_grown;
+  is_grown = grow_column(&s->wins, capacity) && is_grown;
+  is_grown = grow_column(&s->turns, capacity) && is_grown;
+  int i = 0;
+  while (i < STATS_NUM_SQUARES) {
+    is_grown = grow_column(&s->landings[i], capacity) && is_grown;
+    i = i + 1;
+  }
+  if (!is_grown) {
+    logger.log("can not grow to %i players", capacity);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  s->capacity = capacity;
+  logger.log("grown to %i players", capacity);
+
+  logger.exit_fn();
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+void clear_game_tally(GameTally *t) { t->num_players = 0; }
+
+StatsRow *tally_player(GameTally *t, const unsigned key) {
+  int i = 0;
+  while (i < t->num_players && t->keys[i] != key) {
+    i = i + 1;
+  }
+  if (i == t->num_players) {
+    if (t->num_players == MAX_NUM_PLAYERS) {
+      logger.log("tally already has %i players", MAX_NUM_PLAYERS);
+      logger.stop();
+      throw_err(VALUE_OUT_OF_BOUND_ERROR);
+    }
+    t->keys[i] = key;
+    memset(&t->rows[i], 0, sizeof(StatsRow));
+    t->num_players = t->num_players + 1;
+  }
+  return &t->rows[i];
+}
+
+void tally_landing(StatsRow *row, const int square) {
+  if (square <= GOOSE_VALUE && square >= SKELETON_VALUE) {
+    row->landings[GOOSE_VALUE - square] =
+        row->landings[GOOSE_VALUE - square] + 1;
+  }
+}
+
+PlayerStats *new_player_stats(void) {
+  logger.enter_fn(__func__);
+
+  PlayerStats *s = (PlayerStats *)malloc(sizeof(PlayerStats));  // NOLINT
+  if (!s) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  s->index = new_name_index();
+  s->capacity = STATS_INITIAL_CAPACITY;
+  s->num_players = 0;
+  s->keys = (unsigned *)malloc(s->capacity * sizeof(unsigned));  // NOLINT
+  s->games = NULL;
+  s->wins = NULL;
+  s->turns = NULL;
+  int is_allocated = s->keys != NULL;
+  is_allocated = grow_column(&s->games, s->capacity) && is_allocated;
+  is_allocated = grow_column(&s->wins, s->capacity) && is_allocated;
+  is_allocated = grow_column(&s->turns, s->capacity) && is_allocated;
+  int i = 0;
+  while (i < STATS_NUM_SQUARES) {
+    s->landings[i] = NULL;
+    is_allocated = grow_column(&s->landings[i], s->capacity) && is_allocated;
+    i = i + 1;
+  }
+  if (!is_allocated) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  logger.exit_fn();
+  return s;
+}
+
+void free_player_stats(PlayerStats *s) {
+  if (!s) {
+    return;
+  }
+  free_name_index(s->index);
+  free(s->keys);
+  free(s->games);
+  free(s->wins);
+  free(s->turns);
+  int i = 0;
+  while (i < STATS_NUM_SQUARES) {
+    free(s->landings[i]);
+    i = i + 1;
+  }
+  free(s);
+}
+
+int add_stats_player(PlayerStats *s, const unsigned key) {
+  int slot;
+  if (find_name(s->index, key, &slot)) {
+    return slot;
+  }
+  if (s->num_players == s->capacity) {
+    grow_player_stats(s);
+  }
+  slot = s->num_players;
+  s->keys[slot] = key;
+  s->games[slot] = 0;
+  s->wins[slot] = 0;
+  s->turns[slot] = 0;
+  int i = 0;
+  while (i < STATS_NUM_SQUARES) {
+    s->landings[i][slot] = 0;
+    i = i + 1;
+  }
+  s->num_players = s->num_players + 1;
+  put_name(s->index, key, slot);
+  return slot;
+}
+
+void add_game_tally(PlayerStats *s, const GameTally *t, int slots[]) {
+  int i = 0;
+  while (i < t->num_players) {
+    const StatsRow *row = &t->rows[i];
+    const int slot = add_stats_player(s, t->keys[i]);
+    s->games[slot] = s->games[slot] + row->games;
+    s->wins[slot] = s->wins[slot] + row->wins;
+    s->turns[slot] = s->turns[slot] + row->turns;
+    int j = 0;
+    while (j < STATS_NUM_SQUARES) {
+      s->landings[j][slot] = s->landings[j][slot] + row->landings[j];
+      j = j + 1;
+    }
+    slots[i] = slot;
+    i = i + 1;
+  }
+}
+
+int get_stats_row(const PlayerStats *s, const unsigned key, StatsRow *row) {
+  int slot;
+  if (!find_name(s->index, key, &slot)) {
+    return FALSE;
+  }
+  row->games = s->games[slot];
+  row->wins = s->wins[slot];
+  row->turns = s->turns[slot];
+  int i = 0;
+  while (i < STATS_NUM_SQUARES) {
+    row->landings[i] = s->landings[i][slot];
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+long long sum_stats_column(const int column[], const int num_players) {
+  long long sum = 0;
+  int i = 0;
+  while (i < num_players) {
+    sum = sum + column[i];
+    i = i + 1;
+  }
+  return sum;
+}
+
+unsigned char *encode_player_stats(unsigned char *cursor, const PlayerStats *s,
+                                   const int slots[], const int count) {
+  int i = 0;
+  while (i < count) {
+    const int slot = slots[i];
+    cursor = write_i32(cursor, s->keys[slot]);
+    cursor = write_i32(cursor, s->games[slot]);
+    cursor = write_i32(cursor, s->wins[slot]);
+    cursor = write_i32(cursor, s->turns[slot]);
+    int j = 0;
+    while (j < STATS_NUM_SQUARES) {
+      cursor = write_i32(cursor, s->landings[j][slot]);
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+  return cursor;
+}
+
+int are_player_stats_valid(const unsigned char data[], const int size) {
+  if (size % STATS_ENTRY_SIZE != 0) {
+    return FALSE;
+  }
+  // a packed name takes no more than MAX_USERNAME_LENGTH bytes, and no
+  // statistic is negative
+  int i = 0;
+  while (i < size) {
+    const unsigned key = (unsigned)read_i32(data + i);
+    if (key >> (8 * MAX_USERNAME_LENGTH) != 0) {
+      return FALSE;
+    }
+    int j = 4;
+    while (j < STATS_ENTRY_SIZE) {
+      if (read_i32(data + i + j) < 0) {
+        return FALSE;
+      }
+      j = j + 4;
+    }
+    i = i + STATS_ENTRY_SIZE;
+  }
+  return TRUE;
+}
+
+int decode_player_stats(const unsigned char data[], const int size,
+                        PlayerStats *s) {
+  if (!are_player_stats_valid(data, size)) {
+    return FALSE;
+  }
+  int i = 0;
+  while (i < size) {
+    const unsigned char *cursor = data + i;
+    const int slot = add_stats_player(s, (unsigned)read_i32(cursor));
+    s->games[slot] = read_i32(cursor + 4);
+    s->wins[slot] = read_i32(cursor + 8);
+    s->turns[slot] = read_i32(cursor + 12);
+    cursor = cursor + 16;
+    int j = 0;
+    while (j < STATS_NUM_SQUARES) {
+      s->landings[j][slot] = read_i32(cursor);
+      cursor = cursor + 4;
+      j = j + 1;
+    }
+    i = i + STATS_ENTRY_SIZE;
+  }
+  return TRUE;
+}
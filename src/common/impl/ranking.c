@@ -0,0 +1,336 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/nameindex.h"
+
+#include "../inc/ranking.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Gets the links of a node inside the tree ordered by rank.
+ */
+static RankLinks *links_of(const Ranking *r, const int node) {
+  return &r->nodes[node].by_rank;
+}
+
+static int height_of(const Ranking *r, const int node) {
+  return node == RANK_NO_NODE ? 0 : links_of(r, node)->height;
+}
+
+static int size_of(const Ranking *r, const int node) {
+  return node == RANK_NO_NODE ? 0 : links_of(r, node)->size;
+}
+
+/**
+ * @brief Recomputes the height and the size of a subtree from its children.
+ */
+static void update_node(const Ranking *r, const int node) {
+  RankLinks *l = links_of(r, node);
+  const int left = height_of(r, l->left);
+  const int right = height_of(r, l->right);
+  l->height = 1 + (left > right ? left : right);
+  l->size = 1 + size_of(r, l->left) + size_of(r, l->right);
+}
+
+/**
+ * @brief Checks whether a node comes before another one.
+ *
+ * Higher scores come first and ties are broken by name.
+ */
+static int is_before(const Ranking *r, const int first, const int second) {
+  const Entry *a = &r->nodes[first].entry;
+  const Entry *b = &r->nodes[second].entry;
+  if (get_final_score(a) != get_final_score(b)) {
+    return get_final_score(a) > get_final_score(b);
+  }
+  return strcmp(get_name(a), get_name(b)) < 0;
+}
+
+static int rotate_right(const Ranking *r, const int node) {
+  RankLinks *l = links_of(r, node);
+  const int pivot = l->left;
+  RankLinks *p = links_of(r, pivot);
+  l->left = p->right;
+  p->right = node;
+  update_node(r, node);
+  update_node(r, pivot);
+  return pivot;
+}
+
+static int rotate_left(const Ranking *r, const int node) {
+  RankLinks *l = links_of(r, node);
+  const int pivot = l->right;
+  RankLinks *p = links_of(r, pivot);
+  l->right = p->left;
+  p->left = node;
+  update_node(r, node);
+  update_node(r, pivot);
+  return pivot;
+}
+
+/**
+ * @brief Restores the balance of a subtree whose children differ in height by
+ *        at most two.
+ *
+ * @return The new root of the subtree.
+ */
+static int balance_node(const Ranking *r, const int node) {
+  update_node(r, node);
+  RankLinks *l = links_of(r, node);
+  const int factor = height_of(r, l->left) - height_of(r, l->right);
+  if (factor > 1) {
+    const RankLinks *left = links_of(r, l->left);
+    if (height_of(r, left->left) < height_of(r, left->right)) {
+      l->left = rotate_left(r, l->left);
+    }
+    return rotate_right(r, node);
+  }
+  if (factor < -1) {
+    const RankLinks *right = links_of(r, l->right);
+    if (height_of(r, right->right) < height_of(r, right->left)) {
+      l->right = rotate_right(r, l->right);
+    }
+    return rotate_left(r, node);
+  }
+  return node;
+}
+
+/**
+ * @brief Inserts a node inside a subtree.
+ *
+ * @return The new root of the subtree.
+ */
+static int insert_node(const Ranking *r, const int root, const int node) {
+  if (root == RANK_NO_NODE) {
+    RankLinks *l = links_of(r, node);
+    l->left = RANK_NO_NODE;
+    l->right = RANK_NO_NODE;
+    l->height = 1;
+    l->size = 1;
+    return node;
+  }
+  RankLinks *l = links_of(r, root);
+  if (is_before(r, node, root)) {
+    l->left = insert_node(r, l->left, node);
+  } else {
+    l->right = insert_node(r, l->right, node);
+  }
+  return balance_node(r, root);
+}
+
+/**
+ * @brief Detaches the first node of a subtree.
+ *
+ * @return The new root of the subtree.
+ */
+static int remove_first(const Ranking *r, const int root, int *first) {
+  RankLinks *l = links_of(r, root);
+  if (l->left == RANK_NO_NODE) {
+    *first = root;
+    return l->right;
+  }
+  l->left = remove_first(r, l->left, first);
+  return balance_node(r, root);
+}
+
+/**
+ * @brief Detaches a node from a subtree holding it.
+ *
+ * The node is found by its current key, so its entry must not have changed
+ * since it was inserted.
+ *
+ * @return The new root of the subtree.
+ */
+static int remove_node(const Ranking *r, const int root, const int node) {
+  RankLinks *l = links_of(r, root);
+  if (root == node) {
+    if (l->left == RANK_NO_NODE) {
+      return l->right;
+    }
+    if (l->right == RANK_NO_NODE) {
+      return l->left;
+    }
+    // the node is replaced by the first node after it
+    int next;
+    const int right = remove_first(r, l->right, &next);
+    RankLinks *n = links_of(r, next);
+    n->left = l->left;
+    n->right = right;
+    return balance_node(r, next);
+  }
+  if (is_before(r, node, root)) {
+    l->left = remove_node(r, l->left, node);
+  } else {
+    l->right = remove_node(r, l->right, node);
+  }
+  return balance_node(r, root);
+}
+
+/**
+ * @brief Finds the node of a player through the index of the names.
+ */
+static int find_node(const Ranking *r, const char name[]) {
+  int node;
+  if (!find_name(r->names, pack_name(name), &node)) {
+    return RANK_NO_NODE;
+  }
+  return node;
+}
+
+/**
+ * @brief Doubles the number of nodes allocated.
+ */
+static void grow_ranking(Ranking *r) {
+  logger.enter_fn(__func__);
+
+  const int capacity = 2 * r->capacity;
+  RankNode *nodes = (RankNode *)realloc(  // NOLINT
+      r->nodes, capacity * sizeof(RankNode));
+  if (!nodes) {
+    logger.log("can not grow to %i entries", capacity);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  r->nodes = nodes;
+  r->capacity = capacity;
+  logger.log("grown to %i entries", capacity);
+
+  logger.exit_fn();
+}
+
+Ranking *new_ranking(void) {
+  logger.enter_fn(__func__);
+
+  Ranking *r = (Ranking *)malloc(sizeof(Ranking));  // NOLINT
+  if (!r) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  r->nodes = (RankNode *)malloc(  // NOLINT
+      RANKING_INITIAL_CAPACITY * sizeof(RankNode));
+  if (!r->nodes) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  r->num_entries = 0;
+  r->capacity = RANKING_INITIAL_CAPACITY;
+  r->rank_root = RANK_NO_NODE;
+  r->names = new_name_index();
+
+  logger.exit_fn();
+  return r;
+}
+
+void free_ranking(Ranking *r) {
+  if (!r) {
+    return;
+  }
+  free(r->nodes);
+  free_name_index(r->names);
+  free(r);
+}
+
+int upsert_ranking(Ranking *r, const Entry *e) {
+  const int found = find_node(r, get_name(e));
+  if (found != RANK_NO_NODE) {
+    Entry *ranked = &r->nodes[found].entry;
+    if (get_final_score(ranked) >= get_final_score(e)) {
+      return FALSE;
+    }
+    // the entry moves inside the tree ordered by rank, its name stays the same
+    r->rank_root = remove_node(r, r->rank_root, found);
+    set_final_score(ranked, get_final_score(e));
+    r->rank_root = insert_node(r, r->rank_root, found);
+    return TRUE;
+  }
+
+  if (r->num_entries == r->capacity) {
+    grow_ranking(r);
+  }
+  const int node = r->num_entries;
+  r->nodes[node].entry = *e;
+  r->num_entries = r->num_entries + 1;
+  r->rank_root = insert_node(r, r->rank_root, node);
+  put_name(r->names, pack_name(get_name(e)), node);
+  return TRUE;
+}
+
+int get_num_ranked(const Ranking *r) { return r->num_entries; }
+
+int find_ranked(const Ranking *r, const char name[], Entry *e) {
+  const int node = find_node(r, name);
+  if (node == RANK_NO_NODE) {
+    return FALSE;
+  }
+  *e = r->nodes[node].entry;
+  return TRUE;
+}
+
+int get_rank(const Ranking *r, const char name[]) {
+  const int found = find_node(r, name);
+  if (found == RANK_NO_NODE) {
+    return INDEX_NOT_FOUND;
+  }
+
+  // counts the entries with a higher score on the way down to the first entry
+  // with the same score
+  const int score = get_final_score(&r->nodes[found].entry);
+  int num_higher = 0;
+  int node = r->rank_root;
+  while (node != RANK_NO_NODE) {
+    const RankLinks *l = &r->nodes[node].by_rank;
+    if (get_final_score(&r->nodes[node].entry) > score) {
+      num_higher = num_higher + size_of(r, l->left) + 1;
+      node = l->right;
+    } else {
+      node = l->left;
+    }
+  }
+  return num_higher + 1;
+}
+
+/**
+ * @brief Copies the entries of a subtree in order of rank, skipping the
+ *        subtrees that end before the first entry wanted.
+ */
+static void collect_entries(const Ranking *r, const int node, int *skip,
+                            const int count, Entry entries[], int *copied) {
+  if (node == RANK_NO_NODE || *copied == count) {
+    return;
+  }
+  const RankLinks *l = &r->nodes[node].by_rank;
+  if (*skip >= l->size) {
+    *skip = *skip - l->size;
+    return;
+  }
+  collect_entries(r, l->left, skip, count, entries, copied);
+  if (*skip > 0) {
+    *skip = *skip - 1;
+  } else if (*copied < count) {
+    entries[*copied] = r->nodes[node].entry;
+    *copied = *copied + 1;
+  }
+  collect_entries(r, l->right, skip, count, entries, copied);
+}
+
+int get_ranked_entries(const Ranking *r, const int first, const int count,
+                       Entry entries[]) {
+  int skip = first;
+  int copied = 0;
+  collect_entries(r, r->rank_root, &skip, count, entries, &copied);
+  return copied;
+}
@@ -0,0 +1,1336 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/bytes.h"
+#include "../inc/crc.h"
+#include "../inc/error.h"
+#include "../inc/iopool.h"
+#include "../inc/logger.h"
+#include "../inc/nameindex.h"
+#include "../inc/string.h"
+
+#include "../inc/ranktree.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/*
+ * every page ends with the crc32c of the bytes before it.
+ *
+ * A meta page holds, after the magic bytes:
+ *
+ *   offset  size  field
+ *   4       2     version
+ *   6       2     reserved
+ *   8       4     generation
+ *   12      4     root of the tree ordered by rank
+ *   16      4     root of the tree ordered by name
+ *   20      4     number of entries
+ *   24      4     number of pages
+ *   28      4     number of pages no longer used
+ *
+ * A node starts with its kind and its number of items, followed by the items.
+ * The items of a leaf are records, the name of the player padded to
+ * MAX_USERNAME_LENGTH followed by the score. The items of an inner node are
+ * its children: the page of the child, the number of records below it and the
+ * smallest record below it when the child was added. The first child is taken
+ * for any record before the second one, so its record is never compared.
+ */
+
+#define PAGE_CRC_OFFSET (RANK_TREE_PAGE_SIZE - 4)
+
+#define META_PAGES 2
+#define META_VERSION 4
+#define META_GENERATION 8
+#define META_RANK_ROOT 12
+#define META_NAME_ROOT 16
+#define META_NUM_ENTRIES 20
+#define META_NUM_PAGES 24
+#define META_NUM_DEAD 28
+
+#define NODE_HEADER_SIZE 4
+#define LEAF_NODE 0
+#define INNER_NODE 1
+
+#define RECORD_SIZE (MAX_USERNAME_LENGTH + 4)
+#define CHILD_SIZE (8 + RECORD_SIZE)
+#define LEAF_CAPACITY ((PAGE_CRC_OFFSET - NODE_HEADER_SIZE) / RECORD_SIZE)
+#define INNER_CAPACITY ((PAGE_CRC_OFFSET - NODE_HEADER_SIZE) / CHILD_SIZE)
+
+/**
+ * @brief How many items the nodes of a file laid out from scratch hold, so that
+ *        the first updates do not split them.
+ */
+#define LEAF_FILL (3 * LEAF_CAPACITY / 4)
+#define INNER_FILL (3 * INNER_CAPACITY / 4)
+
+/**
+ * @brief The maximum number of inner nodes on the way down to a leaf, far more
+ *        than a file of @c INT_MAX bytes can hold.
+ */
+#define MAX_DEPTH 16
+
+/**
+ * @brief The number of pages allocated in memory for the first update since
+ *        the file was mapped.
+ */
+#define FRESH_INITIAL_PAGES 8
+
+/**
+ * @brief The page of a missing node.
+ */
+#define NO_PAGE -1
+
+/**
+ * @brief The tree ordered by rank.
+ */
+#define RANK_ORDER 0
+
+/**
+ * @brief The tree ordered by name.
+ */
+#define NAME_ORDER 1
+
+/**
+ * @brief The right half of a node split in two.
+ */
+typedef struct TreeSplit {
+  int page;                        ///< The page of the half, or NO_PAGE.
+  int size;                        ///< The number of records below it.
+  unsigned char key[RECORD_SIZE];  ///< The smallest record below it.
+} TreeSplit;
+
+static void encode_record(unsigned char rec[], const Entry *e) {
+  // names are always padded to their maximum length
+  memset(rec, STR_END, MAX_USERNAME_LENGTH);
+  memcpy(rec, get_name(e), strlen(get_name(e)));
+  write_i32(rec + MAX_USERNAME_LENGTH, get_final_score(e));
+}
+
+static void decode_record(const unsigned char rec[], Entry *e) {
+  char name[MAX_USERNAME_LENGTH + 1];
+  memcpy(name, rec, MAX_USERNAME_LENGTH);
+  name[MAX_USERNAME_LENGTH] = STR_END;
+  set_name(e, name);
+  set_final_score(e, read_i32(rec + MAX_USERNAME_LENGTH));
+}
+
+/**
+ * @brief Encodes the name of a player as a record, which is enough to find it
+ *        inside the tree ordered by name.
+ */
+static void encode_name(unsigned char rec[], const char name[]) {
+  int len = strlen(name);
+  if (len > MAX_USERNAME_LENGTH) {
+    len = MAX_USERNAME_LENGTH;
+  }
+  memset(rec, STR_END, RECORD_SIZE);
+  memcpy(rec, name, len);
+}
+
+/**
+ * @brief Compares two records inside one of the trees.
+ *
+ * By rank, higher scores come first and ties are broken by name.
+ */
+static int compare_records(const int order, const unsigned char a[],
+                           const unsigned char b[]) {
+  if (order == RANK_ORDER) {
+    const int score_a = read_i32(a + MAX_USERNAME_LENGTH);
+    const int score_b = read_i32(b + MAX_USERNAME_LENGTH);
+    if (score_a != score_b) {
+      return score_a > score_b ? -1 : 1;
+    }
+  }
+  return memcmp(a, b, MAX_USERNAME_LENGTH);
+}
+
+/**
+ * @brief Sorts entries by name, one byte of their packed names at a time from
+ *        the last one, each pass keeping the order of the previous one.
+ *
+ * It takes linear time, which matters for the millions of entries of a merged
+ * leaderboard (see merge.h).
+ *
+ * @return Either @e entries or @e tmp, whichever holds the sorted entries.
+ */
+static Entry *sort_by_name(Entry entries[], Entry tmp[],
+                           const int num_entries) {
+  Entry *from = entries;
+  Entry *to = tmp;
+  int byte = 0;
+  while (byte < MAX_USERNAME_LENGTH) {
+    int starts[256];
+    memset(starts, 0, sizeof(starts));
+    int i = 0;
+    while (i < num_entries) {
+      const int digit = (pack_name(get_name(&from[i])) >> (8 * byte)) & 0xFF;
+      starts[digit] = starts[digit] + 1;
+      i = i + 1;
+    }
+    int start = 0;
+    i = 0;
+    while (i < 256) {
+      const int count = starts[i];
+      starts[i] = start;
+      start = start + count;
+      i = i + 1;
+    }
+    i = 0;
+    while (i < num_entries) {
+      const int digit = (pack_name(get_name(&from[i])) >> (8 * byte)) & 0xFF;
+      to[starts[digit]] = from[i];
+      starts[digit] = starts[digit] + 1;
+      i = i + 1;
+    }
+    Entry *sorted = to;
+    to = from;
+    from = sorted;
+    byte = byte + 1;
+  }
+  return from;
+}
+
+static int node_kind(const unsigned char *node) { return node[0]; }
+
+static int node_count(const unsigned char *node) {
+  return read_u16(node + 2);
+}
+
+static void set_node_header(unsigned char *node, const int kind,
+                            const int count) {
+  node[0] = (unsigned char)kind;
+  node[1] = 0;
+  write_u16(node + 2, count);
+}
+
+static int item_size_of(const int kind) {
+  return kind == LEAF_NODE ? RECORD_SIZE : CHILD_SIZE;
+}
+
+static int item_offset(const int kind, const int i) {
+  return NODE_HEADER_SIZE + i * item_size_of(kind);
+}
+
+/**
+ * @brief Gets the offset of the record of an item, its smallest record for a
+ *        child.
+ */
+static int key_offset(const int kind, const int i) {
+  return item_offset(kind, i) + (kind == LEAF_NODE ? 0 : 8);
+}
+
+static int child_page(const unsigned char *node, const int i) {
+  return read_i32(node + item_offset(INNER_NODE, i));
+}
+
+static int child_size(const unsigned char *node, const int i) {
+  return read_i32(node + item_offset(INNER_NODE, i) + 4);
+}
+
+/**
+ * @brief Gets the number of records below a node.
+ */
+static int subtree_size(const unsigned char *node) {
+  if (node_kind(node) == LEAF_NODE) {
+    return node_count(node);
+  }
+  int size = 0;
+  int i = 0;
+  while (i < node_count(node)) {
+    size = size + child_size(node, i);
+    i = i + 1;
+  }
+  return size;
+}
+
+static void seal_page(unsigned char *page) {
+  write_i32(page + PAGE_CRC_OFFSET, crc32c(page, PAGE_CRC_OFFSET));
+}
+
+static int is_page_sealed(const unsigned char *page) {
+  return (unsigned)read_i32(page + PAGE_CRC_OFFSET) ==
+         crc32c(page, PAGE_CRC_OFFSET);
+}
+
+/**
+ * @brief Checks a node read from the file against its checksum and its
+ *        capacity.
+ */
+static int is_node_valid(const unsigned char *node) {
+  const int kind = node_kind(node);
+  const int capacity = kind == LEAF_NODE ? LEAF_CAPACITY : INNER_CAPACITY;
+  return is_page_sealed(node) && kind <= INNER_NODE && node_count(node) > 0 &&
+         node_count(node) <= capacity;
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Gets a page kept in memory since the file was mapped.
+ */
+static unsigned char *fresh_page(const RankTree *t, const int page) {
+  return t->fresh + (size_t)(page - t->num_mapped) * RANK_TREE_PAGE_SIZE;
+}
+
+/**
+ * @brief Gets a node, checking it against its checksum if it is read from the
+ *        mapped file.
+ */
+static const unsigned char *read_node(const RankTree *t, const int page) {
+  if (page < META_PAGES || page >= t->num_pages) {
+    logger.log("page %i is outside the file", page);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  if (page >= t->num_mapped) {
+    return fresh_page(t, page);
+  }
+
+  const unsigned char *node =
+      t->data + (size_t)page * RANK_TREE_PAGE_SIZE;
+  if (!is_node_valid(node)) {
+    logger.log("page %i is corrupted", page);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  return node;
+}
+
+/**
+ * @brief Adds an empty page at the end of the file, kept in memory.
+ *
+ * Pointers to the pages in memory are no longer valid afterwards.
+ */
+static int alloc_page(RankTree *t) {
+  if (t->num_pages == INT_MAX / RANK_TREE_PAGE_SIZE) {
+    logger.log("the file can not grow past %i pages", t->num_pages);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  const int needed = t->num_pages + 1 - t->num_mapped;
+  if (needed > t->fresh_capacity) {
+    int capacity = 2 * t->fresh_capacity;
+    if (capacity < needed) {
+      capacity = needed + FRESH_INITIAL_PAGES;
+    }
+    unsigned char *fresh = (unsigned char *)realloc(  // NOLINT
+        t->fresh, (size_t)capacity * RANK_TREE_PAGE_SIZE);
+    if (!fresh) {
+      logger.log("can not keep %i pages in memory", capacity);
+      logger.stop();
+      throw_err(ALLOCATION_ERROR);
+    }
+    t->fresh = fresh;
+    t->fresh_capacity = capacity;
+  }
+  const int page = t->num_pages;
+  t->num_pages = t->num_pages + 1;
+  memset(fresh_page(t, page), 0, RANK_TREE_PAGE_SIZE);
+  return page;
+}
+
+/**
+ * @brief Copies a node to a new page, unless it was added by the current
+ *        update and can be changed in place.
+ *
+ * @return The page that can be changed.
+ */
+static int copy_page(RankTree *t, const int page) {
+  if (page >= t->first_new) {
+    return page;
+  }
+  const int copy = alloc_page(t);
+  memcpy(fresh_page(t, copy), read_node(t, page), RANK_TREE_PAGE_SIZE);
+  t->num_dead = t->num_dead + 1;
+  return copy;
+}
+
+/**
+ * @brief Finds the child of an inner node whose subtree holds a record.
+ */
+static int find_child(const unsigned char *node, const int order,
+                      const unsigned char rec[]) {
+  // the first child whose record is after the given one, skipping the first
+  int low = 1;
+  int high = node_count(node);
+  while (low < high) {
+    const int mid = (low + high) / 2;
+    if (compare_records(order, node + key_offset(INNER_NODE, mid), rec) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low - 1;
+}
+
+/**
+ * @brief Finds the position of the first record of a leaf not before a
+ *        record.
+ */
+static int find_record(const unsigned char *node, const int order,
+                       const unsigned char rec[]) {
+  int low = 0;
+  int high = node_count(node);
+  while (low < high) {
+    const int mid = (low + high) / 2;
+    if (compare_records(order, node + key_offset(LEAF_NODE, mid), rec) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Finds the leaf of a tree where a record is or would be.
+ */
+static const unsigned char *find_leaf(const RankTree *t, const int order,
+                                      const int root,
+                                      const unsigned char rec[]) {
+  const unsigned char *node = read_node(t, root);
+  while (node_kind(node) == INNER_NODE) {
+    node = read_node(t, child_page(node, find_child(node, order, rec)));
+  }
+  return node;
+}
+
+/**
+ * @brief Inserts an item at a position of a node of the current update,
+ *        moving the upper half of its items to a new node if it is full.
+ */
+static void insert_item(RankTree *t, const int page, const int pos,
+                        const unsigned char item[], TreeSplit *split) {
+  unsigned char *node = fresh_page(t, page);
+  const int kind = node_kind(node);
+  const int count = node_count(node);
+  const int size = item_size_of(kind);
+  const int capacity = kind == LEAF_NODE ? LEAF_CAPACITY : INNER_CAPACITY;
+  unsigned char *items = node + NODE_HEADER_SIZE;
+
+  split->page = NO_PAGE;
+  if (count < capacity) {
+    memmove(items + (pos + 1) * size, items + pos * size, (count - pos) * size);
+    memcpy(items + pos * size, item, size);
+    set_node_header(node, kind, count + 1);
+    return;
+  }
+
+  // a full node and one more item still fit in a page
+  unsigned char merged[RANK_TREE_PAGE_SIZE];
+  memcpy(merged, items, pos * size);
+  memcpy(merged + pos * size, item, size);
+  memcpy(merged + (pos + 1) * size, items + pos * size, (count - pos) * size);
+  const int num_left = (count + 1) / 2;
+  const int num_right = count + 1 - num_left;
+
+  split->page = alloc_page(t);
+  node = fresh_page(t, page);
+  unsigned char *right = fresh_page(t, split->page);
+  memcpy(node + NODE_HEADER_SIZE, merged, num_left * size);
+  set_node_header(node, kind, num_left);
+  memcpy(right + NODE_HEADER_SIZE, merged + num_left * size, num_right * size);
+  set_node_header(right, kind, num_right);
+  memcpy(split->key, right + key_offset(kind, 0), RECORD_SIZE);
+  split->size = subtree_size(right);
+}
+
+/**
+ * @brief Inserts a record inside a subtree, copying the nodes on its way.
+ *
+ * @return The page of the subtree once copied.
+ */
+static int insert_record(RankTree *t, const int order, const int page,
+                         const unsigned char rec[], TreeSplit *split) {
+  const int copy = copy_page(t, page);
+  const unsigned char *node = fresh_page(t, copy);
+  if (node_kind(node) == LEAF_NODE) {
+    insert_item(t, copy, find_record(node, order, rec), rec, split);
+    return copy;
+  }
+
+  const int i = find_child(node, order, rec);
+  const int child = insert_record(t, order, child_page(node, i), rec, split);
+  // the pages may have moved while the child was copied
+  unsigned char *item = fresh_page(t, copy) + item_offset(INNER_NODE, i);
+  write_i32(item, child);
+  if (split->page == NO_PAGE) {
+    write_i32(item + 4, read_i32(item + 4) + 1);
+    return copy;
+  }
+  write_i32(item + 4, read_i32(item + 4) + 1 - split->size);
+  unsigned char half[CHILD_SIZE];
+  write_i32(half, split->page);
+  write_i32(half + 4, split->size);
+  memcpy(half + 8, split->key, RECORD_SIZE);
+  insert_item(t, copy, i + 1, half, split);
+  return copy;
+}
+
+/**
+ * @brief Inserts a record inside a tree.
+ *
+ * @return The new root of the tree.
+ */
+static int insert_into_tree(RankTree *t, const int order, const int root,
+                            const unsigned char rec[]) {
+  if (root == NO_PAGE) {
+    const int leaf = alloc_page(t);
+    unsigned char *node = fresh_page(t, leaf);
+    set_node_header(node, LEAF_NODE, 1);
+    memcpy(node + NODE_HEADER_SIZE, rec, RECORD_SIZE);
+    return leaf;
+  }
+
+  TreeSplit split;
+  const int left = insert_record(t, order, root, rec, &split);
+  if (split.page == NO_PAGE) {
+    return left;
+  }
+
+  // the root was split, so the tree grows by one level
+  const int new_root = alloc_page(t);
+  const unsigned char *left_node = fresh_page(t, left);
+  unsigned char *node = fresh_page(t, new_root);
+  set_node_header(node, INNER_NODE, 2);
+  unsigned char *item = node + item_offset(INNER_NODE, 0);
+  write_i32(item, left);
+  write_i32(item + 4, subtree_size(left_node));
+  memcpy(item + 8, left_node + key_offset(node_kind(left_node), 0),
+         RECORD_SIZE);
+  item = node + item_offset(INNER_NODE, 1);
+  write_i32(item, split.page);
+  write_i32(item + 4, split.size);
+  memcpy(item + 8, split.key, RECORD_SIZE);
+  return new_root;
+}
+
+/**
+ * @brief Removes a record from a subtree holding it, copying the nodes on its
+ *        way.
+ *
+ * Nodes are not merged with their siblings, they are only dropped once empty.
+ *
+ * @return The page of the subtree once copied, or @c NO_PAGE if it is left
+ *         empty.
+ */
+static int delete_record(RankTree *t, const int order, const int page,
+                         const unsigned char rec[]) {
+  const int copy = copy_page(t, page);
+  unsigned char *node = fresh_page(t, copy);
+  const int kind = node_kind(node);
+  const int count = node_count(node);
+
+  int i;
+  if (kind == LEAF_NODE) {
+    i = find_record(node, order, rec);
+    if (i == count ||
+        compare_records(order, node + key_offset(LEAF_NODE, i), rec) != 0) {
+      logger.log("record missing from page %i", page);
+      logger.stop();
+      throw_err(CORRUPTED_LEADERBOARD_ERROR);
+    }
+  } else {
+    i = find_child(node, order, rec);
+    const int child = delete_record(t, order, child_page(node, i), rec);
+    node = fresh_page(t, copy);
+    if (child != NO_PAGE) {
+      unsigned char *item = node + item_offset(INNER_NODE, i);
+      write_i32(item, child);
+      write_i32(item + 4, read_i32(item + 4) - 1);
+      return copy;
+    }
+  }
+
+  const int size = item_size_of(kind);
+  unsigned char *items = node + NODE_HEADER_SIZE;
+  memmove(items + i * size, items + (i + 1) * size, (count - i - 1) * size);
+  set_node_header(node, kind, count - 1);
+  if (count == 1) {
+    t->num_dead = t->num_dead + 1;
+    return NO_PAGE;
+  }
+  return copy;
+}
+
+/**
+ * @brief Removes a record from a tree holding it.
+ *
+ * @return The new root of the tree.
+ */
+static int delete_from_tree(RankTree *t, const int order, const int root,
+                            const unsigned char rec[]) {
+  int page = delete_record(t, order, root, rec);
+  // a root left with a single child is replaced by it
+  while (page != NO_PAGE) {
+    const unsigned char *node = read_node(t, page);
+    if (node_kind(node) == LEAF_NODE || node_count(node) > 1) {
+      break;
+    }
+    page = child_page(node, 0);
+    t->num_dead = t->num_dead + 1;
+  }
+  return page;
+}
+
+/**
+ * @brief Counts the records of the tree ordered by rank that come before a
+ *        record.
+ */
+static int count_before(const RankTree *t, const unsigned char rec[]) {
+  if (t->rank_root == NO_PAGE) {
+    return 0;
+  }
+  int num_before = 0;
+  const unsigned char *node = read_node(t, t->rank_root);
+  while (node_kind(node) == INNER_NODE) {
+    const int child = find_child(node, RANK_ORDER, rec);
+    int i = 0;
+    while (i < child) {
+      num_before = num_before + child_size(node, i);
+      i = i + 1;
+    }
+    node = read_node(t, child_page(node, child));
+  }
+  return num_before + find_record(node, RANK_ORDER, rec);
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+static void write_meta(unsigned char *page, const RankTree *t) {
+  memset(page, 0, RANK_TREE_PAGE_SIZE);
+  memcpy(page, RANK_TREE_MAGIC, RANK_TREE_MAGIC_LEN);
+  write_u16(page + META_VERSION, RANK_TREE_VERSION);
+  write_i32(page + META_GENERATION, t->generation);
+  write_i32(page + META_RANK_ROOT, t->rank_root);
+  write_i32(page + META_NAME_ROOT, t->name_root);
+  write_i32(page + META_NUM_ENTRIES, t->num_entries);
+  write_i32(page + META_NUM_PAGES, t->num_pages);
+  write_i32(page + META_NUM_DEAD, t->num_dead);
+  seal_page(page);
+}
+
+static int is_root_valid(const int root, const int num_pages) {
+  return root == NO_PAGE || (root >= META_PAGES && root < num_pages);
+}
+
+/**
+ * @brief Reads a meta page if it is valid and newer than the one read so far.
+ *
+ * A meta page is only written once the pages it refers to are, so a meta page
+ * counting more pages than the file holds is not valid.
+ */
+static void read_meta(RankTree *t, const unsigned char *page,
+                      const int num_file_pages) {
+  const int num_pages = read_i32(page + META_NUM_PAGES);
+  const int rank_root = read_i32(page + META_RANK_ROOT);
+  const int name_root = read_i32(page + META_NAME_ROOT);
+  if (!is_page_sealed(page) ||
+      memcmp(page, RANK_TREE_MAGIC, RANK_TREE_MAGIC_LEN) != 0 ||
+      read_u16(page + META_VERSION) != RANK_TREE_VERSION ||
+      read_i32(page + META_GENERATION) <= t->generation ||
+      num_pages < META_PAGES || num_pages > num_file_pages ||
+      !is_root_valid(rank_root, num_pages) ||
+      !is_root_valid(name_root, num_pages) ||
+      read_i32(page + META_NUM_ENTRIES) < 0 ||
+      read_i32(page + META_NUM_DEAD) < 0) {
+    return;
+  }
+  t->generation = read_i32(page + META_GENERATION);
+  t->rank_root = rank_root;
+  t->name_root = name_root;
+  t->num_entries = read_i32(page + META_NUM_ENTRIES);
+  t->num_pages = num_pages;
+  t->num_dead = read_i32(page + META_NUM_DEAD);
+}
+
+/**
+ * @brief Reads the newest of the two meta pages of a file.
+ *
+ * @return @c TRUE if any of them is valid.
+ */
+static int read_metas(RankTree *t, const unsigned char *pages,
+                      const int num_file_pages) {
+  t->generation = 0;
+  if (num_file_pages >= META_PAGES) {
+    read_meta(t, pages, num_file_pages);
+    read_meta(t, pages + RANK_TREE_PAGE_SIZE, num_file_pages);
+  }
+  return t->generation > 0;
+}
+
+/**
+ * @brief Checks whether the first meta page of a file has never been written.
+ *
+ * The first update of an empty file writes its meta page to the second slot,
+ * while files laid out from scratch have both, so a file without a valid meta
+ * page whose first slot is blank is an empty file whose first update did not
+ * complete.
+ */
+static int is_first_meta_blank(const unsigned char *pages, const int size) {
+  int i = 0;
+  while (i < size && i < RANK_TREE_PAGE_SIZE && pages[i] == 0) {
+    i = i + 1;
+  }
+  return i == size || i == RANK_TREE_PAGE_SIZE;
+}
+
+/**
+ * @brief Maps the file read-only, once the writes queued on it are done.
+ *
+ * @return The size in bytes of the file.
+ */
+static int map_file(RankTree *t) {
+  wait_file_io(t->path);
+
+  // the file stays open while the pool appends to it
+  t->file = CreateFileA(t->path, GENERIC_READ,
+                        FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  LARGE_INTEGER file_size;
+  if (t->file == INVALID_HANDLE_VALUE ||
+      !GetFileSizeEx(t->file, &file_size) || file_size.QuadPart > INT_MAX) {
+    logger.log("file is not readable");
+    logger.stop();
+    throw_err(FILE_NOT_READABLE_ERROR);
+  }
+
+  // an empty file can not be mapped, but it is a valid file without entries
+  const int size = (int)file_size.QuadPart;
+  if (size > 0) {
+    t->mapping = CreateFileMappingA(t->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (t->mapping) {
+      t->data = (const unsigned char *)MapViewOfFile(t->mapping, FILE_MAP_READ,
+                                                     0, 0, 0);
+    }
+    if (!t->data) {
+      logger.log("file can not be mapped");
+      logger.stop();
+      throw_err(FILE_NOT_READABLE_ERROR);
+    }
+  }
+  return size;
+}
+
+static void unmap_file(RankTree *t) {
+  if (t->data) {
+    UnmapViewOfFile(t->data);
+  }
+  if (t->mapping) {
+    CloseHandle(t->mapping);
+  }
+  if (t->file) {
+    CloseHandle(t->file);
+  }
+  t->data = NULL;
+  t->mapping = NULL;
+  t->file = NULL;
+}
+
+/**
+ * @brief Maps the file again, so that the pages appended since it was mapped
+ *        are no longer kept in memory.
+ */
+static void remap_rank_tree(RankTree *t) {
+  logger.enter_fn(__func__);
+
+  unmap_file(t);
+  const int num_file_pages = map_file(t) / RANK_TREE_PAGE_SIZE;
+  const int num_mapped =
+      num_file_pages < t->num_pages ? num_file_pages : t->num_pages;
+  if (num_mapped < t->num_mapped) {
+    logger.log("file shrank to %i pages", num_file_pages);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  memmove(t->fresh, fresh_page(t, num_mapped),
+          (size_t)(t->num_pages - num_mapped) * RANK_TREE_PAGE_SIZE);
+  logger.log("mapped %i pages, %i still in memory", num_mapped,
+             t->num_pages - num_mapped);
+  t->num_mapped = num_mapped;
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Copies the mapped pages in front of the ones kept in memory and
+ *        unmaps the file, so that the I/O pool can replace it.
+ */
+static void unmap_rank_tree(RankTree *t) {
+  unsigned char *pages = (unsigned char *)malloc(  // NOLINT
+      (size_t)t->num_pages * RANK_TREE_PAGE_SIZE);
+  if (!pages) {
+    logger.log("can not keep %i pages in memory", t->num_pages);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  const size_t mapped_size = (size_t)t->num_mapped * RANK_TREE_PAGE_SIZE;
+  if (t->num_mapped > 0) {
+    memcpy(pages, t->data, mapped_size);
+  }
+  memcpy(pages + mapped_size, t->fresh,
+         (size_t)(t->num_pages - t->num_mapped) * RANK_TREE_PAGE_SIZE);
+  unmap_file(t);
+  free(t->fresh);
+  t->fresh = pages;
+  t->fresh_capacity = t->num_pages;
+  t->num_mapped = 0;
+}
+
+/**
+ * @brief Maps the file again once the I/O pool has rebuilt it, reading the
+ *        meta pages of its new layout.
+ */
+static void reload_rank_tree(RankTree *t) {
+  logger.enter_fn(__func__);
+
+  free(t->fresh);
+  t->fresh = NULL;
+  t->fresh_capacity = 0;
+  // the file holds the same entries whether it has been rebuilt or not
+  const int num_file_pages = map_file(t) / RANK_TREE_PAGE_SIZE;
+  if (!read_metas(t, t->data, num_file_pages)) {
+    logger.log("no valid meta page in %i rebuilt pages", num_file_pages);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  t->num_mapped =
+      num_file_pages < t->num_pages ? num_file_pages : t->num_pages;
+  t->first_new = t->num_pages;
+  t->is_rebuilt = FALSE;
+  logger.log("mapped %i pages, %i entries", t->num_mapped, t->num_entries);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Copies the records of a subtree of a file read back by the I/O pool,
+ *        in order, checking every node on the way.
+ *
+ * @return @c FALSE if a node is not valid, or if there are more records or
+ *         nodes than the meta page counts.
+ */
+static int collect_records(const unsigned char content[],
+                           const RankTree *meta, const int page,
+                           const int depth, Entry entries[], int *num_read,
+                           int *num_visited) {
+  *num_visited = *num_visited + 1;
+  if (page < META_PAGES || page >= meta->num_pages || depth > MAX_DEPTH ||
+      *num_visited > meta->num_pages) {
+    return FALSE;
+  }
+  const unsigned char *node = content + (size_t)page * RANK_TREE_PAGE_SIZE;
+  if (!is_node_valid(node)) {
+    return FALSE;
+  }
+  int i = 0;
+  if (node_kind(node) == LEAF_NODE) {
+    if (node_count(node) > meta->num_entries - *num_read) {
+      return FALSE;
+    }
+    while (i < node_count(node)) {
+      decode_record(node + key_offset(LEAF_NODE, i), &entries[*num_read]);
+      *num_read = *num_read + 1;
+      i = i + 1;
+    }
+    return TRUE;
+  }
+  while (i < node_count(node)) {
+    if (!collect_records(content, meta, child_page(node, i), depth + 1,
+                         entries, num_read, num_visited)) {
+      return FALSE;
+    }
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Rebuilds the file on a thread of the I/O pool (see @c IoRewrite),
+ *        from the entries of its tree ordered by rank.
+ */
+static unsigned char *rebuild_content(const unsigned char content[],
+                                      const int size, int *new_size) {
+  RankTree meta;
+  memset(&meta, 0, sizeof(meta));
+  meta.rank_root = NO_PAGE;
+  if (!read_metas(&meta, content, size / RANK_TREE_PAGE_SIZE)) {
+    return NULL;
+  }
+  Entry *entries = (Entry *)malloc(  // NOLINT
+      (meta.num_entries + 1) * sizeof(Entry));
+  if (!entries) {
+    return NULL;
+  }
+  int num_read = 0;
+  int num_visited = 0;
+  unsigned char *data = NULL;
+  if ((meta.rank_root == NO_PAGE ||
+       collect_records(content, &meta, meta.rank_root, 0, entries, &num_read,
+                       &num_visited)) &&
+      num_read == meta.num_entries) {
+    data = layout_rank_tree(entries, num_read, new_size);
+  }
+  free(entries);
+  return data;
+}
+
+/**
+ * @brief Queues the pages of the current update and a new meta page, and the
+ *        file to be rebuilt by the I/O pool right after them if asked to.
+ */
+static IoRequest *commit_rank_tree(RankTree *t, const int is_rebuilt) {
+  const int num_new = t->num_pages - t->first_new;
+  unsigned char *data = (unsigned char *)malloc(  // NOLINT
+      (size_t)(num_new + 1) * RANK_TREE_PAGE_SIZE);
+  if (!data) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < num_new) {
+    seal_page(fresh_page(t, t->first_new + i));
+    i = i + 1;
+  }
+  memcpy(data, fresh_page(t, t->first_new),
+         (size_t)num_new * RANK_TREE_PAGE_SIZE);
+  t->generation = t->generation + 1;
+  write_meta(data + num_new * RANK_TREE_PAGE_SIZE, t);
+
+  // the meta page overwrites the older of the two, once the pages are written
+  IoSegment segments[2];
+  segments[0].offset = t->first_new * RANK_TREE_PAGE_SIZE;
+  segments[0].size = num_new * RANK_TREE_PAGE_SIZE;
+  segments[1].offset = (t->generation % META_PAGES) * RANK_TREE_PAGE_SIZE;
+  segments[1].size = RANK_TREE_PAGE_SIZE;
+  t->first_new = t->num_pages;
+  if (!is_rebuilt) {
+    return submit_write(t->path, data, segments, 2);
+  }
+
+  // the file can not be replaced while it is mapped, so every page is kept in
+  // memory until the file is mapped again before the next update
+  unmap_rank_tree(t);
+  t->is_rebuilt = TRUE;
+  return submit_rewrite(t->path, data, segments, 2, rebuild_content);
+}
+
+/**
+ * @brief Reads the score of every player into the index of the names.
+ */
+static void index_scores(RankTree *t) {
+  logger.enter_fn(__func__);
+
+  t->scores = new_name_index();
+  Entry entries[LEAF_CAPACITY];
+  int first = 0;
+  while (first < t->num_entries) {
+    const int count = get_tree_entries(t, first, LEAF_CAPACITY, entries);
+    int i = 0;
+    while (i < count) {
+      put_name(t->scores, pack_name(get_name(&entries[i])),
+               get_final_score(&entries[i]));
+      i = i + 1;
+    }
+    first = first + count;
+  }
+  logger.log("indexed %i players", t->num_entries);
+
+  logger.exit_fn();
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+RankTree *open_rank_tree(const char path[]) {
+  logger.enter_fn(__func__);
+
+  RankTree *t = (RankTree *)malloc(sizeof(RankTree));  // NOLINT
+  if (!t) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  snprintf(t->path, MAX_BUFFER_LEN, "%s", path);
+  t->file = NULL;
+  t->mapping = NULL;
+  t->data = NULL;
+  t->fresh = NULL;
+  t->fresh_capacity = 0;
+  t->rank_root = NO_PAGE;
+  t->name_root = NO_PAGE;
+  t->num_entries = 0;
+  t->num_pages = META_PAGES;
+  t->num_dead = 0;
+  t->is_rebuilt = FALSE;
+  t->scores = NULL;
+
+  const int size = map_file(t);
+  const int num_file_pages = size / RANK_TREE_PAGE_SIZE;
+  if (!read_metas(t, t->data, num_file_pages) &&
+      !is_first_meta_blank(t->data, size)) {
+    logger.log("no valid meta page in %i bytes", size);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  // pages after the ones counted by the meta page were left by an update that
+  // did not complete, and are written again by the next one
+  t->num_mapped =
+      num_file_pages < t->num_pages ? num_file_pages : t->num_pages;
+  t->first_new = t->num_pages;
+  logger.log("mapped %i pages, %i entries, generation %i", t->num_mapped,
+             t->num_entries, t->generation);
+
+  logger.exit_fn();
+  return t;
+}
+
+void close_rank_tree(RankTree *t) {
+  if (!t) {
+    return;
+  }
+  unmap_file(t);
+  free(t->fresh);
+  free_name_index(t->scores);
+  free(t);
+}
+
+int get_tree_size(const RankTree *t) { return t->num_entries; }
+
+int find_in_tree(const RankTree *t, const char name[], Entry *e) {
+  if (t->name_root == NO_PAGE) {
+    return FALSE;
+  }
+  unsigned char key[RECORD_SIZE];
+  encode_name(key, name);
+  const unsigned char *leaf = find_leaf(t, NAME_ORDER, t->name_root, key);
+  const int i = find_record(leaf, NAME_ORDER, key);
+  if (i == node_count(leaf) ||
+      compare_records(NAME_ORDER, leaf + key_offset(LEAF_NODE, i), key) != 0) {
+    return FALSE;
+  }
+  decode_record(leaf + key_offset(LEAF_NODE, i), e);
+  return TRUE;
+}
+
+int get_tree_rank(const RankTree *t, const char name[]) {
+  Entry e;
+  if (!find_in_tree(t, name, &e)) {
+    return RANK_TREE_NOT_FOUND;
+  }
+  return get_score_rank(t, get_final_score(&e));
+}
+
+int get_score_rank(const RankTree *t, const int score) {
+  // an empty name comes before any other name with the same score
+  unsigned char key[RECORD_SIZE];
+  encode_name(key, "");
+  write_i32(key + MAX_USERNAME_LENGTH, score);
+  return count_before(t, key) + 1;
+}
+
+int get_tree_position(const RankTree *t, const char name[]) {
+  Entry e;
+  if (!find_in_tree(t, name, &e)) {
+    return RANK_TREE_NOT_FOUND;
+  }
+  unsigned char rec[RECORD_SIZE];
+  encode_record(rec, &e);
+  return count_before(t, rec);
+}
+
+int get_tree_entries(const RankTree *t, const int first, const int count,
+                     Entry entries[]) {
+  if (first >= t->num_entries || count <= 0) {
+    return 0;
+  }
+
+  // the leaf holding the first entry is reached from the root, following the
+  // sizes of the subtrees, and the path is kept to move to the next leaves
+  const unsigned char *path[MAX_DEPTH];
+  int children[MAX_DEPTH];
+  int depth = 0;
+  int pos = first;
+  const unsigned char *node = read_node(t, t->rank_root);
+  while (node_kind(node) == INNER_NODE && depth < MAX_DEPTH) {
+    int i = 0;
+    while (i < node_count(node) - 1 && pos >= child_size(node, i)) {
+      pos = pos - child_size(node, i);
+      i = i + 1;
+    }
+    path[depth] = node;
+    children[depth] = i;
+    depth = depth + 1;
+    node = read_node(t, child_page(node, i));
+  }
+
+  int copied = 0;
+  while (copied < count && first + copied < t->num_entries) {
+    if (node_kind(node) != LEAF_NODE || pos >= node_count(node)) {
+      logger.log("the sizes of the subtrees do not match their leaves");
+      logger.stop();
+      throw_err(CORRUPTED_LEADERBOARD_ERROR);
+    }
+    while (pos < node_count(node) && copied < count) {
+      decode_record(node + key_offset(LEAF_NODE, pos), &entries[copied]);
+      copied = copied + 1;
+      pos = pos + 1;
+    }
+    if (copied < count && first + copied < t->num_entries) {
+      // up to the first node with a child left, and down its first children
+      while (depth > 0 &&
+             children[depth - 1] == node_count(path[depth - 1]) - 1) {
+        depth = depth - 1;
+      }
+      if (depth == 0) {
+        logger.log("the tree has fewer entries than its meta page");
+        logger.stop();
+        throw_err(CORRUPTED_LEADERBOARD_ERROR);
+      }
+      children[depth - 1] = children[depth - 1] + 1;
+      node = read_node(t, child_page(path[depth - 1], children[depth - 1]));
+      while (node_kind(node) == INNER_NODE && depth < MAX_DEPTH) {
+        path[depth] = node;
+        children[depth] = 0;
+        depth = depth + 1;
+        node = read_node(t, child_page(node, 0));
+      }
+      pos = 0;
+    }
+  }
+  return copied;
+}
+
+/**
+ * @brief Moves the entry of a player inside both trees, or adds it.
+ *
+ * @return @c TRUE if the trees changed, @c FALSE if the player already has an
+ *         entry with a score not lower than the given one.
+ */
+static int merge_entry(RankTree *t, const Entry *e) {
+  const unsigned key = pack_name(get_name(e));
+  int score;
+  const int is_ranked = find_name(t->scores, key, &score);
+  if (is_ranked && score >= get_final_score(e)) {
+    return FALSE;
+  }
+
+  // the entry moves inside the tree ordered by rank, and its score changes
+  // inside the tree ordered by name
+  unsigned char rec[RECORD_SIZE];
+  encode_record(rec, e);
+  if (is_ranked) {
+    unsigned char old[RECORD_SIZE];
+    memcpy(old, rec, MAX_USERNAME_LENGTH);
+    write_i32(old + MAX_USERNAME_LENGTH, score);
+    t->rank_root = delete_from_tree(t, RANK_ORDER, t->rank_root, old);
+    t->name_root = delete_from_tree(t, NAME_ORDER, t->name_root, old);
+  } else {
+    t->num_entries = t->num_entries + 1;
+  }
+  t->rank_root = insert_into_tree(t, RANK_ORDER, t->rank_root, rec);
+  t->name_root = insert_into_tree(t, NAME_ORDER, t->name_root, rec);
+  put_name(t->scores, key, get_final_score(e));
+  return TRUE;
+}
+
+IoRequest *upsert_rank_tree(RankTree *t, const Entry entries[],
+                            const int num_entries) {
+  logger.enter_fn(__func__);
+
+  if (t->is_rebuilt) {
+    reload_rank_tree(t);
+  }
+  if (!t->scores) {
+    index_scores(t);
+  }
+  if (t->num_pages - t->num_mapped > RANK_TREE_MAX_FRESH_PAGES) {
+    remap_rank_tree(t);
+  }
+
+  // every entry of the batch goes to the same new pages, so the nodes they
+  // share are copied and written only once
+  t->first_new = t->num_pages;
+  int num_changed = 0;
+  int i = 0;
+  while (i < num_entries) {
+    if (merge_entry(t, &entries[i])) {
+      num_changed = num_changed + 1;
+    }
+    i = i + 1;
+  }
+  if (num_changed == 0) {
+    logger.exit_fn();
+    return NULL;
+  }
+  logger.log("updated %i of %i entries with %i new pages", num_changed,
+             num_entries, t->num_pages - t->first_new);
+
+  // the file is rebuilt by the I/O pool, so that the caller does not wait for
+  // every entry to be laid out again
+  const int num_used = t->num_pages - META_PAGES - t->num_dead;
+  const int is_rebuilt =
+      t->num_dead >= RANK_TREE_COMPACT_PAGES && t->num_dead > num_used;
+  if (is_rebuilt) {
+    logger.log("rebuilding %i entries, %i of %i pages unused", t->num_entries,
+               t->num_dead, t->num_pages);
+  }
+  IoRequest *req = commit_rank_tree(t, is_rebuilt);
+
+  logger.exit_fn();
+  return req;
+}
+
+/**
+ * @brief Counts the nodes needed to hold some items, each node holding at most
+ *        a given number of them.
+ */
+static int count_nodes(const int num_items, const int fill) {
+  return (num_items + fill - 1) / fill;
+}
+
+static int count_tree_pages(const int num_entries) {
+  if (num_entries == 0) {
+    return 0;
+  }
+  int num_nodes = count_nodes(num_entries, LEAF_FILL);
+  int num_pages = num_nodes;
+  while (num_nodes > 1) {
+    num_nodes = count_nodes(num_nodes, INNER_FILL);
+    num_pages = num_pages + num_nodes;
+  }
+  return num_pages;
+}
+
+/**
+ * @brief Lays out a tree from entries in its order, one level at a time from
+ *        the leaves up, after the pages laid out so far.
+ *
+ * The items are spread evenly over the nodes of each level, so that no node is
+ * left almost empty.
+ *
+ * @return The root of the tree.
+ */
+static int layout_tree(unsigned char *file, int *num_pages,
+                       const Entry entries[], const int num_entries) {
+  if (num_entries == 0) {
+    return NO_PAGE;
+  }
+
+  int first = *num_pages;
+  int num_nodes = count_nodes(num_entries, LEAF_FILL);
+  int done = 0;
+  int i = 0;
+  while (i < num_nodes) {
+    const int count = (num_entries - done) / (num_nodes - i);
+    unsigned char *node = file + (size_t)(first + i) * RANK_TREE_PAGE_SIZE;
+    set_node_header(node, LEAF_NODE, count);
+    int j = 0;
+    while (j < count) {
+      encode_record(node + item_offset(LEAF_NODE, j), &entries[done + j]);
+      j = j + 1;
+    }
+    done = done + count;
+    i = i + 1;
+  }
+  *num_pages = first + num_nodes;
+
+  while (num_nodes > 1) {
+    const int below = first;
+    const int num_below = num_nodes;
+    first = *num_pages;
+    num_nodes = count_nodes(num_below, INNER_FILL);
+    done = 0;
+    i = 0;
+    while (i < num_nodes) {
+      const int count = (num_below - done) / (num_nodes - i);
+      unsigned char *node = file + (size_t)(first + i) * RANK_TREE_PAGE_SIZE;
+      set_node_header(node, INNER_NODE, count);
+      int j = 0;
+      while (j < count) {
+        const int page = below + done + j;
+        const unsigned char *child =
+            file + (size_t)page * RANK_TREE_PAGE_SIZE;
+        unsigned char *item = node + item_offset(INNER_NODE, j);
+        write_i32(item, page);
+        write_i32(item + 4, subtree_size(child));
+        memcpy(item + 8, child + key_offset(node_kind(child), 0), RECORD_SIZE);
+        j = j + 1;
+      }
+      done = done + count;
+      i = i + 1;
+    }
+    *num_pages = first + num_nodes;
+  }
+  return first;
+}
+
+unsigned char *layout_rank_tree(const Entry entries[], const int num_entries,
+                                int *size) {
+  const int num_pages = META_PAGES + 2 * count_tree_pages(num_entries);
+  unsigned char *file = (unsigned char *)calloc(  // NOLINT
+      num_pages, RANK_TREE_PAGE_SIZE);
+  Entry *copy = (Entry *)malloc(  // NOLINT
+      (num_entries + 1) * sizeof(Entry));
+  Entry *tmp = (Entry *)malloc(  // NOLINT
+      (num_entries + 1) * sizeof(Entry));
+  if (!file || !copy || !tmp) {
+    free(file);
+    free(copy);
+    free(tmp);
+    return NULL;
+  }
+  memcpy(copy, entries, num_entries * sizeof(Entry));
+  const Entry *by_name = sort_by_name(copy, tmp, num_entries);
+
+  RankTree meta;
+  memset(&meta, 0, sizeof(meta));
+  meta.num_pages = META_PAGES;
+  meta.rank_root = layout_tree(file, &meta.num_pages, entries, num_entries);
+  meta.name_root = layout_tree(file, &meta.num_pages, by_name, num_entries);
+  meta.num_entries = num_entries;
+  meta.generation = 1;
+  free(copy);
+  free(tmp);
+
+  int page = META_PAGES;
+  while (page < num_pages) {
+    seal_page(file + (size_t)page * RANK_TREE_PAGE_SIZE);
+    page = page + 1;
+  }
+  write_meta(file, &meta);
+  write_meta(file + RANK_TREE_PAGE_SIZE, &meta);
+  *size = num_pages * RANK_TREE_PAGE_SIZE;
+  return file;
+}
+
+IoRequest *write_rank_tree(const char path[], const Entry entries[],
+                           const int num_entries) {
+  logger.enter_fn(__func__);
+
+  int size;
+  unsigned char *data = layout_rank_tree(entries, num_entries, &size);
+  if (!data) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  logger.log("laid out %i entries in %i pages", num_entries,
+             size / RANK_TREE_PAGE_SIZE);
+
+  logger.exit_fn();
+  return submit_replace(path, data, size);
+}
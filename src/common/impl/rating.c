@@ -0,0 +1,423 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../inc/bytes.h"
+#include "../inc/error.h"
+#include "../inc/logger.h"
+#include "../inc/nameindex.h"
+
+#include "../inc/rating.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Doubles the number of slots of the table.
+ */
+static void grow_rating_table(RatingTable *t) {
+  logger.enter_fn(__func__);
+
+  const int capacity = 2 * t->capacity;
+  unsigned *keys = (unsigned *)realloc(  // NOLINT
+      t->keys, capacity * sizeof(unsigned));
+  if (keys) {
+    t->keys = keys;
+  }
+  int *ratings = (int *)realloc(t->ratings, capacity * sizeof(int));  // NOLINT
+  if (ratings) {
+    t->ratings = ratings;
+  }
+  int *num_games = (int *)realloc(  // NOLINT
+      t->num_games, capacity * sizeof(int));
+  if (num_games) {
+    t->num_games = num_games;
+  }
+  if (!keys || !ratings || !num_games) {
+    logger.log("can not grow to %i players", capacity);
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  t->capacity = capacity;
+  logger.log("grown to %i players", capacity);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Computes the changes of rating of the players of a game from their
+ *        ratings before it, then applies them.
+ *
+ * It does not log anything, so it can be called from any thread, as long as
+ * no other thread rates a game of the same players.
+ */
+static void apply_game(RatingTable *t, const GameOutcome *g,
+                       const int slots[], int changes[]) {
+  const int n = g->num_players;
+  if (n < 2) {
+    return;
+  }
+  // the expected score of a against b is q(a) / (q(a) + q(b))
+  double q[MAX_NUM_PLAYERS];
+  int i = 0;
+  while (i < n) {
+    const double points = (double)t->ratings[slots[i]] / RATING_SCALE;
+    q[i] = pow(10.0, points / RATING_SPREAD);
+    i = i + 1;
+  }
+  i = 0;
+  while (i < n) {
+    double score = 0;
+    double expected = 0;
+    int j = 0;
+    while (j < n) {
+      if (j != i) {
+        if (g->places[i] < g->places[j]) {
+          score = score + 1;
+        } else if (g->places[i] == g->places[j]) {
+          score = score + 0.5;
+        }
+        expected = expected + q[i] / (q[i] + q[j]);
+      }
+      j = j + 1;
+    }
+    changes[i] = (int)lround(RATING_K * RATING_SCALE * (score - expected) /
+                             (n - 1));
+    i = i + 1;
+  }
+  i = 0;
+  while (i < n) {
+    t->ratings[slots[i]] = t->ratings[slots[i]] + changes[i];
+    t->num_games[slots[i]] = t->num_games[slots[i]] + 1;
+    i = i + 1;
+  }
+}
+
+/**
+ * @brief Rates a range of the games of a batch.
+ */
+static void apply_games(const RatingJob *job) {
+  int changes[MAX_NUM_PLAYERS];
+  int i = job->first;
+  while (i < job->last) {
+    const int game = job->order[i];
+    apply_game(job->table, &job->games[game],
+               &job->slots[game * MAX_NUM_PLAYERS], changes);
+    i = i + 1;
+  }
+}
+
+/**
+ * @brief The body of a thread rating a part of a round.
+ */
+static DWORD WINAPI rate_part(LPVOID arg) {
+  apply_games((const RatingJob *)arg);
+  return 0;
+}
+
+/**
+ * @brief Rates the games of a round, split among threads if there are enough
+ *        of them.
+ */
+static void rate_round(RatingJob jobs[], const int num_threads,
+                       const int first, const int last) {
+  const int num_games = last - first;
+  if (num_games < RATING_MIN_PARALLEL_GAMES) {
+    jobs[0].first = first;
+    jobs[0].last = last;
+    apply_games(&jobs[0]);
+    return;
+  }
+  int i = 0;
+  while (i < num_threads) {
+    jobs[i].first = first + num_games * i / num_threads;
+    jobs[i].last = first + num_games * (i + 1) / num_threads;
+    jobs[i].thread = CreateThread(NULL, 0, rate_part, &jobs[i], 0, NULL);
+    // a part whose thread can not be started is rated by this one instead
+    if (!jobs[i].thread) {
+      apply_games(&jobs[i]);
+    }
+    i = i + 1;
+  }
+  i = 0;
+  while (i < num_threads) {
+    if (jobs[i].thread) {
+      WaitForSingleObject(jobs[i].thread, INFINITE);
+      CloseHandle(jobs[i].thread);
+      jobs[i].thread = NULL;
+    }
+    i = i + 1;
+  }
+}
+
+/**
+ * @brief Puts the games of a batch in order of round, each game going to the
+ *        round after the last one of any of its players.
+ *
+ * @return The number of rounds.
+ */
+static int order_rounds(const RatingTable *t, const GameOutcome games[],
+                        const int num_games, const int slots[], int order[],
+                        int starts[]) {
+  int *rounds = (int *)malloc((num_games + 1) * sizeof(int));  // NOLINT
+  int *last = (int *)malloc((t->num_players + 1) * sizeof(int));  // NOLINT
+  if (!rounds || !last) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  memset(last, 0xFF, t->num_players * sizeof(int));
+  int num_rounds = 0;
+  int g = 0;
+  while (g < num_games) {
+    const int *s = &slots[g * MAX_NUM_PLAYERS];
+    int round = 0;
+    int i = 0;
+    while (i < games[g].num_players) {
+      if (last[s[i]] + 1 > round) {
+        round = last[s[i]] + 1;
+      }
+      i = i + 1;
+    }
+    i = 0;
+    while (i < games[g].num_players) {
+      last[s[i]] = round;
+      i = i + 1;
+    }
+    rounds[g] = round;
+    if (round + 1 > num_rounds) {
+      num_rounds = round + 1;
+    }
+    g = g + 1;
+  }
+  free(last);
+
+  // a counting sort keeps the games of a round in the order given
+  memset(starts, 0, (num_rounds + 1) * sizeof(int));
+  g = 0;
+  while (g < num_games) {
+    starts[rounds[g] + 1] = starts[rounds[g] + 1] + 1;
+    g = g + 1;
+  }
+  int r = 0;
+  while (r < num_rounds) {
+    starts[r + 1] = starts[r + 1] + starts[r];
+    r = r + 1;
+  }
+  int *next = (int *)malloc((num_rounds + 1) * sizeof(int));  // NOLINT
+  if (!next) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  memcpy(next, starts, num_rounds * sizeof(int));
+  g = 0;
+  while (g < num_games) {
+    order[next[rounds[g]]] = g;
+    next[rounds[g]] = next[rounds[g]] + 1;
+    g = g + 1;
+  }
+  free(next);
+  free(rounds);
+  return num_rounds;
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+RatingTable *new_rating_table(void) {
+  logger.enter_fn(__func__);
+
+  RatingTable *t = (RatingTable *)malloc(sizeof(RatingTable));  // NOLINT
+  if (!t) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  t->index = new_name_index();
+  t->capacity = RATING_INITIAL_CAPACITY;
+  t->keys = (unsigned *)malloc(t->capacity * sizeof(unsigned));  // NOLINT
+  t->ratings = (int *)malloc(t->capacity * sizeof(int));         // NOLINT
+  t->num_games = (int *)malloc(t->capacity * sizeof(int));       // NOLINT
+  if (!t->keys || !t->ratings || !t->num_games) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  t->num_players = 0;
+
+  logger.exit_fn();
+  return t;
+}
+
+void free_rating_table(RatingTable *t) {
+  if (!t) {
+    return;
+  }
+  free_name_index(t->index);
+  free(t->keys);
+  free(t->ratings);
+  free(t->num_games);
+  free(t);
+}
+
+int add_rated_player(RatingTable *t, const unsigned key) {
+  int slot;
+  if (find_name(t->index, key, &slot)) {
+    return slot;
+  }
+  if (t->num_players == t->capacity) {
+    grow_rating_table(t);
+  }
+  slot = t->num_players;
+  t->keys[slot] = key;
+  t->ratings[slot] = RATING_INITIAL;
+  t->num_games[slot] = 0;
+  t->num_players = t->num_players + 1;
+  put_name(t->index, key, slot);
+  return slot;
+}
+
+int get_rating(const RatingTable *t, const unsigned key) {
+  int slot;
+  if (!find_name(t->index, key, &slot)) {
+    return RATING_INITIAL;
+  }
+  return t->ratings[slot];
+}
+
+int get_rated_games(const RatingTable *t, const unsigned key) {
+  int slot;
+  if (!find_name(t->index, key, &slot)) {
+    return 0;
+  }
+  return t->num_games[slot];
+}
+
+void rate_game(RatingTable *t, const GameOutcome *g, int changes[]) {
+  int slots[MAX_NUM_PLAYERS];
+  int i = 0;
+  while (i < g->num_players) {
+    slots[i] = add_rated_player(t, g->keys[i]);
+    i = i + 1;
+  }
+  int ignored[MAX_NUM_PLAYERS];
+  apply_game(t, g, slots, changes ? changes : ignored);
+}
+
+void rate_games(RatingTable *t, const GameOutcome games[],
+                const int num_games) {
+  logger.enter_fn(__func__);
+
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int num_threads = info.dwNumberOfProcessors;
+  if (num_threads > RATING_THREADS) {
+    num_threads = RATING_THREADS;
+  }
+
+  // every player is added first, so that the table does not move while the
+  // threads rate the games
+  int *slots = (int *)malloc(  // NOLINT
+      (num_games * MAX_NUM_PLAYERS + 1) * sizeof(int));
+  int *order = (int *)malloc((num_games + 1) * sizeof(int));  // NOLINT
+  // there are never more rounds than games
+  int *starts = (int *)malloc((num_games + 2) * sizeof(int));  // NOLINT
+  if (!slots || !order || !starts) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int g = 0;
+  while (g < num_games) {
+    int i = 0;
+    while (i < games[g].num_players) {
+      slots[g * MAX_NUM_PLAYERS + i] = add_rated_player(t, games[g].keys[i]);
+      i = i + 1;
+    }
+    g = g + 1;
+  }
+  // with a single processor the games are rated in the order given, which
+  // reads the table in the same order as the games
+  int num_rounds = 1;
+  if (num_threads > 1) {
+    num_rounds = order_rounds(t, games, num_games, slots, order, starts);
+  } else {
+    g = 0;
+    while (g < num_games) {
+      order[g] = g;
+      g = g + 1;
+    }
+    starts[0] = 0;
+    starts[1] = num_games;
+  }
+
+  RatingJob jobs[RATING_THREADS];
+  int i = 0;
+  while (i < RATING_THREADS) {
+    jobs[i].table = t;
+    jobs[i].games = games;
+    jobs[i].slots = slots;
+    jobs[i].order = order;
+    jobs[i].thread = NULL;
+    i = i + 1;
+  }
+  int r = 0;
+  while (r < num_rounds) {
+    rate_round(jobs, num_threads, starts[r], starts[r + 1]);
+    r = r + 1;
+  }
+  free(slots);
+  free(order);
+  free(starts);
+  logger.log("rated %i games in %i rounds", num_games, num_rounds);
+
+  logger.exit_fn();
+}
+
+unsigned char *encode_ratings(unsigned char *cursor, const RatingTable *t,
+                              const int slots[], const int count) {
+  int i = 0;
+  while (i < count) {
+    cursor = write_i32(cursor, t->keys[slots[i]]);
+    cursor = write_i32(cursor, t->ratings[slots[i]]);
+    cursor = write_i32(cursor, t->num_games[slots[i]]);
+    i = i + 1;
+  }
+  return cursor;
+}
+
+int are_ratings_valid(const unsigned char data[], const int size) {
+  if (size % RATING_ENTRY_SIZE != 0) {
+    return FALSE;
+  }
+  // a packed name takes no more than MAX_USERNAME_LENGTH bytes
+  int i = 0;
+  while (i < size) {
+    const unsigned key = (unsigned)read_i32(data + i);
+    if (key >> (8 * MAX_USERNAME_LENGTH) != 0 || read_i32(data + i + 8) < 0) {
+      return FALSE;
+    }
+    i = i + RATING_ENTRY_SIZE;
+  }
+  return TRUE;
+}
+
+int decode_ratings(const unsigned char data[], const int size,
+                   RatingTable *t) {
+  if (!are_ratings_valid(data, size)) {
+    return FALSE;
+  }
+  int i = 0;
+  while (i < size) {
+    const int slot = add_rated_player(t, (unsigned)read_i32(data + i));
+    t->ratings[slot] = read_i32(data + i + 4);
+    t->num_games[slot] = read_i32(data + i + 8);
+    i = i + RATING_ENTRY_SIZE;
+  }
+  return TRUE;
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include "../inc/rng.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+void seed_rng(Rng *rng, const unsigned long long seed,
+              const unsigned long long stream) {
+  rng->state = 0;
+  rng->inc = stream << 1 | 1;
+  next_rng(rng);
+  rng->state = rng->state + seed;
+  next_rng(rng);
+}
+
+unsigned next_rng(Rng *rng) {
+  const unsigned long long old = rng->state;
+  rng->state = old * RNG_MULTIPLIER + rng->inc;
+
+  const unsigned xorshifted = (unsigned)(((old >> 18) ^ old) >> 27);
+  const unsigned rot = (unsigned)(old >> 59);
+  return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+int next_rng_below(Rng *rng, const int bound) {
+  // the lowest numbers are rejected so that the rest is a multiple of bound
+  const unsigned threshold = (0u - (unsigned)bound) % (unsigned)bound;
+  unsigned number;
+  do {
+    number = next_rng(rng);
+  } while (number < threshold);
+  return number % (unsigned)bound;
+}
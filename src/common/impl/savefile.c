@@ -0,0 +1,923 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../inc/bytes.h"
+#include "../inc/codec.h"
+#include "../inc/crc.h"
+#include "../inc/error.h"
+#include "../inc/iopool.h"
+#include "../inc/journal.h"
+#include "../inc/legacy.h"
+#include "../inc/logger.h"
+#include "../inc/string.h"
+
+#include "../inc/savefile.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A save as it is written to the index of the file.
+ *
+ * Saves already in a file are copied as they are when the file is written
+ * again, without decoding them.
+ */
+typedef struct SaveEntry {
+  const unsigned char *summary;  ///< The bytes of the summary.
+  int summary_size;              ///< The size in bytes of the summary.
+  const unsigned char *record;   ///< The bytes of the full record.
+  int record_offset;             ///< The offset of the record in the file.
+  int record_size;               ///< The size in bytes of the full record.
+  unsigned summary_crc;          ///< The checksum of the summary.
+  unsigned record_crc;           ///< The checksum of the full record.
+} SaveEntry;
+
+/*
+ * summaries describe a game with fixed size players, so that they can be read
+ * in place. The helpers below read the fields from the start of the
+ * description.
+ */
+
+/**
+ * @brief Gets the number of players of a game description.
+ */
+static int game_players_num(const unsigned char *game) {
+  return game[2 + read_u16(game)];
+}
+
+/**
+ * @brief Gets the offset of the first player of a game description.
+ */
+static int game_players_offset(const unsigned char *game) {
+  return 2 + read_u16(game) + 1;
+}
+
+/**
+ * @brief Gets the offset of the dimension of a game description.
+ */
+static int game_dim_offset(const unsigned char *game, const int player_size) {
+  return game_players_offset(game) + game_players_num(game) * player_size;
+}
+
+/**
+ * @brief Checks that the fields of a game description fit inside it.
+ *
+ * @return The offset right after the dimension, or @c -1 if the description is
+ *         malformed.
+ */
+static int check_game(const unsigned char *game, const int size,
+                      const int player_size) {
+  if (size < 2 || size < game_players_offset(game)) {
+    return -1;
+  }
+  if (game_players_num(game) > MAX_NUM_PLAYERS ||
+      size < game_dim_offset(game, player_size) + 1) {
+    return -1;
+  }
+
+  const int dim = game[game_dim_offset(game, player_size)];
+  if (dim < MIN_NUM_SQUARES || dim > MAX_NUM_SQUARES) {
+    return -1;
+  }
+  return game_dim_offset(game, player_size) + 1;
+}
+
+/**
+ * @brief Gets the description of the game inside a summary.
+ */
+static const unsigned char *summary_game(const SaveSummary *sum) {
+  return sum->data + SAVE_SUMMARY_TIMES_SIZE;
+}
+
+/**
+ * @brief Computes the checksum of a summary, skipping its timestamps.
+ */
+static unsigned summary_crc(const unsigned char summary[], const int size) {
+  return crc32c(summary + SAVE_SUMMARY_TIMES_SIZE,
+                size - SAVE_SUMMARY_TIMES_SIZE);
+}
+
+/**
+ * @brief Gets the entry of a save in the offset table.
+ *
+ * @param[in] sf       The save file.
+ * @param[in] position The position of the entry in the table, which differs
+ *                     from the position of the save if corrupted saves have
+ *                     been skipped.
+ */
+static const unsigned char *table_entry(const SaveFile *sf,
+                                        const int position) {
+  return sf->data + sf->index_offset + position * SAVE_TABLE_ENTRY_SIZE;
+}
+
+/**
+ * @brief Gets the entry of a valid save in the offset table.
+ */
+static const unsigned char *save_entry(const SaveFile *sf, const int index) {
+  return table_entry(sf, sf->saves[index]);
+}
+
+/**
+ * @brief Checks that the index given by the header of a file fits inside it.
+ */
+static int is_index_in_file(const int size, const int num_entries,
+                            const int index_offset, const int index_size) {
+  return index_offset >= SAVE_HEADER_SIZE && index_offset <= size &&
+         index_size >= 0 && index_size <= size - index_offset &&
+         num_entries >= 0 && num_entries <= index_size / SAVE_TABLE_ENTRY_SIZE;
+}
+
+/**
+ * @brief Checks that the summary and the record of an entry of the offset
+ *        table fit inside the file, the summary inside the index.
+ */
+static int is_entry_in_file(const unsigned char entry[], const int size,
+                            const int index_offset, const int index_size) {
+  const unsigned index_end = index_offset + index_size;
+  const unsigned sum_offset = (unsigned)read_i32(entry);
+  const unsigned sum_size = (unsigned)read_i32(entry + 4);
+  const unsigned rec_offset = (unsigned)read_i32(entry + 8);
+  const unsigned rec_size = (unsigned)read_i32(entry + 12);
+  return sum_offset >= (unsigned)index_offset && sum_offset <= index_end &&
+         sum_size <= index_end - sum_offset && rec_offset <= (unsigned)size &&
+         rec_size <= (unsigned)size - rec_offset;
+}
+
+/**
+ * @brief Checks that an entry of the offset table and its summary are valid.
+ *
+ * Records are not checked here since they are only read when a game is loaded.
+ */
+static int is_entry_valid(const SaveFile *sf, const int position) {
+  const unsigned char *entry = table_entry(sf, position);
+  if (!is_entry_in_file(entry, sf->size, sf->index_offset, sf->index_size)) {
+    logger.log("save %i out of the file", position);
+    return FALSE;
+  }
+  const unsigned sum_offset = (unsigned)read_i32(entry);
+  const unsigned sum_size = (unsigned)read_i32(entry + 4);
+
+  const unsigned char *summary = sf->data + sum_offset;
+  if (sum_size < SAVE_SUMMARY_TIMES_SIZE ||
+      summary_crc(summary, sum_size) != (unsigned)read_i32(entry + 16)) {
+    logger.log("summary %i does not match its checksum", position);
+    return FALSE;
+  }
+  if (check_game(summary + SAVE_SUMMARY_TIMES_SIZE,
+                 sum_size - SAVE_SUMMARY_TIMES_SIZE,
+                 SAVE_SUMMARY_PLAYER_SIZE) !=
+      (int)sum_size - SAVE_SUMMARY_TIMES_SIZE) {
+    logger.log("summary %i is malformed", position);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Checks the header and the offset table of a file, and lists the
+ *        positions of its valid saves.
+ *
+ * @return @c FALSE if the header is not valid, since no save can be found
+ *         then, @c TRUE otherwise, even if some saves have been skipped.
+ */
+static int is_save_file_valid(SaveFile *sf) {
+  sf->num_saves = 0;
+  sf->num_corrupted = 0;
+  if (sf->size == 0) {
+    sf->index_offset = 0;
+    sf->index_size = 0;
+    return TRUE;
+  }
+  if (sf->size < SAVE_HEADER_SIZE ||
+      memcmp(sf->data, SAVE_MAGIC, SAVE_MAGIC_LEN) != 0) {
+    logger.log("not a save file");
+    return FALSE;
+  }
+  if (read_u16(sf->data + SAVE_MAGIC_LEN) != SAVE_VERSION) {
+    logger.log("unsupported version %i", read_u16(sf->data + SAVE_MAGIC_LEN));
+    return FALSE;
+  }
+
+  const int num_entries = read_i32(sf->data + SAVE_MAGIC_LEN + 4);
+  sf->index_offset = read_i32(sf->data + SAVE_MAGIC_LEN + 8);
+  sf->index_size = read_i32(sf->data + SAVE_MAGIC_LEN + 12);
+  if (!is_index_in_file(sf->size, num_entries, sf->index_offset,
+                        sf->index_size)) {
+    logger.log("index out of the file");
+    return FALSE;
+  }
+
+  sf->saves = (int *)malloc((num_entries + 1) * sizeof(int));  // NOLINT
+  if (!sf->saves) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < num_entries) {
+    if (is_entry_valid(sf, i)) {
+      sf->saves[sf->num_saves] = i;
+      sf->num_saves = sf->num_saves + 1;
+    } else {
+      sf->num_corrupted = sf->num_corrupted + 1;
+    }
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief Hashes a name with the FNV-1a function.
+ */
+static unsigned hash_name(const char name[], const int len) {
+  unsigned hash = 2166136261u;
+  int i = 0;
+  while (i < len) {
+    hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    i = i + 1;
+  }
+  return hash;
+}
+
+/**
+ * @brief Builds the hash table of the names of the saves of a file.
+ *
+ * The table uses open addressing with linear probing, and it is never more
+ * than half full so that probes stay short.
+ */
+static void build_name_index(SaveFile *sf) {
+  sf->names_capacity = 1;
+  while (sf->names_capacity < 2 * sf->num_saves) {
+    sf->names_capacity = sf->names_capacity * 2;
+  }
+  sf->names = (int *)malloc(sf->names_capacity * sizeof(int));  // NOLINT
+  if (!sf->names) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  memset(sf->names, 0xFF, sf->names_capacity * sizeof(int));  // all empty
+
+  const unsigned mask = sf->names_capacity - 1;
+  int i = 0;
+  while (i < sf->num_saves) {
+    const SaveSummary sum = get_summary(sf, i);
+    unsigned slot = hash_name(get_summary_name(&sum),
+                              get_summary_name_len(&sum)) & mask;
+    while (sf->names[slot] != SAVE_NOT_FOUND) {
+      slot = (slot + 1) & mask;
+    }
+    sf->names[slot] = i;  // a later duplicate is never reached by a lookup
+    i = i + 1;
+  }
+}
+
+SaveFile *open_save_file(const char path[]) {
+  logger.enter_fn(__func__);
+  logger.log("attempting to map save file '%s'", path);
+
+  wait_file_io(path);
+  SaveFile *sf = (SaveFile *)malloc(sizeof(SaveFile));  // NOLINT
+  if (!sf) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  sf->data = NULL;
+  sf->mapping = NULL;
+  sf->saves = NULL;
+
+  sf->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  LARGE_INTEGER file_size;
+  if (sf->file == INVALID_HANDLE_VALUE ||
+      !GetFileSizeEx(sf->file, &file_size) || file_size.QuadPart > INT_MAX) {
+    logger.log("file is not readable");
+    logger.stop();
+    throw_err(FILE_NOT_READABLE_ERROR);
+  }
+  sf->size = (int)file_size.QuadPart;
+
+  // an empty file can not be mapped, but it is a valid file without saves
+  if (sf->size > 0) {
+    sf->mapping = CreateFileMappingA(sf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (sf->mapping) {
+      sf->data = (const unsigned char *)MapViewOfFile(sf->mapping,
+                                                      FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!sf->data) {
+      logger.log("file can not be mapped");
+      logger.stop();
+      throw_err(FILE_NOT_READABLE_ERROR);
+    }
+  }
+
+  if (!is_save_file_valid(sf)) {
+    logger.stop();
+    throw_err(CORRUPTED_SAVES_ERROR);
+  }
+  build_name_index(sf);
+  logger.log("mapped %i bytes, %i saves, %i corrupted", sf->size,
+             sf->num_saves, sf->num_corrupted);
+
+  logger.exit_fn();
+  return sf;
+}
+
+void close_save_file(SaveFile *sf) {
+  if (sf->data) {
+    UnmapViewOfFile(sf->data);
+  }
+  if (sf->mapping) {
+    CloseHandle(sf->mapping);
+  }
+  CloseHandle(sf->file);
+  free(sf->saves);
+  free(sf->names);
+  free(sf);
+}
+
+int find_save(const SaveFile *sf, const char name[]) {
+  const int len = strlen(name);
+  const unsigned mask = sf->names_capacity - 1;
+  unsigned slot = hash_name(name, len) & mask;
+  while (sf->names[slot] != SAVE_NOT_FOUND) {
+    const SaveSummary sum = get_summary(sf, sf->names[slot]);
+    if (get_summary_name_len(&sum) == len &&
+        memcmp(get_summary_name(&sum), name, len) == 0) {
+      return sf->names[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+  return SAVE_NOT_FOUND;
+}
+
+SaveSummary get_summary(const SaveFile *sf, const int index) {
+  const unsigned char *entry = save_entry(sf, index);
+  SaveSummary sum;
+  sum.data = sf->data + read_i32(entry);
+  sum.size = read_i32(entry + 4);
+  return sum;
+}
+
+time_t get_summary_timestamp(const SaveSummary *sum) {
+  return read_time(sum->data);
+}
+
+time_t get_summary_last_used(const SaveSummary *sum) {
+  return read_time(sum->data + SAVE_TIMESTAMP_SIZE);
+}
+
+const char *get_summary_name(const SaveSummary *sum) {
+  return (const char *)summary_game(sum) + 2;
+}
+
+int get_summary_name_len(const SaveSummary *sum) {
+  return read_u16(summary_game(sum));
+}
+
+int get_summary_players_num(const SaveSummary *sum) {
+  return game_players_num(summary_game(sum));
+}
+
+const char *get_summary_username(const SaveSummary *sum, const int player) {
+  const unsigned char *game = summary_game(sum);
+  return (const char *)game + game_players_offset(game) +
+         player * SAVE_SUMMARY_PLAYER_SIZE;
+}
+
+int get_summary_position(const SaveSummary *sum, const int player) {
+  const unsigned char *username =
+      (const unsigned char *)get_summary_username(sum, player);
+  return read_i32(username + MAX_USERNAME_LENGTH);
+}
+
+int get_summary_dim(const SaveSummary *sum) {
+  const unsigned char *game = summary_game(sum);
+  return game[game_dim_offset(game, SAVE_SUMMARY_PLAYER_SIZE)];
+}
+
+int is_record_valid(const SaveRecord *rec) {
+  GameState gs;
+  return decode_game(rec->data, rec->size, &gs);
+}
+
+int get_record(const SaveFile *sf, const int index, SaveRecord *rec) {
+  logger.enter_fn(__func__);
+
+  const unsigned char *entry = save_entry(sf, index);
+  rec->data = sf->data + read_i32(entry + 8);
+  rec->size = read_i32(entry + 12);
+
+  // the record is only checked now that it is actually needed
+  if (crc32c(rec->data, rec->size) != (unsigned)read_i32(entry + 20)) {
+    logger.log("record %i does not match its checksum", index);
+    logger.exit_fn();
+    return FALSE;
+  }
+  if (!is_record_valid(rec)) {
+    logger.log("record %i is malformed", index);
+    logger.exit_fn();
+    return FALSE;
+  }
+
+  logger.exit_fn();
+  return TRUE;
+}
+
+void decode_record(const SaveRecord *rec, GameState *gs) {
+  logger.enter_fn(__func__);
+
+  decode_game(rec->data, rec->size, gs);
+  logger.log("decoded save '%s'", get_game_name(gs));
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Computes the size in bytes of the summary of a game.
+ */
+static int summary_size(GameState *gs) {
+  const Players pls = get_players(gs);
+  return SAVE_SUMMARY_TIMES_SIZE + 2 + strlen(get_game_name(gs)) + 1 +
+         get_players_num(&pls) * SAVE_SUMMARY_PLAYER_SIZE + 1;
+}
+
+/**
+ * @brief Encodes the summary of a game, without its timestamps, and advances
+ *        the cursor.
+ *
+ * Only the username and the position of each player are written, with a fixed
+ * size so that they can be read in place.
+ */
+static unsigned char *encode_summary(unsigned char *cursor, GameState *gs) {
+  Players pls = get_players(gs);
+  const Board board = get_board(gs);
+  const int name_len = strlen(get_game_name(gs));
+
+  cursor = write_u16(cursor, name_len);
+  cursor = (unsigned char *)str_put((char *)cursor, get_game_name(gs),
+                                    name_len);
+
+  *cursor = get_players_num(&pls);
+  cursor = cursor + 1;
+  int i = 0;
+  while (i < get_players_num(&pls)) {
+    const Player *pl = get_player(&pls, i);
+    // usernames are always padded to their maximum length
+    memset(cursor, STR_END, MAX_USERNAME_LENGTH);
+    memcpy(cursor, get_username(pl), strlen(get_username(pl)));
+    cursor = cursor + MAX_USERNAME_LENGTH;
+    cursor = write_i32(cursor, get_position(pl));
+    i = i + 1;
+  }
+
+  *cursor = get_dim(&board);
+  return cursor + 1;
+}
+
+int get_record_size(GameState *gs) { return get_game_size(gs); }
+
+unsigned char *encode_record(unsigned char *cursor, GameState *gs) {
+  return encode_game(cursor, gs);
+}
+
+/**
+ * @brief Encodes the summary and the record of a game.
+ *
+ * Both are allocated in a single buffer pointed by @c entry->summary, that
+ * must be freed by the caller. The game is marked as saved and last used at
+ * the given time.
+ *
+ * @return @c FALSE if the buffer can not be allocated, @c TRUE otherwise.
+ */
+static int encode_entry(GameState *gs, const time_t timestamp,
+                        SaveEntry *entry) {
+  entry->summary_size = summary_size(gs);
+  entry->record_size = get_game_size(gs);
+
+  unsigned char *buffer = (unsigned char *)malloc(  // NOLINT
+      entry->summary_size + entry->record_size);
+  if (!buffer) {
+    return FALSE;
+  }
+
+  unsigned char *cursor = write_time(buffer, timestamp);
+  cursor = write_time(cursor, timestamp);
+  cursor = encode_summary(cursor, gs);
+
+  entry->summary = buffer;
+  entry->record = cursor;
+  encode_game(cursor, gs);
+
+  entry->summary_crc = summary_crc(entry->summary, entry->summary_size);
+  entry->record_crc = crc32c(entry->record, entry->record_size);
+  return TRUE;
+}
+
+/**
+ * @brief Reads the entry of a save from the index of a mapped file.
+ */
+static SaveEntry read_entry(const SaveFile *sf, const int index) {
+  const unsigned char *table = save_entry(sf, index);
+  SaveEntry entry;
+  entry.summary = sf->data + read_i32(table);
+  entry.summary_size = read_i32(table + 4);
+  entry.record_offset = read_i32(table + 8);
+  entry.record = sf->data + entry.record_offset;
+  entry.record_size = read_i32(table + 12);
+  entry.summary_crc = read_i32(table + 16);
+  entry.record_crc = read_i32(table + 20);
+  return entry;
+}
+
+/**
+ * @brief Writes the header of a save file and advances the cursor.
+ */
+static unsigned char *write_header(unsigned char *cursor, const int num_saves,
+                                   const int index_offset,
+                                   const int index_size) {
+  cursor = (unsigned char *)str_put((char *)cursor, SAVE_MAGIC, SAVE_MAGIC_LEN);
+  cursor = write_u16(cursor, SAVE_VERSION);
+  cursor = write_u16(cursor, 0);  // reserved
+  cursor = write_i32(cursor, num_saves);
+  cursor = write_i32(cursor, index_offset);
+  return write_i32(cursor, index_size);
+}
+
+/**
+ * @brief Computes the size in bytes of the index of some saves.
+ */
+static int index_size(const SaveEntry entries[], const int num_saves) {
+  int size = num_saves * SAVE_TABLE_ENTRY_SIZE;
+  int i = 0;
+  while (i < num_saves) {
+    size = size + entries[i].summary_size;
+    i = i + 1;
+  }
+  return size;
+}
+
+/**
+ * @brief Writes the index of some saves and advances the cursor.
+ *
+ * @param[out] cursor       The position where the index is written.
+ * @param[in]  entries      The saves, with the offsets of their records.
+ * @param[in]  num_saves    The number of saves.
+ * @param[in]  index_offset The offset of the index in the file.
+ */
+static unsigned char *write_index(unsigned char *cursor,
+                                  const SaveEntry entries[],
+                                  const int num_saves, const int index_offset) {
+  // the summaries follow the table
+  char *summaries = (char *)cursor + num_saves * SAVE_TABLE_ENTRY_SIZE;
+  int summary_offset = index_offset + num_saves * SAVE_TABLE_ENTRY_SIZE;
+  int i = 0;
+  while (i < num_saves) {
+    cursor = write_i32(cursor, summary_offset);
+    cursor = write_i32(cursor, entries[i].summary_size);
+    cursor = write_i32(cursor, entries[i].record_offset);
+    cursor = write_i32(cursor, entries[i].record_size);
+    cursor = write_i32(cursor, entries[i].summary_crc);
+    cursor = write_i32(cursor, entries[i].record_crc);
+    summaries = str_put(summaries, (const char *)entries[i].summary,
+                        entries[i].summary_size);
+    summary_offset = summary_offset + entries[i].summary_size;
+    i = i + 1;
+  }
+  return (unsigned char *)summaries;
+}
+
+/**
+ * @brief Lays out a whole save file with no unused bytes.
+ *
+ * The records are laid out right after the header and the index after them.
+ *
+ * @return The content of the file, or @c NULL if it can not be allocated.
+ */
+static unsigned char *layout_compact(SaveEntry entries[], const int num_saves,
+                                     int *file_size) {
+  int records_size = 0;
+  int i = 0;
+  while (i < num_saves) {
+    records_size = records_size + entries[i].record_size;
+    i = i + 1;
+  }
+  const int index_offset = SAVE_HEADER_SIZE + records_size;
+  *file_size = index_offset + index_size(entries, num_saves);
+
+  unsigned char *buffer = (unsigned char *)malloc(*file_size);  // NOLINT
+  if (!buffer) {
+    return NULL;
+  }
+
+  unsigned char *cursor = buffer + SAVE_HEADER_SIZE;
+  i = 0;
+  while (i < num_saves) {
+    entries[i].record_offset = cursor - buffer;
+    cursor = (unsigned char *)str_put((char *)cursor,
+                                      (const char *)entries[i].record,
+                                      entries[i].record_size);
+    i = i + 1;
+  }
+  write_index(cursor, entries, num_saves, index_offset);
+  write_header(buffer, num_saves, index_offset, *file_size - index_offset);
+  return buffer;
+}
+
+/**
+ * @brief Lays out the content of a save file again with no unused bytes.
+ *
+ * It is run by a thread of the I/O pool (see iopool.h), so it does not log
+ * anything and leaves the file as it is if it can not be compacted.
+ *
+ * @return The compacted content, or @c NULL if the file is not valid or the
+ *         content can not be allocated.
+ */
+static unsigned char *compact_content(const unsigned char content[],
+                                      const int size, int *new_size) {
+  if (size < SAVE_HEADER_SIZE ||
+      memcmp(content, SAVE_MAGIC, SAVE_MAGIC_LEN) != 0 ||
+      read_u16(content + SAVE_MAGIC_LEN) != SAVE_VERSION) {
+    return NULL;
+  }
+  const int num_saves = read_i32(content + SAVE_MAGIC_LEN + 4);
+  const int index_offset = read_i32(content + SAVE_MAGIC_LEN + 8);
+  const int index_size = read_i32(content + SAVE_MAGIC_LEN + 12);
+  if (!is_index_in_file(size, num_saves, index_offset, index_size)) {
+    return NULL;
+  }
+
+  SaveEntry *entries =
+      (SaveEntry *)malloc((num_saves + 1) * sizeof(SaveEntry));  // NOLINT
+  if (!entries) {
+    return NULL;
+  }
+  // the index only lists the saves found valid when it was written
+  int i = 0;
+  while (i < num_saves) {
+    const unsigned char *table =
+        content + index_offset + i * SAVE_TABLE_ENTRY_SIZE;
+    if (!is_entry_in_file(table, size, index_offset, index_size)) {
+      free(entries);
+      return NULL;
+    }
+    entries[i].summary = content + read_i32(table);
+    entries[i].summary_size = read_i32(table + 4);
+    entries[i].record = content + read_i32(table + 8);
+    entries[i].record_size = read_i32(table + 12);
+    entries[i].summary_crc = read_i32(table + 16);
+    entries[i].record_crc = read_i32(table + 20);
+    i = i + 1;
+  }
+  unsigned char *buffer = layout_compact(entries, num_saves, new_size);
+  free(entries);
+  return buffer;
+}
+
+unsigned char *layout_save_file(GameState games[], const int num_games,
+                                const time_t timestamp, int *size) {
+  SaveEntry entries[MAX_SAVED_GAMES];
+  int num_encoded = 0;
+  while (num_encoded < num_games &&
+         encode_entry(&games[num_encoded], timestamp, &entries[num_encoded])) {
+    num_encoded = num_encoded + 1;
+  }
+
+  unsigned char *buffer = NULL;
+  if (num_encoded == num_games) {
+    buffer = layout_compact(entries, num_games, size);
+  }
+
+  int i = 0;
+  while (i < num_encoded) {
+    free((void *)entries[i].summary);
+    i = i + 1;
+  }
+  return buffer;
+}
+
+/**
+ * @brief Appends a record and a new index to a save file.
+ *
+ * The other records are left untouched. The header is written last, so that
+ * it keeps pointing to the previous index until the new one is complete.
+ *
+ * @param[in] path         The path of the save file.
+ * @param[in] appended     The save whose record is appended at @c end.
+ * @param[in] num_saves    The number of saves in the new index.
+ * @param[in] end          The offset of the end of the file.
+ * @param[in] index        The new index, laid out in memory.
+ * @param[in] size         The size in bytes of the new index.
+ * @param[in] is_compacted Whether the file is then compacted by the I/O pool.
+ *
+ * @return The handle of the write, queued to the I/O pool.
+ */
+static IoRequest *write_appended(const char path[],
+                                 const SaveEntry *appended,
+                                 const int num_saves, const int end,
+                                 const unsigned char index[], const int size,
+                                 const int is_compacted) {
+  logger.enter_fn(__func__);
+
+  unsigned char *buffer = (unsigned char *)malloc(  // NOLINT
+      2 * SAVE_HEADER_SIZE + appended->record_size + size);
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  IoSegment segments[IO_MAX_SEGMENTS];
+  int num_segments = 0;
+  unsigned char *cursor = buffer;
+  if (end == SAVE_HEADER_SIZE) {
+    // a new file, the header of an empty file keeps it valid until the end
+    cursor = write_header(cursor, 0, SAVE_HEADER_SIZE, 0);
+    segments[num_segments].offset = 0;
+    segments[num_segments].size = SAVE_HEADER_SIZE;
+    num_segments = num_segments + 1;
+  }
+
+  cursor = (unsigned char *)str_put((char *)cursor,
+                                    (const char *)appended->record,
+                                    appended->record_size);
+  cursor = (unsigned char *)str_put((char *)cursor, (const char *)index, size);
+  segments[num_segments].offset = end;
+  segments[num_segments].size = appended->record_size + size;
+  num_segments = num_segments + 1;
+
+  write_header(cursor, num_saves, end + appended->record_size, size);
+  segments[num_segments].offset = 0;
+  segments[num_segments].size = SAVE_HEADER_SIZE;
+  num_segments = num_segments + 1;
+
+  IoRequest *req =
+      is_compacted
+          ? submit_rewrite(path, buffer, segments, num_segments,
+                           compact_content)
+          : submit_write(path, buffer, segments, num_segments);
+
+  logger.log("appending %i bytes to '%s'", appended->record_size + size, path);
+  logger.exit_fn();
+  return req;
+}
+
+IoRequest *put_save(const char path[], GameState *gs, const int index) {
+  logger.enter_fn(__func__);
+
+  SaveFile *sf = open_save_file(path);
+  const int num_saves =
+      index == sf->num_saves ? sf->num_saves + 1 : sf->num_saves;
+  logger.log("putting save '%s' at %i of %i", get_game_name(gs), index,
+             num_saves);
+
+  SaveEntry *entries =
+      (SaveEntry *)malloc(num_saves * sizeof(SaveEntry));  // NOLINT
+  if (!entries) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  // the other saves are copied from the mapped file without decoding them
+  int live_size = SAVE_HEADER_SIZE;
+  int i = 0;
+  while (i < sf->num_saves) {
+    entries[i] = read_entry(sf, i);
+    live_size = live_size + entries[i].record_size;
+    i = i + 1;
+  }
+  if (!encode_entry(gs, time(NULL), &entries[index])) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  if (index < sf->num_saves) {
+    live_size = live_size - read_entry(sf, index).record_size;
+  }
+  live_size = live_size + entries[index].record_size;
+
+  const int end = sf->size > 0 ? sf->size : SAVE_HEADER_SIZE;
+  entries[index].record_offset = end;
+  const int size = index_size(entries, num_saves);
+  live_size = live_size + size;
+
+  // when too many bytes are taken by replaced records and old indexes, the
+  // file is compacted by the I/O pool right after the append, so that the
+  // game does not wait for the whole file to be copied
+  const int is_compacted =
+      end + entries[index].record_size + size > SAVE_COMPACT_RATIO * live_size;
+  if (is_compacted) {
+    logger.log("compacting %i bytes into %i", sf->size, live_size);
+  }
+
+  // the index is laid out before the file is unmapped
+  unsigned char *buffer = (unsigned char *)malloc(size + 1);  // NOLINT
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  write_index(buffer, entries, num_saves, end + entries[index].record_size);
+  close_save_file(sf);
+  IoRequest *req = write_appended(path, &entries[index], num_saves, end,
+                                  buffer, size, is_compacted);
+  free(buffer);
+
+  free((void *)entries[index].summary);
+  free(entries);
+
+  logger.exit_fn();
+  return req;
+}
+
+IoRequest *touch_save(const char path[], const int index) {
+  logger.enter_fn(__func__);
+
+  SaveFile *sf = open_save_file(path);
+  const IoSegment last_used = {
+      read_i32(save_entry(sf, index)) + SAVE_TIMESTAMP_SIZE,
+      SAVE_TIMESTAMP_SIZE};
+  close_save_file(sf);
+
+  // the time of last use has a fixed size, so it is updated in place
+  unsigned char *buffer =
+      (unsigned char *)malloc(SAVE_TIMESTAMP_SIZE);  // NOLINT
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  write_time(buffer, time(NULL));
+  IoRequest *req = submit_write(path, buffer, &last_used, 1);
+
+  logger.log("marking save %i as used", index);
+  logger.exit_fn();
+  return req;
+}
+
+int migrate_save_file(const char path[]) {
+  logger.enter_fn(__func__);
+  logger.log("checking if '%s' needs to be migrated", path);
+
+  wait_file_io(path);
+  LegacyFile lf;
+  if (!open_legacy(&lf, path)) {
+    logger.log("file is not readable");
+    logger.stop();
+    throw_err(FILE_NOT_READABLE_ERROR);
+  }
+  if (lf.kind != LEGACY_SAVES) {
+    close_legacy(&lf);
+    logger.exit_fn();
+    return FALSE;
+  }
+  if (!is_legacy_count_valid(&lf)) {
+    logger.log("legacy file has %i saves", lf.count);
+    logger.stop();
+    throw_err(CORRUPTED_SAVES_ERROR);
+  }
+
+  // legacy saves are read one at a time, and the invalid ones are left out
+  GameState games[MAX_SAVED_GAMES];
+  int num_games = 0;
+  int i = 0;
+  while (i < lf.count) {
+    const int outcome = next_legacy_game(&lf, &games[num_games]);
+    if (outcome == LEGACY_VALID) {
+      num_games = num_games + 1;
+    } else {
+      logger.log("skipping legacy save %i, problem %i", i, outcome);
+    }
+    i = i + 1;
+  }
+  close_legacy(&lf);
+  logger.log("migrating %i of %i legacy saves", num_games, lf.count);
+
+  char backup[MAX_BUFFER_LEN];
+  snprintf(backup, MAX_BUFFER_LEN, "%s%s", path, LEGACY_SAVES_SUFFIX);
+  remove(backup);
+  if (rename(path, backup)) {
+    logger.log("can not keep a backup in '%s'", backup);
+    logger.stop();
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+
+  // legacy saves do not know when they were saved
+  int size;
+  unsigned char *buffer =
+      layout_save_file(games, num_games, SAVE_NO_TIMESTAMP, &size);
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  finish_io(submit_replace(path, buffer, size));
+
+  logger.exit_fn();
+  return TRUE;
+}
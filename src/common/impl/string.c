@@ -45,6 +45,21 @@ void fconcat(char *buffer, const int source_size, const char format[], ...) {
   va_end(args);
 }
 
+char *str_put(char *cursor, const char source[], const int size) {
+  memcpy(cursor, source, size);
+  return cursor + size;
+}
+
+char *str_nput(char *cursor, const char source[], const int size,
+               const int n_times) {
+  int i = 0;
+  while (i < n_times) {
+    cursor = str_put(cursor, source, size);
+    i = i + 1;
+  }
+  return cursor;
+}
+
 char *alloc_char(const char *s, const int size) {
   char *buffer = (char *)malloc(1 + size * strlen(s) * sizeof(s));  // NOLINT
   if (buffer == NULL) {
@@ -67,7 +82,7 @@ char *str_allocate(const int size) {
   logger.log("successfully allocated memory for string of size %i", size);
 
   // ensure null termination of the string
-  memset(buffer, STR_END, strlen(buffer));
+  memset(buffer, STR_END, 1 + size);
 
   logger.exit_fn();
   return buffer;
@@ -84,6 +99,19 @@ void str_truncate(char *buffer, const int len) {
   snprintf(buffer, len + 1, "%s", buffer);
 }
 
+int str_display_width(const char buffer[]) {
+  int width = 0;
+  int i = 0;
+  while (buffer[i] != STR_END) {
+    // continuation bytes of a multi-byte character are in the form 10xxxxxx
+    if ((buffer[i] & 0xC0) != 0x80) {
+      width = width + 1;
+    }
+    i = i + 1;
+  }
+  return width;
+}
+
 void str_to_uppercase(char buffer[]) {
   logger.enter_fn(__func__);
   logger.log("uppercasing '%s'", buffer);
@@ -35,6 +35,16 @@ void get_term_size(int *width, int *height) {
   logger.exit_fn();
 }
 
+void use_utf8_output(void) {
+  logger.enter_fn(__func__);
+
+  if (!SetConsoleOutputCP(CP_UTF8)) {
+    logger.log("console code page not changed");
+  }
+
+  logger.exit_fn();
+}
+
 void clear_screen() {
   logger.enter_fn(__func__);
 
@@ -131,6 +141,62 @@ void new_screen() {
   logger.exit_fn();
 }
 
+void start_screen(ScreenBuffer *sb) {
+  logger.enter_fn(__func__);
+
+  int term_width, term_heigth;
+  get_term_size(&term_width, &term_heigth);
+  const int title_len = strlen(TITLE_BAR) - 1;
+  const int left_space = 1 + (term_width - title_len - 1) / 2;
+
+  sb->len = 0;
+  screen_line(sb, "%s%*c%.*s", CURSOR_HOME, left_space, SPACE_CHAR,
+              title_len, TITLE_BAR);
+  // the separator fills the whole line, so it needs no erasing
+  int i = 0;
+  while (i < term_width && sb->len < SCREEN_BUFFER_LEN - 1) {
+    sb->text[sb->len] = '-';
+    sb->len = sb->len + 1;
+    i = i + 1;
+  }
+  screen_line(sb, "");
+
+  logger.exit_fn();
+}
+
+void screen_line(ScreenBuffer *sb, const char format[], ...) {
+  // room is kept for the erasing sequences and the newline
+  const int reserved = strlen(ERASE_LINE_END) + strlen(ERASE_BELOW) + 1;
+  const int room = SCREEN_BUFFER_LEN - sb->len - reserved;
+  if (room <= 0) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  const int len = vsnprintf(sb->text + sb->len, room, format, args);
+  va_end(args);
+  if (len > 0) {
+    sb->len = sb->len + (len < room ? len : room - 1);
+  }
+  char *cursor = str_put(sb->text + sb->len, ERASE_LINE_END,
+                         strlen(ERASE_LINE_END));
+  *cursor = '\n';
+  sb->len = cursor + 1 - sb->text;
+}
+
+void flush_screen(ScreenBuffer *sb) {
+  logger.enter_fn(__func__);
+
+  char *cursor = str_put(sb->text + sb->len, ERASE_BELOW, strlen(ERASE_BELOW));
+  sb->len = cursor - sb->text;
+  fwrite(sb->text, 1, sb->len, stdout);
+  fflush(stdout);
+  logger.log("drew %i bytes", sb->len);
+  sb->len = 0;
+
+  logger.exit_fn();
+}
+
 void print_menu(const char filename[]) {
   logger.enter_fn(__func__);
   new_screen();
@@ -251,6 +317,15 @@ int is_quit_key(const char key) {
   return FALSE;
 }
 
+int read_key(void) {
+  const int key = _getch();
+  // the arrows and the page keys are sent as a prefix followed by their code
+  if (key == 0 || key == 0xE0) {
+    return EXTENDED_KEYS + _getch();
+  }
+  return key;
+}
+
 void wait_keypress(const char format[], ...) {
   logger.enter_fn(__func__);
 
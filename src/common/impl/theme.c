@@ -0,0 +1,84 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/logger.h"
+#include "../inc/string.h"
+
+#include "../inc/theme.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The registry of the available themes.
+ *
+ * Sizes and widths start at zero, they are filled by @c measure_themes().
+ */
+static BorderTheme themes[NUM_THEMES] = {
+    {"ascii", DEFAULT_BORDERS, {0}, {0}},
+    {"light", {"┌", "┐", "└", "┘", "┬", "┴", "─", "│"}, {0}, {0}},
+    {"heavy", {"┏", "┓", "┗", "┛", "┳", "┻", "━", "┃"}, {0}, {0}},
+    {"rounded", {"╭", "╮", "╰", "╯", "┬", "┴", "─", "│"}, {0}, {0}},
+    {"double", {"╔", "╗", "╚", "╝", "╦", "╩", "═", "║"}, {0}, {0}},
+};
+
+/**
+ * @brief Whether the sizes and widths of the themes have been computed.
+ */
+static int are_themes_measured = FALSE;
+
+/**
+ * @brief Computes the size in bytes and the display width of every border of
+ *        every theme.
+ */
+static void measure_themes() {
+  logger.enter_fn(__func__);
+  logger.log("measuring %i border themes", NUM_THEMES);
+
+  int i = 0;
+  while (i < NUM_THEMES) {
+    int j = 0;
+    while (j < NUM_BORDERS) {
+      themes[i].sizes[j] = strlen(themes[i].borders[j]);
+      themes[i].widths[j] = str_display_width(themes[i].borders[j]);
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+  are_themes_measured = TRUE;
+
+  logger.exit_fn();
+}
+
+const BorderTheme *get_theme(const char name[]) {
+  if (!are_themes_measured) {
+    measure_themes();
+  }
+
+  int i = 0;
+  while (i < NUM_THEMES) {
+    if (strcmp(themes[i].name, name) == 0) {
+      return &themes[i];
+    }
+    i = i + 1;
+  }
+  return NULL;
+}
+
+const BorderTheme *get_next_theme(const BorderTheme *theme) {
+  if (!are_themes_measured) {
+    measure_themes();
+  }
+  const int index = (theme - themes + 1) % NUM_THEMES;
+  return &themes[index];
+}
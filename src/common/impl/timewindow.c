@@ -0,0 +1,166 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <string.h>
+
+#include "../../inc/globals.h"
+
+#include "../inc/bytes.h"
+#include "../inc/merge.h"
+#include "../inc/string.h"
+#include "../inc/types/entry.h"
+
+#include "../inc/timewindow.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Inserts an entry into entries in order of rank, shifting the ones
+ *        after it.
+ *
+ * @return The number of entries after the insertion.
+ */
+static int insert_by_rank(Entry entries[], const int num_entries,
+                          const Entry *e) {
+  const unsigned long long key = rank_key(e);
+  int pos = num_entries;
+  while (pos > 0 && rank_key(&entries[pos - 1]) > key) {
+    entries[pos] = entries[pos - 1];
+    pos = pos - 1;
+  }
+  entries[pos] = *e;
+  return num_entries + 1;
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+int day_of(const time_t t) { return (int)(t / SECONDS_PER_DAY); }
+
+void clear_time_windows(TimeWindows *w) {
+  int i = 0;
+  while (i < WINDOW_DAYS) {
+    w->buckets[i].day = WINDOW_NO_DAY;
+    w->buckets[i].num_entries = 0;
+    i = i + 1;
+  }
+}
+
+int add_window_entry(TimeWindows *w, const int day, const Entry *e) {
+  TimeBucket *b = &w->buckets[day % WINDOW_DAYS];
+  if (day < b->day) {
+    return FALSE;
+  }
+  if (day > b->day) {
+    b->day = day;
+    b->num_entries = 0;
+  }
+
+  // the low half of the order of an entry is the packed name of its player
+  const unsigned long long key = rank_key(e);
+  int i = 0;
+  while (i < b->num_entries &&
+         (unsigned)rank_key(&b->entries[i]) != (unsigned)key) {
+    i = i + 1;
+  }
+  if (i < b->num_entries) {
+    if (rank_key(&b->entries[i]) <= key) {
+      return FALSE;
+    }
+    memmove(&b->entries[i], &b->entries[i + 1],
+            (b->num_entries - i - 1) * sizeof(Entry));
+    b->num_entries = b->num_entries - 1;
+  } else if (b->num_entries == WINDOW_TOP) {
+    if (rank_key(&b->entries[WINDOW_TOP - 1]) <= key) {
+      return FALSE;
+    }
+    b->num_entries = b->num_entries - 1;
+  }
+  b->num_entries = insert_by_rank(b->entries, b->num_entries, e);
+  return TRUE;
+}
+
+int get_window_entries(const TimeWindows *w, const int today,
+                       const int num_days, Entry entries[]) {
+  Entry candidates[WINDOW_DAYS * WINDOW_TOP];
+  int num_candidates = 0;
+  int d = 0;
+  while (d < num_days && today - d >= 0) {
+    const TimeBucket *b = &w->buckets[(today - d) % WINDOW_DAYS];
+    int i = 0;
+    while (b->day == today - d && i < b->num_entries) {
+      num_candidates =
+          insert_by_rank(candidates, num_candidates, &b->entries[i]);
+      i = i + 1;
+    }
+    d = d + 1;
+  }
+
+  // the first entry of a player has their best score, the others are dropped
+  int num_entries = 0;
+  int i = 0;
+  while (i < num_candidates && num_entries < WINDOW_TOP) {
+    const unsigned name = (unsigned)rank_key(&candidates[i]);
+    int j = 0;
+    while (j < num_entries && (unsigned)rank_key(&entries[j]) != name) {
+      j = j + 1;
+    }
+    if (j == num_entries) {
+      entries[num_entries] = candidates[i];
+      num_entries = num_entries + 1;
+    }
+    i = i + 1;
+  }
+  return num_entries;
+}
+
+unsigned char *encode_time_bucket(unsigned char *cursor, const TimeBucket *b) {
+  cursor = write_i32(cursor, b->day);
+  cursor[0] = b->num_entries;
+  cursor = cursor + 1;
+  int i = 0;
+  while (i < b->num_entries) {
+    const Entry *e = &b->entries[i];
+    // names are always padded to their maximum length
+    memset(cursor, STR_END, MAX_USERNAME_LENGTH);
+    memcpy(cursor, get_name(e), strlen(get_name(e)));
+    cursor = write_i32(cursor + MAX_USERNAME_LENGTH, get_final_score(e));
+    i = i + 1;
+  }
+  return cursor;
+}
+
+int decode_time_bucket(const unsigned char data[], const int size,
+                       TimeBucket *b) {
+  if (size < WINDOW_RECORD_HEADER_SIZE) {
+    return FALSE;
+  }
+  const int day = read_i32(data);
+  const int num_entries = data[4];
+  if (day < 0 || num_entries > WINDOW_TOP ||
+      size != WINDOW_RECORD_HEADER_SIZE + num_entries * WINDOW_ENTRY_SIZE) {
+    return FALSE;
+  }
+  b->day = day;
+  b->num_entries = 0;
+  const unsigned char *cursor = data + WINDOW_RECORD_HEADER_SIZE;
+  int i = 0;
+  while (i < num_entries) {
+    char name[MAX_USERNAME_LENGTH + 1];
+    memcpy(name, cursor, MAX_USERNAME_LENGTH);
+    name[MAX_USERNAME_LENGTH] = STR_END;
+    Entry e;
+    set_name(&e, name);
+    set_final_score(&e, read_i32(cursor + MAX_USERNAME_LENGTH));
+    b->num_entries = insert_by_rank(b->entries, b->num_entries, &e);
+    cursor = cursor + WINDOW_ENTRY_SIZE;
+    i = i + 1;
+  }
+  return TRUE;
+}
@@ -6,13 +6,18 @@
 //    Fidanza Simone
 //    Lecini Fabio
 
+#include "../../inc/string.h"
 #include "../../inc/types/entry.h"
 
-#include <stdio.h>
-
 const char *get_name(const Entry *e) { return e->name; }
 void set_name(Entry *e, const char name[]) {
-  snprintf(e->name, MAX_USERNAME_LENGTH + 1, "%s", name);
+  // copied by hand, since it is called for every entry read from a leaderboard
+  int i = 0;
+  while (i < MAX_USERNAME_LENGTH && name[i] != STR_END) {
+    e->name[i] = name[i];
+    i = i + 1;
+  }
+  e->name[i] = STR_END;
 }
 
 const int get_final_score(const Entry *e) { return e->final_score; }
@@ -0,0 +1,135 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../inc/error.h"
+#include "../inc/logger.h"
+
+#include "../inc/writer.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The body of the thread of a writer.
+ *
+ * It waits for buffers to be queued and writes them one at a time, without
+ * holding the lock while writing, until the writer is stopped and the queue is
+ * empty.
+ */
+static DWORD WINAPI write_pending(LPVOID arg) {
+  Writer *w = (Writer *)arg;
+
+  EnterCriticalSection(w->lock);
+  while (w->num_pending > 0 || !w->is_stopping) {
+    if (w->num_pending == 0) {
+      SleepConditionVariableCS(w->changed, w->lock, INFINITE);
+      continue;
+    }
+    const PendingWrite pending = w->queue[w->head];
+    w->head = (w->head + 1) % WRITER_QUEUE_LEN;
+    w->num_pending = w->num_pending - 1;
+    WakeConditionVariable(w->changed);
+    LeaveCriticalSection(w->lock);
+
+    fwrite(pending.data, 1, pending.size, w->fp);
+    fflush(w->fp);
+    free(pending.data);
+
+    EnterCriticalSection(w->lock);
+  }
+  LeaveCriticalSection(w->lock);
+
+  return 0;
+}
+
+Writer *start_writer(const char path[]) {
+  logger.enter_fn(__func__);
+  logger.log("starting writer of '%s'", path);
+
+  Writer *w = (Writer *)malloc(sizeof(Writer));  // NOLINT
+  if (!w) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  if (fopen_s(&w->fp, path, "wb")) {
+    logger.log("file is not writable");
+    logger.stop();
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+  w->head = 0;
+  w->num_pending = 0;
+  w->is_stopping = FALSE;
+
+  w->lock = malloc(sizeof(CRITICAL_SECTION));
+  w->changed = malloc(sizeof(CONDITION_VARIABLE));
+  if (!w->lock || !w->changed) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  InitializeCriticalSection(w->lock);
+  InitializeConditionVariable(w->changed);
+
+  w->thread = CreateThread(NULL, 0, write_pending, w, 0, NULL);
+  if (!w->thread) {
+    logger.log("can not start the thread");
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+
+  logger.exit_fn();
+  return w;
+}
+
+void queue_write(Writer *w, unsigned char *data, const int size,
+                 const int is_replaceable) {
+  EnterCriticalSection(w->lock);
+
+  const int last = (w->head + w->num_pending - 1) % WRITER_QUEUE_LEN;
+  if (w->num_pending > 0 && is_replaceable &&
+      w->queue[last].is_replaceable) {
+    free(w->queue[last].data);
+  } else {
+    while (w->num_pending == WRITER_QUEUE_LEN) {
+      SleepConditionVariableCS(w->changed, w->lock, INFINITE);
+    }
+    w->num_pending = w->num_pending + 1;
+  }
+
+  PendingWrite *pending =
+      &w->queue[(w->head + w->num_pending - 1) % WRITER_QUEUE_LEN];
+  pending->data = data;
+  pending->size = size;
+  pending->is_replaceable = is_replaceable;
+
+  WakeConditionVariable(w->changed);
+  LeaveCriticalSection(w->lock);
+}
+
+void stop_writer(Writer *w) {
+  logger.enter_fn(__func__);
+
+  EnterCriticalSection(w->lock);
+  w->is_stopping = TRUE;
+  logger.log("stopping writer with %i buffers pending", w->num_pending);
+  WakeConditionVariable(w->changed);
+  LeaveCriticalSection(w->lock);
+
+  WaitForSingleObject(w->thread, INFINITE);
+  CloseHandle(w->thread);
+  DeleteCriticalSection(w->lock);
+  free(w->lock);
+  free(w->changed);
+  fclose(w->fp);
+  free(w);
+
+  logger.exit_fn();
+}
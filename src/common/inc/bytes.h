@@ -0,0 +1,154 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file bytes.h
+ * @brief Header file for reading and writing integers in binary files.
+ *
+ * This file declares the functions used by the data files of the game to store
+ * integers in little-endian order, regardless of the machine that writes them,
+ * so that a file can be read back by any build of the game.
+ *
+ * Small integers can also be stored as varints, seven bits per byte starting
+ * from the lowest ones, with the high bit of every byte but the last set: a
+ * value below 128 takes a single byte.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 18:20
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef BYTES_UTILS_H
+#define BYTES_UTILS_H
+
+#include <time.h>
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The maximum size in bytes of a varint.
+ */
+#define VARINT_MAX_SIZE 5
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Reads an unsigned 16 bit little-endian integer.
+ *
+ * @param[in] p The first byte of the integer.
+ *
+ * @return The integer.
+ */
+int read_u16(const unsigned char *p);
+
+/**
+ * @brief Reads a 32 bit little-endian integer.
+ *
+ * @param[in] p The first byte of the integer.
+ *
+ * @return The integer.
+ */
+int read_i32(const unsigned char *p);
+
+/**
+ * @brief Reads an unsigned 64 bit little-endian integer.
+ *
+ * @param[in] p The first byte of the integer.
+ *
+ * @return The integer.
+ */
+unsigned long long read_u64(const unsigned char *p);
+
+/**
+ * @brief Reads a 64 bit little-endian timestamp.
+ *
+ * @param[in] p The first byte of the timestamp.
+ *
+ * @return The timestamp.
+ */
+time_t read_time(const unsigned char *p);
+
+/**
+ * @brief Writes an unsigned 16 bit little-endian integer and advances the
+ *        cursor.
+ *
+ * @param[out] cursor The position where the integer is written.
+ * @param[in]  value  The integer, in [0, 65535].
+ *
+ * @return The position right after the written integer.
+ */
+unsigned char *write_u16(unsigned char *cursor, const int value);
+
+/**
+ * @brief Writes a 32 bit little-endian integer and advances the cursor.
+ *
+ * @param[out] cursor The position where the integer is written.
+ * @param[in]  value  The integer.
+ *
+ * @return The position right after the written integer.
+ */
+unsigned char *write_i32(unsigned char *cursor, const int value);
+
+/**
+ * @brief Writes an unsigned 64 bit little-endian integer and advances the
+ *        cursor.
+ *
+ * @param[out] cursor The position where the integer is written.
+ * @param[in]  value  The integer.
+ *
+ * @return The position right after the written integer.
+ */
+unsigned char *write_u64(unsigned char *cursor,
+                         const unsigned long long value);
+
+/**
+ * @brief Writes a 64 bit little-endian timestamp and advances the cursor.
+ *
+ * @param[out] cursor The position where the timestamp is written.
+ * @param[in]  value  The timestamp.
+ *
+ * @return The position right after the written timestamp.
+ */
+unsigned char *write_time(unsigned char *cursor, const time_t value);
+
+/**
+ * @brief Reads a varint, checking that it ends before a given position.
+ *
+ * @param[in]  p     The first byte of the varint.
+ * @param[in]  end   The position right after the last readable byte.
+ * @param[out] value The integer.
+ *
+ * @return The position right after the varint, or @c NULL if it does not end
+ *         before @c end, it is longer than @c VARINT_MAX_SIZE bytes or it does
+ *         not fit in 32 bits.
+ */
+const unsigned char *read_varint(const unsigned char *p,
+                                 const unsigned char *end, unsigned *value);
+
+/**
+ * @brief Computes the size in bytes of the varint of an integer.
+ *
+ * @param[in] value The integer.
+ *
+ * @return The size in bytes, in [1, @c VARINT_MAX_SIZE].
+ */
+int varint_size(unsigned value);
+
+/**
+ * @brief Writes a varint and advances the cursor.
+ *
+ * @param[out] cursor The position where the varint is written.
+ * @param[in]  value  The integer.
+ *
+ * @return The position right after the written varint.
+ */
+unsigned char *write_varint(unsigned char *cursor, unsigned value);
+
+#endif  // !BYTES_UTILS_H
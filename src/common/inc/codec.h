@@ -0,0 +1,128 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file codec.h
+ * @brief Header file for the compact encoding of players and games.
+ *
+ * This file declares the functions to encode a game in as few bytes as
+ * possible, for the records of the save file and of the autosave. Only what
+ * can not be derived is stored:
+ *
+ * @code
+ * player state  position varint | score zigzag varint | blocked u8
+ * player        username (3) | player state
+ * game          name_len varint | name | players u8 | players x player
+ *               | dim u8
+ * @endcode
+ *
+ * The id of a player is derived from their username, and the squares of the
+ * board from its dimension, since every board of a given dimension is the same
+ * (see @c get_cached_board()). A score is stored in zigzag order, so that small
+ * negative scores are small varints too. The lowest seven bits of @c blocked
+ * hold the number of turns a player is blocked for, and its high bit is set
+ * when the player is blocked indefinitely.
+ *
+ * A game of four players takes around 30 bytes, against the 700 bytes of a
+ * @c GameState struct.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 21:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef CODEC_UTILS_H
+#define CODEC_UTILS_H
+
+#include "./types/gamestate.h"
+#include "./types/player.h"
+#include "./types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The bit of @c blocked set when a player is blocked indefinitely.
+ */
+#define CODEC_INDEF_BLOCK 0x80
+
+/**
+ * @brief The largest number of turns a player can be blocked for.
+ */
+#define CODEC_MAX_BLOCK 0x7F
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Computes the size in bytes of the state of a player.
+ *
+ * @param[in] pl The player.
+ *
+ * @return The size in bytes.
+ */
+int get_player_state_size(const Player *pl);
+
+/**
+ * @brief Encodes the position, score and turns blocked of a player and
+ *        advances the cursor.
+ *
+ * @param[out] cursor The position where the state is written.
+ * @param[in]  pl     The player.
+ *
+ * @return The position right after the written state.
+ */
+unsigned char *encode_player_state(unsigned char *cursor, const Player *pl);
+
+/**
+ * @brief Decodes the position, score and turns blocked of a player.
+ *
+ * @param[in]  p   The first byte of the state.
+ * @param[in]  end The position right after the last readable byte.
+ * @param[out] pl  The player, whose other fields are left untouched.
+ *
+ * @return The position right after the state, or @c NULL if it is malformed.
+ */
+const unsigned char *decode_player_state(const unsigned char *p,
+                                         const unsigned char *end, Player *pl);
+
+/**
+ * @brief Computes the size in bytes of the encoding of a game.
+ *
+ * @param[in] gs The game.
+ *
+ * @return The size in bytes.
+ */
+int get_game_size(GameState *gs);
+
+/**
+ * @brief Encodes a game and advances the cursor.
+ *
+ * @param[out] cursor The position where the game is written, with at least
+ *                    @c get_game_size() bytes available.
+ * @param[in]  gs     The game.
+ *
+ * @return The position right after the written game.
+ */
+unsigned char *encode_game(unsigned char *cursor, GameState *gs);
+
+/**
+ * @brief Decodes a game, checking that every field fits inside it.
+ *
+ * @param[in]  data The bytes of the game.
+ * @param[in]  size The size in bytes of the game.
+ * @param[out] gs   The game.
+ *
+ * @return @c TRUE if the game has been decoded, @c FALSE if it is malformed.
+ *
+ * @note Only the dimension of the board is set, the caller gets its squares
+ *       with @c get_cached_board().
+ */
+int decode_game(const unsigned char data[], const int size, GameState *gs);
+
+#endif  // !CODEC_UTILS_H
@@ -0,0 +1,51 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file crc.h
+ * @brief Header file for the checksums of the data files.
+ *
+ * This file declares the function computing the CRC32C (Castagnoli) checksum
+ * of the records of the data files. The checksum is computed with the @c crc32
+ * instruction of SSE4.2 when the processor has it, and with a lookup table
+ * otherwise: both give the same result, so a file written on one machine is
+ * verified on any other.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 20:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef CRC_UTILS_H
+#define CRC_UTILS_H
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The CRC32C polynomial, in reversed bit order.
+ */
+#define CRC32C_POLY 0x82F63B78u
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Computes the CRC32C checksum of some bytes.
+ *
+ * @param[in] data The bytes.
+ * @param[in] size The number of bytes.
+ *
+ * @return The checksum, e.g. @c 0xE3069283 for the ascii string "123456789".
+ *
+ * @note The first call checks whether the processor supports SSE4.2, and builds
+ *       the lookup table if it does not. It can be made by any thread.
+ */
+unsigned crc32c(const unsigned char data[], const int size);
+
+#endif  // !CRC_UTILS_H
@@ -118,6 +118,26 @@
  */
 #define EMPTY_LEADERBOARD 16
 
+/**
+ * @brief Error code indicating a corrupted or unsupported save file.
+ */
+#define CORRUPTED_SAVES_ERROR 17
+
+/**
+ * @brief Error code indicating a corrupted or unsupported journal file.
+ */
+#define CORRUPTED_JOURNAL_ERROR 18
+
+/**
+ * @brief Error code indicating that corrupted records have been skipped.
+ */
+#define SKIPPED_RECORDS_ERROR 19
+
+/**
+ * @brief Error code indicating a corrupted or unsupported leaderboard file.
+ */
+#define CORRUPTED_LEADERBOARD_ERROR 20
+
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
@@ -0,0 +1,213 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file extsort.h
+ * @brief Header file for sorting more entries than fit in memory.
+ *
+ * Entries are added one at a time into a buffer sized after a memory budget.
+ * Once the buffer is full it is handed over to a background thread, which
+ * sorts it in order of rank, keeps the best entry of each player and writes
+ * it to a leaderboard file of its own, a run (see ranktree.h), while the
+ * caller goes on filling another buffer. Up to @c SORT_THREADS runs are
+ * sorted and written at the same time.
+ *
+ * Once every entry has been added, the runs are opened and merged in a single
+ * pass (see merge.h), which reads each of them a few kilobytes at a time. The
+ * result is in the same order as a leaderboard, by score from the highest and
+ * then by name, with one entry per player.
+ *
+ * The budget bounds the memory taken by the buffers and by the threads sorting
+ * them, whatever the number of entries added. The threads do not log
+ * anything, since the logger keeps a single call stack that must only be used
+ * by the main thread.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 05:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include "./merge.h"
+#include "./ranktree.h"
+#include "./string.h"
+#include "./types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of runs sorted and written at the same time.
+ */
+#define SORT_THREADS 4
+
+/**
+ * @brief The memory in bytes taken by each entry of a run being sorted: the
+ *        entry, its order and a copy to sort it, then the copies taken to lay
+ *        the run out and the pages of the run.
+ */
+#define SORT_BYTES_PER_ENTRY 48
+
+/**
+ * @brief The memory in bytes taken by each run being sorted, whatever its
+ *        number of entries: one bit per packed name, to keep the first entry
+ *        of each player.
+ */
+#define SORT_BYTES_PER_RUN (MERGE_NUM_NAMES / 8)
+
+/**
+ * @brief The least number of entries of a run, whatever the budget.
+ */
+#define SORT_MIN_RUN_ENTRIES 1024
+
+/**
+ * @brief The suffix of the files of the runs, followed by their number.
+ */
+#define SORT_RUN_SUFFIX ".run"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a run handed over to a thread.
+ *
+ * @var SortJob::entries
+ * The entries of the run, then the best entry of each player in order of
+ * rank. The buffer is kept once the run is written, to be filled again.
+ *
+ * @var SortJob::num_entries
+ * The number of entries of the run.
+ *
+ * @var SortJob::path
+ * The path of the file of the run.
+ *
+ * @var SortJob::is_written
+ * Whether the run has been written, set by the thread before it ends.
+ *
+ * @var SortJob::thread
+ * The handle of the thread, or @c NULL if no thread has been started.
+ */
+typedef struct SortJob {
+  Entry *entries;             ///< The entries of the run.
+  int num_entries;            ///< The number of entries.
+  char path[MAX_BUFFER_LEN];  ///< The path of the file of the run.
+  int is_written;             ///< Whether the run has been written.
+  void *thread;               ///< The handle of the thread.
+} SortJob;
+
+/**
+ * @brief A struct representing a sort of entries.
+ *
+ * @var EntrySorter::prefix
+ * The path the files of the runs start with.
+ *
+ * @var EntrySorter::run_capacity
+ * The number of entries of a full run.
+ *
+ * @var EntrySorter::entries
+ * The entries added since the last run was handed over.
+ *
+ * @var EntrySorter::num_entries
+ * The number of entries in @c entries.
+ *
+ * @var EntrySorter::jobs
+ * The runs handed over to the threads, each reused in turn.
+ *
+ * @var EntrySorter::next_job
+ * The run handed over the longest time ago, the next one reused.
+ *
+ * @var EntrySorter::num_runs
+ * The number of runs handed over so far.
+ *
+ * @var EntrySorter::num_added
+ * The number of entries added so far.
+ *
+ * @var EntrySorter::runs
+ * The files of the runs, once opened by @c finish_entry_sort().
+ */
+typedef struct EntrySorter {
+  char prefix[MAX_BUFFER_LEN];  ///< The path of the runs without suffix.
+  int run_capacity;             ///< The number of entries of a full run.
+  Entry *entries;               ///< The entries being added.
+  int num_entries;              ///< The number of entries being added.
+  SortJob jobs[SORT_THREADS];   ///< The runs handed over to the threads.
+  int next_job;                 ///< The next run reused.
+  int num_runs;                 ///< The number of runs.
+  int num_added;                ///< The number of entries added.
+  RankTree **runs;              ///< The files of the runs, once finished.
+} EntrySorter;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Starts a sort of entries.
+ *
+ * The @c SORT_THREADS runs being sorted first take @c SORT_BYTES_PER_RUN
+ * bytes each out of the budget. The rest is split between the buffer being
+ * filled, @c sizeof(Entry) bytes per entry, and the runs being sorted,
+ * @c SORT_BYTES_PER_ENTRY bytes per entry each. A budget too small for that
+ * still gives runs of @c SORT_MIN_RUN_ENTRIES entries. Merging the runs takes
+ * another few tens of kilobytes per run (see merge.h).
+ *
+ * @param[in] prefix The path the files of the runs start with, followed by
+ *                   @c SORT_RUN_SUFFIX and their number.
+ * @param[in] budget The memory in bytes the sort may take.
+ *
+ * @return A pointer to the sort, to free with @c free_entry_sorter().
+ *
+ * @throws ALLOCATION_ERROR If the buffer can not be allocated.
+ */
+EntrySorter *new_entry_sorter(const char prefix[], const int budget);
+
+/**
+ * @brief Adds an entry to sort, handing the buffer over to a thread once it
+ *        is full.
+ *
+ * If every thread is busy, the caller waits for the run handed over the
+ * longest time ago.
+ *
+ * @param[in,out] s The sort.
+ * @param[in]     e The entry.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR        If a run can not be allocated or started.
+ * @throws FILE_NOT_WRITABLE_ERROR If a run could not be sorted or written.
+ */
+void add_sort_entry(EntrySorter *s, const Entry *e);
+
+/**
+ * @brief Hands over the entries left, waits for every run to be written and
+ *        opens them.
+ *
+ * The opened runs are then found in @c s->runs, ready to be merged with
+ * @c start_merge(), and stay open until @c free_entry_sorter().
+ *
+ * @param[in,out] s The sort.
+ *
+ * @return The number of runs, zero if no entry was added.
+ *
+ * @throws ALLOCATION_ERROR        If a run can not be allocated or started.
+ * @throws FILE_NOT_WRITABLE_ERROR If a run could not be sorted or written.
+ */
+int finish_entry_sort(EntrySorter *s);
+
+/**
+ * @brief Frees a sort started with @c new_entry_sorter(), waiting for the
+ *        runs being written, closing them and deleting their files.
+ *
+ * @param[in,out] s The sort, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void free_entry_sorter(EntrySorter *s);
+
+#endif  // !EXTSORT_H
@@ -0,0 +1,312 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file iopool.h
+ * @brief Header file for writing files from a pool of background threads.
+ *
+ * Saves and leaderboard updates are laid out in memory by the caller and then
+ * queued to the pool as a request, which the caller gets back as a handle to
+ * poll. The caller only waits on the disk when it reads back a file that still
+ * has requests queued (see @c wait_file_io()).
+ *
+ * Every file is written by the same thread, chosen from its path, so the
+ * requests on a file are carried out in the order they are queued while
+ * different files are written at the same time.
+ *
+ * A request is either a list of segments written in place, each committed to
+ * the disk before the next one is written, or the whole content of a file, written to a
+ * temporary file that is then renamed over it. A file written in place can
+ * also be cut right after its last segment, dropping the bytes left past it,
+ * or be rewritten as a whole by a function run on the thread of the pool, so
+ * that e.g. a file is compacted without making the caller wait.
+ *
+ * Before @c start_io_pool() and after @c stop_io_pool() requests are carried
+ * out by the caller as soon as they are queued.
+ *
+ * The threads of the pool do not log anything, since the logger keeps a single
+ * call stack that must only be used by the main thread.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 23:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef IOPOOL_H
+#define IOPOOL_H
+
+#include "./string.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of threads of the pool.
+ */
+#define IO_POOL_THREADS 2
+
+/**
+ * @brief The maximum number of segments of a request.
+ */
+#define IO_MAX_SEGMENTS 3
+
+/**
+ * @brief The suffix of the temporary file written to replace a file.
+ */
+#define TEMP_FILE_SUFFIX ".tmp"
+
+/**
+ * @brief The status of a request still queued or being carried out.
+ */
+#define IO_PENDING 0
+
+/**
+ * @brief The status of a request carried out.
+ */
+#define IO_DONE 1
+
+/**
+ * @brief The status of a request whose file could not be written.
+ */
+#define IO_FAILED 2
+
+/**
+ * @brief The kind of a request writing segments of a file in place.
+ */
+#define IO_WRITE 0
+
+/**
+ * @brief The kind of a request replacing the whole content of a file.
+ */
+#define IO_REPLACE 1
+
+/**
+ * @brief The kind of a request writing segments of a file in place, the file
+ *        being cut right after the last one.
+ */
+#define IO_TRUNCATE 2
+
+/**
+ * @brief The kind of a request writing segments of a file in place, the whole
+ *        file being then rewritten by a function.
+ */
+#define IO_REWRITE 3
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A function computing the new content of a file from the current one.
+ *
+ * It is run by a thread of the pool, so it must not log nor throw errors.
+ *
+ * @param[in]  content  The current content of the file.
+ * @param[in]  size     The size in bytes of the current content.
+ * @param[out] new_size The size in bytes of the new content.
+ *
+ * @return The new content, allocated with @c malloc(), or @c NULL to leave the
+ *         file as it is.
+ */
+typedef unsigned char *(*IoRewrite)(const unsigned char content[],
+                                    const int size, int *new_size);
+
+/**
+ * @brief A struct representing a part of a file written in place.
+ *
+ * @var IoSegment::offset
+ * The offset in the file where the segment is written.
+ *
+ * @var IoSegment::size
+ * The size in bytes of the segment.
+ */
+typedef struct IoSegment {
+  int offset;  ///< The offset in the file.
+  int size;    ///< The size in bytes.
+} IoSegment;
+
+/**
+ * @brief A struct representing a write queued to the pool.
+ *
+ * @var IoRequest::path
+ * The path of the file.
+ *
+ * @var IoRequest::kind
+ * One of @c IO_WRITE, @c IO_REPLACE, @c IO_TRUNCATE or @c IO_REWRITE.
+ *
+ * @var IoRequest::data
+ * The bytes of the segments one after the other, freed once written.
+ *
+ * @var IoRequest::segments
+ * The segments, in the order they are written.
+ *
+ * @var IoRequest::num_segments
+ * The number of segments.
+ *
+ * @var IoRequest::rewrite
+ * The function rewriting the file once the segments are written, for a
+ * request of kind @c IO_REWRITE.
+ *
+ * @var IoRequest::status
+ * One of @c IO_PENDING, @c IO_DONE or @c IO_FAILED.
+ *
+ * @var IoRequest::next
+ * The request queued after this one on the same thread.
+ */
+typedef struct IoRequest {
+  char path[MAX_BUFFER_LEN];            ///< The path of the file.
+  int kind;                             ///< The kind of request.
+  unsigned char *data;                  ///< The bytes to write.
+  IoSegment segments[IO_MAX_SEGMENTS];  ///< The segments to write.
+  int num_segments;                     ///< The number of segments.
+  IoRewrite rewrite;                    ///< The function rewriting the file.
+  int status;                           ///< The status of the request.
+  struct IoRequest *next;               ///< The next request queued.
+} IoRequest;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Starts the threads of the pool.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR If a thread can not be started.
+ */
+void start_io_pool(void);
+
+/**
+ * @brief Carries out the requests still queued and stops the threads of the
+ *        pool.
+ *
+ * @return void.
+ */
+void stop_io_pool(void);
+
+/**
+ * @brief Queues segments to be written in place in an existing file.
+ *
+ * The pool takes ownership of the data and frees it once written. The segments
+ * are written in order, and each of them is committed to the disk before the
+ * next one is written, so that e.g. a header can point to data only once it is
+ * on disk.
+ *
+ * @param[in] path         The path of the file.
+ * @param[in] data         The bytes of the segments one after the other,
+ *                         allocated with @c malloc().
+ * @param[in] segments     The segments.
+ * @param[in] num_segments The number of segments, at most
+ *                         @c IO_MAX_SEGMENTS.
+ *
+ * @return The handle of the request, to release with @c finish_io().
+ *
+ * @throws ALLOCATION_ERROR If the request can not be allocated.
+ */
+IoRequest *submit_write(const char path[], unsigned char *data,
+                        const IoSegment segments[], const int num_segments);
+
+/**
+ * @brief Queues segments to be written in place in an existing file, as
+ *        @c submit_write() does, then cuts the file right after the last one.
+ *
+ * This drops whatever the file held past the last segment, such as the tail
+ * of a write interrupted by a crash.
+ *
+ * @param[in] path         The path of the file.
+ * @param[in] data         The bytes of the segments one after the other,
+ *                         allocated with @c malloc().
+ * @param[in] segments     The segments, the last one ending where the file
+ *                         must end.
+ * @param[in] num_segments The number of segments, at most
+ *                         @c IO_MAX_SEGMENTS.
+ *
+ * @return The handle of the request, to release with @c finish_io().
+ *
+ * @throws ALLOCATION_ERROR If the request can not be allocated.
+ */
+IoRequest *submit_truncate(const char path[], unsigned char *data,
+                           const IoSegment segments[], const int num_segments);
+
+/**
+ * @brief Queues segments to be written in place in an existing file, as
+ *        @c submit_write() does, then the whole file to be rewritten.
+ *
+ * Once the segments are on disk, the thread of the pool reads the file back,
+ * computes its new content with the given function and replaces the file with
+ * it, as @c submit_replace() does. A crash at any point leaves the file either
+ * with the segments written or with its new content.
+ *
+ * @param[in] path         The path of the file.
+ * @param[in] data         The bytes of the segments one after the other,
+ *                         allocated with @c malloc().
+ * @param[in] segments     The segments.
+ * @param[in] num_segments The number of segments, at most
+ *                         @c IO_MAX_SEGMENTS.
+ * @param[in] rewrite      The function computing the new content of the file.
+ *
+ * @return The handle of the request, to release with @c finish_io().
+ *
+ * @throws ALLOCATION_ERROR If the request can not be allocated.
+ */
+IoRequest *submit_rewrite(const char path[], unsigned char *data,
+                          const IoSegment segments[], const int num_segments,
+                          IoRewrite rewrite);
+
+/**
+ * @brief Queues the whole content of a file to replace it.
+ *
+ * The pool takes ownership of the data and frees it once written. The content
+ * is written to a temporary file next to it, named by appending
+ * @c TEMP_FILE_SUFFIX, which is committed to the disk and then renamed over
+ * the file. A crash while writing leaves the file as it was.
+ *
+ * @param[in] path The path of the file.
+ * @param[in] data The new content of the file, allocated with @c malloc().
+ * @param[in] size The size in bytes of the new content.
+ *
+ * @return The handle of the request, to release with @c finish_io().
+ *
+ * @throws ALLOCATION_ERROR If the request can not be allocated.
+ */
+IoRequest *submit_replace(const char path[], unsigned char *data,
+                          const int size);
+
+/**
+ * @brief Gets the status of a request without waiting for it.
+ *
+ * @param[in] req The request.
+ *
+ * @return One of @c IO_PENDING, @c IO_DONE or @c IO_FAILED.
+ */
+int poll_io(IoRequest *req);
+
+/**
+ * @brief Waits for a request to be carried out and releases its handle.
+ *
+ * @param[in,out] req The request, or @c NULL to do nothing.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the file of the request could not be
+ *                                 written.
+ */
+void finish_io(IoRequest *req);
+
+/**
+ * @brief Waits for every request queued on a file to be carried out.
+ *
+ * This is called before reading a file, so that it is read as it will be once
+ * the writes queued so far are on disk.
+ *
+ * @param[in] path The path of the file.
+ *
+ * @return void.
+ */
+void wait_file_io(const char path[]);
+
+#endif  // !IOPOOL_H
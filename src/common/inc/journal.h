@@ -0,0 +1,321 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file journal.h
+ * @brief Header file for append-only journal files.
+ *
+ * A journal is a file where updates are only ever appended as records, so that
+ * an update writes a single record instead of the whole file and a crash while
+ * writing can at most lose the record being written. The state is rebuilt by
+ * replaying the records in order, and the journal is compacted from time to
+ * time by replacing it with a snapshot of the state. A journal whose records
+ * hold entries keyed by a player, a later entry replacing an earlier one, can
+ * instead be compacted by the I/O pool right after an append, from the bytes
+ * of the file alone (see @c compact_keyed_journal()).
+ *
+ * Every integer is stored in little-endian order. The file is laid out as
+ * follows:
+ *
+ * @code
+ * header  magic "GLOG" (4) | version u16 | reserved u16
+ * records { size u16 | crc32c u32 | size x byte }
+ * @endcode
+ *
+ * A record whose size goes past the end of the file, or the last record if its
+ * checksum (see crc.h) does not match, is the tail of an interrupted append and
+ * it ends the journal. Any other record whose checksum does not match has been
+ * corrupted, and it is skipped.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 18:20
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "./iopool.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The bytes every journal starts with.
+ */
+#define JOURNAL_MAGIC "GLOG"
+
+/**
+ * @brief The number of bytes of @c JOURNAL_MAGIC.
+ */
+#define JOURNAL_MAGIC_LEN 4
+
+/**
+ * @brief The version of the format written by this program.
+ */
+#define JOURNAL_VERSION 1
+
+/**
+ * @brief The size in bytes of the header of a journal.
+ */
+#define JOURNAL_HEADER_SIZE 8
+
+/**
+ * @brief The size in bytes of the size and the checksum before each record.
+ */
+#define JOURNAL_RECORD_HEADER_SIZE 6
+
+/**
+ * @brief The end of a journal being compacted by the I/O pool, found again
+ *        before the next append.
+ */
+#define JOURNAL_END_UNKNOWN -1
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a journal read in memory.
+ *
+ * @var Journal::data
+ * The bytes of the file.
+ *
+ * @var Journal::size
+ * The size in bytes of the file.
+ *
+ * @var Journal::end
+ * The offset right after the last record read, where the next record is
+ * appended, or @c JOURNAL_END_UNKNOWN once compacted by the I/O pool.
+ *
+ * @var Journal::num_records
+ * The number of records read and appended, counted again from zero once the
+ * journal is compacted by the I/O pool.
+ *
+ * @var Journal::num_corrupted
+ * The number of corrupted records skipped.
+ */
+typedef struct Journal {
+  unsigned char *data;  ///< The bytes of the file.
+  int size;             ///< The size in bytes of the file.
+  int end;              ///< The offset right after the last record read.
+  int num_records;      ///< The number of records read and appended.
+  int num_corrupted;    ///< The number of corrupted records skipped.
+} Journal;
+
+/**
+ * @brief A struct representing a record inside a journal.
+ *
+ * A record only points to the bytes of the journal, so it is valid as long as
+ * the journal it comes from is open.
+ *
+ * @var JournalRecord::data
+ * The first byte of the record.
+ *
+ * @var JournalRecord::size
+ * The size in bytes of the record.
+ */
+typedef struct JournalRecord {
+  const unsigned char *data;  ///< The first byte of the record.
+  int size;                   ///< The size in bytes of the record.
+} JournalRecord;
+
+/**
+ * @brief A function checking whether the entries of a record are valid.
+ *
+ * It is run by a thread of the I/O pool, so it must not log nor throw errors.
+ *
+ * @param[in] data The first byte of the record.
+ * @param[in] size The size in bytes of the record.
+ *
+ * @return @c TRUE if the record is valid, @c FALSE otherwise.
+ */
+typedef int (*JournalCheck)(const unsigned char data[], const int size);
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Reads a journal in memory.
+ *
+ * An empty file is a valid journal without records. The writes still queued
+ * on the file are waited for first.
+ *
+ * @param[in] path The path of the journal.
+ *
+ * @return A pointer to the journal, positioned before its first record, to
+ *         close with @c close_journal().
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the file can not be read.
+ * @throws CORRUPTED_JOURNAL_ERROR If the file is not a journal or it has an
+ *                                 unsupported version.
+ */
+Journal *open_journal(const char path[]);
+
+/**
+ * @brief Reads the next record of a journal.
+ *
+ * @param[in,out] j   The journal.
+ * @param[out]    rec The record read.
+ *
+ * Corrupted records are skipped and counted in @c Journal::num_corrupted.
+ *
+ * @return @c TRUE if a record has been read, @c FALSE at the end of the
+ *         journal or at the tail of an interrupted append.
+ */
+int next_journal_record(Journal *j, JournalRecord *rec);
+
+/**
+ * @brief Frees a journal opened with @c open_journal().
+ *
+ * @param[in,out] j The journal to close.
+ *
+ * @return void.
+ */
+void close_journal(Journal *j);
+
+/**
+ * @brief Frees the bytes of a journal, keeping the position where the next
+ *        record is appended.
+ *
+ * This is called once every record has been read, so that a journal can be
+ * kept open to append records to it without holding the whole file in memory.
+ * No record can be read afterwards.
+ *
+ * @param[in,out] j The journal, with every record read.
+ *
+ * @return void.
+ */
+void release_journal(Journal *j);
+
+/**
+ * @brief Appends a record to a journal.
+ *
+ * The record is written at @c Journal::end, so every record of the journal
+ * must have been read first. Whatever the file holds past it, such as the tail
+ * of an interrupted append, is dropped. The journal is then positioned after
+ * it, so that records can be appended one after the other without reading the
+ * file again.
+ *
+ * @param[in]     path The path of the journal.
+ * @param[in,out] j    The journal, with every record read.
+ * @param[in]     data The bytes of the record.
+ * @param[in]     size The size in bytes of the record, at most 65535.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws ALLOCATION_ERROR If the record can not be laid out.
+ */
+IoRequest *append_journal(const char path[], Journal *j,
+                          const unsigned char data[], const int size);
+
+/**
+ * @brief Appends a record to a journal as @c append_journal() does, then has
+ *        the I/O pool compact the journal in the same request.
+ *
+ * The caller does not wait for the journal to be compacted, so the end of
+ * the journal is only found again by the next append, which waits for the
+ * compaction first. If the journal has bytes left past its last record, it is
+ * cut after the record instead and compacted by the next append.
+ *
+ * @param[in]     path    The path of the journal.
+ * @param[in,out] j       The journal, with every record read.
+ * @param[in]     data    The bytes of the record.
+ * @param[in]     size    The size in bytes of the record, at most 65535.
+ * @param[in]     compact The function compacting the journal, run on a thread
+ *                        of the pool, such as one calling
+ *                        @c compact_keyed_journal().
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws ALLOCATION_ERROR        If the record can not be laid out.
+ * @throws FILE_NOT_READABLE_ERROR If the end of a compacted journal can not be
+ *                                 found.
+ */
+IoRequest *append_compact_journal(const char path[], Journal *j,
+                                  const unsigned char data[], const int size,
+                                  IoRewrite compact);
+
+/**
+ * @brief Lays out a compacted journal whose records hold fixed-size entries,
+ *        each starting with a 4-byte key.
+ *
+ * The records are read with the same rules as @c next_journal_record(), and
+ * the records with invalid entries are left out. Only the last entry of each
+ * key is kept, and the entries are written in the order their keys first
+ * appear, a record holding at most @e max_entries of them.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[in]  content     The bytes of the journal.
+ * @param[in]  size        The size in bytes of the journal.
+ * @param[in]  entry_size  The size in bytes of an entry.
+ * @param[in]  max_entries The most entries in a record of the new journal.
+ * @param[in]  is_valid    The function checking the entries of a record.
+ * @param[out] new_size    The size in bytes of the new journal.
+ *
+ * @return The bytes of the new journal, allocated with @c malloc(), or
+ *         @c NULL if the file is not a journal or they can not be allocated.
+ */
+unsigned char *compact_keyed_journal(const unsigned char content[],
+                                     const int size, const int entry_size,
+                                     const int max_entries,
+                                     JournalCheck is_valid, int *new_size);
+
+/**
+ * @brief Writes the header of a journal and advances the cursor.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[out] cursor The position where the header is written, with at least
+ *                    @c JOURNAL_HEADER_SIZE bytes available.
+ *
+ * @return The position right after the written header.
+ */
+unsigned char *write_journal_header(unsigned char *cursor);
+
+/**
+ * @brief Writes a record of a journal, with its size and checksum, and
+ *        advances the cursor.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[out] cursor The position where the record is written, with at least
+ *                    @c JOURNAL_RECORD_HEADER_SIZE + @e size bytes available.
+ * @param[in]  data   The bytes of the record.
+ * @param[in]  size   The size in bytes of the record, at most 65535.
+ *
+ * @return The position right after the written record.
+ */
+unsigned char *write_journal_record(unsigned char *cursor,
+                                    const unsigned char data[],
+                                    const int size);
+
+/**
+ * @brief Replaces a journal with a new one holding the given records.
+ *
+ * This is used to compact a journal, writing a snapshot of the state in place
+ * of the updates that led to it. The journal is replaced at once with
+ * @c submit_replace(), so a crash leaves either the old or the new journal.
+ *
+ * @param[in]     path        The path of the journal.
+ * @param[in,out] j           The journal being replaced, positioned after
+ *                            the written records, or @c NULL.
+ * @param[in]     recs        The records to write.
+ * @param[in]     num_records The number of records.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws ALLOCATION_ERROR If the journal can not be laid out.
+ */
+IoRequest *write_journal(const char path[], Journal *j,
+                         const JournalRecord recs[], const int num_records);
+
+#endif  // !JOURNAL_H
@@ -0,0 +1,213 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file legacy.h
+ * @brief Header file for reading and checking the files of older versions.
+ *
+ * Older versions of the game wrote the raw bytes of a @c GameStates struct to
+ * the save file and of an @c Entries struct to the leaderboard. Their count is
+ * stored after the array, so a legacy file is read by seeking to the count
+ * first and then reading its records one at a time, without reading the whole
+ * file in memory.
+ *
+ * Every field of a record is checked against what the game can write: the
+ * game name must be terminated, the board dimension and the number of players
+ * in range, every position inside the board, every score non-negative and
+ * every username made of the characters accepted by @c is_username_valid(),
+ * uppercased and padded with @c FILLER_CHAR.
+ *
+ * Unlike most modules, the functions of this file do not log anything, so that
+ * files can be read from many threads at the same time.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 00:15
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef LEGACY_UTILS_H
+#define LEGACY_UTILS_H
+
+#include <stdio.h>
+
+#include "./types/entry.h"
+#include "./types/gamestate.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A file that is not a legacy file.
+ */
+#define LEGACY_NONE 0
+
+/**
+ * @brief A legacy save file, holding a @c GameStates struct.
+ */
+#define LEGACY_SAVES 1
+
+/**
+ * @brief A legacy leaderboard, holding an @c Entries struct.
+ */
+#define LEGACY_LEADERBOARD 2
+
+/**
+ * @brief A record with every field valid.
+ */
+#define LEGACY_VALID 0
+
+/**
+ * @brief A game name that is not terminated.
+ */
+#define LEGACY_BAD_NAME 1
+
+/**
+ * @brief A number of players out of range.
+ */
+#define LEGACY_BAD_PLAYERS 2
+
+/**
+ * @brief A board dimension out of range.
+ */
+#define LEGACY_BAD_DIM 3
+
+/**
+ * @brief A username that the game would not have accepted.
+ */
+#define LEGACY_BAD_USERNAME 4
+
+/**
+ * @brief A username taken by two players of the same game.
+ */
+#define LEGACY_DUPLICATE_USERNAME 5
+
+/**
+ * @brief A position outside the board.
+ */
+#define LEGACY_BAD_POSITION 6
+
+/**
+ * @brief A negative score.
+ */
+#define LEGACY_BAD_SCORE 7
+
+/**
+ * @brief A number of turns blocked that the game can not set.
+ */
+#define LEGACY_BAD_BLOCK 8
+
+/**
+ * @brief A record past the end of the file.
+ */
+#define LEGACY_TRUNCATED 9
+
+/**
+ * @brief The number of outcomes of the check of a record.
+ */
+#define LEGACY_NUM_OUTCOMES 10
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a legacy file being read.
+ *
+ * @var LegacyFile::fp
+ * The file, positioned at the next record.
+ *
+ * @var LegacyFile::kind
+ * One of @c LEGACY_NONE, @c LEGACY_SAVES and @c LEGACY_LEADERBOARD.
+ *
+ * @var LegacyFile::count
+ * The number of records stored in the file, not checked.
+ *
+ * @var LegacyFile::capacity
+ * The number of records the file has room for.
+ */
+typedef struct LegacyFile {
+  FILE *fp;      ///< The file.
+  int kind;      ///< The kind of file.
+  int count;     ///< The number of records stored in the file.
+  int capacity;  ///< The number of records the file has room for.
+} LegacyFile;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Opens a file and reads the number of records it holds if it is a
+ *        legacy file.
+ *
+ * A legacy file is recognised by its size, unless it starts with the magic of
+ * the current formats. The count is read as it is, the caller checks it with
+ * @c is_legacy_count_valid() before reading the records.
+ *
+ * @param[out] lf   The legacy file, to close with @c close_legacy().
+ * @param[in]  path The path of the file.
+ *
+ * @return @c TRUE if the file has been opened, @c FALSE if it is not readable.
+ */
+int open_legacy(LegacyFile *lf, const char path[]);
+
+/**
+ * @brief Checks that the number of records of a legacy file fits inside it.
+ *
+ * @param[in] lf The legacy file.
+ *
+ * @return @c TRUE if the count is valid, @c FALSE otherwise.
+ */
+int is_legacy_count_valid(const LegacyFile *lf);
+
+/**
+ * @brief Reads and checks the next game of a legacy save file.
+ *
+ * @param[in,out] lf The legacy save file.
+ * @param[out]    gs The game read, whatever the outcome.
+ *
+ * @return @c LEGACY_VALID, or the first problem found in the game.
+ */
+int next_legacy_game(LegacyFile *lf, GameState *gs);
+
+/**
+ * @brief Reads and checks the next entry of a legacy leaderboard.
+ *
+ * @param[in,out] lf The legacy leaderboard.
+ * @param[out]    e  The entry read, whatever the outcome.
+ *
+ * @return @c LEGACY_VALID, or the first problem found in the entry.
+ */
+int next_legacy_entry(LegacyFile *lf, Entry *e);
+
+/**
+ * @brief Closes a legacy file opened with @c open_legacy().
+ *
+ * @param[in,out] lf The legacy file.
+ *
+ * @return void.
+ */
+void close_legacy(LegacyFile *lf);
+
+/**
+ * @brief Checks every field of a game read from a legacy save file.
+ *
+ * @param[in] gs The game.
+ *
+ * @return @c LEGACY_VALID, or the first problem found in the game.
+ */
+int check_legacy_game(const GameState *gs);
+
+/**
+ * @brief Checks every field of an entry read from a legacy leaderboard.
+ *
+ * @param[in] e The entry.
+ *
+ * @return @c LEGACY_VALID, or the first problem found in the entry.
+ */
+int check_legacy_entry(const Entry *e);
+
+#endif  // !LEGACY_UTILS_H
@@ -40,6 +40,11 @@
  * @brief Maximum value of a dice throw.
  */
 #define MAX_DICE_THROW 6
+
+/**
+ * @brief The stream of the generator of the dice.
+ */
+#define DICE_STREAM 0x60053ULL
 /** @} */  // End of DiceConstants group
 
 // -------------------------------------------------------------------------- //
@@ -65,14 +70,32 @@ int proportion(const int numerator, const int known_value,
 /**
  * @brief Rolls two dice and returns the sum of their values.
  *
- * This function simulates rolling two dice by generating random numbers using
- * the rand() function. It returns the sum of the values obtained from rolling
- * the dice.
+ * This function simulates rolling two dice by drawing random numbers from the
+ * generator of the dice (see rng.h). It returns the sum of the values obtained
+ * from rolling the dice.
  *
  * @return The sum of the values obtained by rolling two dice.
  */
 int roll_dice();
 
+/**
+ * @brief Restarts the generator of the dice from a seed.
+ *
+ * The dice rolled after two calls with the same seed are the same.
+ *
+ * @param[in] seed The seed.
+ *
+ * @return void.
+ */
+void seed_dice(const unsigned long long seed);
+
+/**
+ * @brief Draws a new seed from the generator of the dice, e.g. for a new game.
+ *
+ * @return The seed.
+ */
+unsigned long long new_dice_seed(void);
+
 /**
  * @brief Swaps the values of two integers.
  *
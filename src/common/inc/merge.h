@@ -0,0 +1,181 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file merge.h
+ * @brief Header file for merging leaderboards kept apart into a single one.
+ *
+ * Games played by different threads or processes each write their winners to
+ * a leaderboard file of their own, a shard. A shard is already in order of
+ * rank, that is by score from the highest and then by name, so the shards are
+ * merged by repeatedly taking the first entry among the first entries of every
+ * shard. The shard holding it is found with a loser tree: each inner node of
+ * a complete binary tree over the shards keeps the shard that lost the match
+ * played there, so that once the first entry is taken only the matches on the
+ * path from its shard to the root are played again, that is about log2(k)
+ * comparisons for k shards.
+ *
+ * Each shard is read @c MERGE_BUFFER_ENTRIES entries at a time from its
+ * mapping (see ranktree.h), so only a few tens of kilobytes per shard are kept
+ * in memory whatever the size of the shards, and the pages on the way down to
+ * the entries are read once per buffer.
+ *
+ * A player found in several shards keeps their first entry, the one with the
+ * best score, since it comes first in order of rank. Names are short enough
+ * that every packed name (see nameindex.h) has a bit of its own telling
+ * whether it has been merged already, so the names merged so far fit in a
+ * couple of megabytes that stay in the cache of the processor.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 04:40
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef MERGE_H
+#define MERGE_H
+
+#include "./ranktree.h"
+#include "./types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of entries read from a shard at a time.
+ */
+#define MERGE_BUFFER_ENTRIES 4096
+
+/**
+ * @brief The number of different packed names.
+ */
+#define MERGE_NUM_NAMES (1 << (8 * MAX_USERNAME_LENGTH))
+
+/**
+ * @brief The order of a shard merged entirely, after the order of any entry.
+ */
+#define MERGE_DONE 0xFFFFFFFFFFFFFFFFull
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a shard being merged.
+ *
+ * @var MergeRun::tree
+ * The leaderboard file of the shard.
+ *
+ * @var MergeRun::buffer
+ * The entries of the shard read and not merged yet.
+ *
+ * @var MergeRun::next
+ * The position in @c buffer of the first entry not merged yet.
+ *
+ * @var MergeRun::count
+ * The number of entries in @c buffer.
+ *
+ * @var MergeRun::read
+ * The number of entries of the shard read so far.
+ */
+typedef struct MergeRun {
+  const RankTree *tree;                ///< The leaderboard file.
+  Entry buffer[MERGE_BUFFER_ENTRIES];  ///< The entries read.
+  int next;                            ///< The first entry not merged.
+  int count;                           ///< The number of entries read.
+  int read;                            ///< The entries of the shard read.
+} MergeRun;
+
+/**
+ * @brief A struct representing a merge of shards.
+ *
+ * @var Merge::runs
+ * The shards.
+ *
+ * @var Merge::num_runs
+ * The number of shards.
+ *
+ * @var Merge::heads
+ * The order of the first entry not merged yet of each shard, its score
+ * from the highest in the high half and its packed name in the low half, or
+ * @c MERGE_DONE once the shard has been merged entirely. Kept apart from the
+ * shards, the orders compared by the loser tree fit in a few cache lines.
+ *
+ * @var Merge::losers
+ * The loser tree: the shard holding the first entry, followed by the shard
+ * losing the match at each inner node, the root being node 1 and the
+ * children of node i being nodes 2i and 2i + 1.
+ *
+ * @var Merge::merged
+ * The names merged so far, a bit for each packed name.
+ *
+ * @var Merge::num_read
+ * The number of entries taken from the shards so far.
+ */
+typedef struct Merge {
+  MergeRun *runs;             ///< The shards.
+  int num_runs;               ///< The number of shards.
+  unsigned long long *heads;  ///< The order of the first entry of each.
+  int *losers;                ///< The loser tree.
+  unsigned char *merged;      ///< The names merged so far.
+  int num_read;               ///< The number of entries taken.
+} Merge;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Computes the order of an entry by rank, as a single number.
+ *
+ * Its score from the highest is in the high half and its packed name (see
+ * nameindex.h) in the low half, so that entries compare as their numbers and
+ * the number holds the entry whole.
+ *
+ * @param[in] e The entry.
+ *
+ * @return The order of the entry.
+ */
+unsigned long long rank_key(const Entry *e);
+
+/**
+ * @brief Starts merging shards.
+ *
+ * @param[in] shards     The leaderboard files of the shards, which must stay
+ *                       open until @c end_merge().
+ * @param[in] num_shards The number of shards, at least one.
+ *
+ * @return A pointer to the merge, to free with @c end_merge().
+ *
+ * @throws VALUE_OUT_OF_BOUND_ERROR    If there is no shard.
+ * @throws ALLOCATION_ERROR            If the merge can not be allocated.
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+Merge *start_merge(RankTree *const shards[], const int num_shards);
+
+/**
+ * @brief Takes the next entry of the merged leaderboard.
+ *
+ * @param[in,out] m The merge.
+ * @param[out]    e The entry, if any.
+ *
+ * @return @c TRUE if an entry was taken, @c FALSE once every shard has been
+ *         merged.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int next_merged(Merge *m, Entry *e);
+
+/**
+ * @brief Frees a merge started with @c start_merge(), leaving the shards
+ *        open.
+ *
+ * @param[in,out] m The merge, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void end_merge(Merge *m);
+
+#endif  // !MERGE_H
@@ -0,0 +1,136 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file nameindex.h
+ * @brief Header file for the hash index from the name of a player to a value.
+ *
+ * Usernames are at most @c MAX_USERNAME_LENGTH bytes long, so a name is packed
+ * into a single 32-bit key, its bytes from the first one down, and two names
+ * are the same exactly when their keys are. Keys are looked up in a table
+ * with open addressing and linear probing, never more than half full, so that
+ * finding a name takes constant time whatever the number of names.
+ *
+ * Names are never removed from the index, their value is only changed.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 03:20
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of slots allocated for an empty index, a power of two.
+ */
+#define NAME_INDEX_INITIAL_CAPACITY 64
+
+/**
+ * @brief The key of an empty slot, which no name packs to.
+ */
+#define NAME_INDEX_EMPTY 0xFFFFFFFFu
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a slot of the index.
+ *
+ * @var NameSlot::key
+ * The packed name, or @c NAME_INDEX_EMPTY.
+ *
+ * @var NameSlot::value
+ * The value of the name.
+ */
+typedef struct NameSlot {
+  unsigned key;  ///< The packed name.
+  int value;     ///< The value of the name.
+} NameSlot;
+
+/**
+ * @brief A struct representing an index from names to values.
+ *
+ * @var NameIndex::slots
+ * The slots, a power of two of them.
+ *
+ * @var NameIndex::capacity
+ * The number of slots.
+ *
+ * @var NameIndex::bits
+ * The base 2 logarithm of the number of slots.
+ *
+ * @var NameIndex::num_names
+ * The number of names.
+ */
+typedef struct NameIndex {
+  NameSlot *slots;  ///< The slots.
+  int capacity;     ///< The number of slots.
+  int bits;         ///< The base 2 logarithm of the number of slots.
+  int num_names;    ///< The number of names.
+} NameIndex;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Packs a name into a key.
+ *
+ * @param[in] name The name, only its first @c MAX_USERNAME_LENGTH bytes are
+ *                 used.
+ *
+ * @return The key of the name.
+ */
+unsigned pack_name(const char name[]);
+
+/**
+ * @brief Allocates an empty index.
+ *
+ * @return A pointer to the index, to free with @c free_name_index().
+ *
+ * @throws ALLOCATION_ERROR If the index can not be allocated.
+ */
+NameIndex *new_name_index(void);
+
+/**
+ * @brief Frees an index allocated with @c new_name_index().
+ *
+ * @param[in,out] ix The index, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void free_name_index(NameIndex *ix);
+
+/**
+ * @brief Finds the value of a name.
+ *
+ * @param[in]  ix    The index.
+ * @param[in]  key   The packed name.
+ * @param[out] value The value of the name, if found.
+ *
+ * @return @c TRUE if the name is in the index, @c FALSE otherwise.
+ */
+int find_name(const NameIndex *ix, const unsigned key, int *value);
+
+/**
+ * @brief Adds a name to the index, or changes its value if it is already in.
+ *
+ * @param[in,out] ix    The index.
+ * @param[in]     key   The packed name.
+ * @param[in]     value The value of the name.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR If the index can not grow.
+ */
+void put_name(NameIndex *ix, const unsigned key, const int value);
+
+#endif  // !NAMEINDEX_H
@@ -0,0 +1,293 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file playerstats.h
+ * @brief Header file for the statistics of the players across their games.
+ *
+ * For each player are counted the games played, the games won, the turns
+ * played and the landings on each kind of special square. The table is laid
+ * out in columns, one array per statistic, indexed by a dense slot that the
+ * index of packed names (see nameindex.h) gives for each player, so a scan of
+ * one statistic over every player reads a single array from start to end.
+ *
+ * The moves of a game are counted in a tally as the game engine makes them,
+ * and the tally is added to the table once the game is over.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 11:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef PLAYERSTATS_H
+#define PLAYERSTATS_H
+
+#include "./nameindex.h"
+#include "./types/board.h"
+#include "./types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of kinds of special squares, from @c GOOSE_VALUE down to
+ *        @c SKELETON_VALUE, the landings on a kind being counted at the
+ *        opposite of its value.
+ */
+#define STATS_NUM_SQUARES (GOOSE_VALUE - SKELETON_VALUE + 1)
+
+/**
+ * @brief The number of players the table has room for when it is allocated.
+ */
+#define STATS_INITIAL_CAPACITY 64
+
+/**
+ * @brief The size in bytes of an encoded player, their packed name followed
+ *        by each of their statistics.
+ */
+#define STATS_ENTRY_SIZE (4 * (4 + STATS_NUM_SQUARES))
+
+/**
+ * @brief The most players encoded together, so that they fit in a record of
+ *        a journal (see journal.h).
+ */
+#define STATS_RECORD_MAX_PLAYERS 1024
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing the statistics of a player.
+ *
+ * @var StatsRow::games
+ * The number of games played.
+ *
+ * @var StatsRow::wins
+ * The number of games won.
+ *
+ * @var StatsRow::turns
+ * The number of turns played in every game.
+ *
+ * @var StatsRow::landings
+ * The number of landings on each kind of special square.
+ */
+typedef struct StatsRow {
+  int games;                        ///< The number of games played.
+  int wins;                         ///< The number of games won.
+  int turns;                        ///< The number of turns played.
+  int landings[STATS_NUM_SQUARES];  ///< The landings on each kind of square.
+} StatsRow;
+
+/**
+ * @brief A struct representing the moves of the players of a game.
+ *
+ * @var GameTally::keys
+ * The packed names of the players.
+ *
+ * @var GameTally::rows
+ * The statistics of each player in the game.
+ *
+ * @var GameTally::num_players
+ * The number of players.
+ */
+typedef struct GameTally {
+  unsigned keys[MAX_NUM_PLAYERS];  ///< The packed names of the players.
+  StatsRow rows[MAX_NUM_PLAYERS];  ///< The statistics of each player.
+  int num_players;                 ///< The number of players.
+} GameTally;
+
+/**
+ * @brief A struct representing the statistics of the players, one column per
+ *        statistic.
+ *
+ * @var PlayerStats::index
+ * The slot of each packed name.
+ *
+ * @var PlayerStats::keys
+ * The packed name of the player in each slot.
+ *
+ * @var PlayerStats::games
+ * The number of games played by the player in each slot.
+ *
+ * @var PlayerStats::wins
+ * The number of games won by the player in each slot.
+ *
+ * @var PlayerStats::turns
+ * The number of turns played by the player in each slot.
+ *
+ * @var PlayerStats::landings
+ * For each kind of special square, the number of landings of the player in
+ * each slot.
+ *
+ * @var PlayerStats::num_players
+ * The number of players, who take the first slots.
+ *
+ * @var PlayerStats::capacity
+ * The number of slots allocated.
+ */
+typedef struct PlayerStats {
+  NameIndex *index;                  ///< The slot of each packed name.
+  unsigned *keys;                    ///< The packed names.
+  int *games;                        ///< The games played.
+  int *wins;                         ///< The games won.
+  int *turns;                        ///< The turns played.
+  int *landings[STATS_NUM_SQUARES];  ///< The landings on each kind of square.
+  int num_players;                   ///< The number of players.
+  int capacity;                      ///< The number of slots allocated.
+} PlayerStats;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Empties a tally.
+ *
+ * @param[out] t The tally.
+ *
+ * @return void.
+ */
+void clear_game_tally(GameTally *t);
+
+/**
+ * @brief Finds the statistics of a player in a tally, adding the player if
+ *        they are not in it.
+ *
+ * @param[in,out] t   The tally.
+ * @param[in]     key The packed name of the player.
+ *
+ * @return The statistics of the player in the game.
+ *
+ * @throws VALUE_OUT_OF_BOUND_ERROR If the player is not in the tally and it
+ *                                  already has @c MAX_NUM_PLAYERS players.
+ */
+StatsRow *tally_player(GameTally *t, const unsigned key);
+
+/**
+ * @brief Counts a landing on a square of the board, if it is special.
+ *
+ * @param[in,out] row    The statistics of the player.
+ * @param[in]     square The value of the square (see board.h).
+ *
+ * @return void.
+ */
+void tally_landing(StatsRow *row, const int square);
+
+/**
+ * @brief Allocates a table without players.
+ *
+ * @return A pointer to the table, to free with @c free_player_stats().
+ *
+ * @throws ALLOCATION_ERROR If the table can not be allocated.
+ */
+PlayerStats *new_player_stats(void);
+
+/**
+ * @brief Frees a table allocated with @c new_player_stats().
+ *
+ * @param[in,out] s The table, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void free_player_stats(PlayerStats *s);
+
+/**
+ * @brief Finds the slot of a player, adding them without any game if they
+ *        are not in the table.
+ *
+ * @param[in,out] s   The table.
+ * @param[in]     key The packed name of the player.
+ *
+ * @return The slot of the player.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+int add_stats_player(PlayerStats *s, const unsigned key);
+
+/**
+ * @brief Adds the statistics of the players of a game to the table.
+ *
+ * @param[in,out] s     The table.
+ * @param[in]     t     The tally of the game.
+ * @param[out]    slots The slot of each player of the tally.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+void add_game_tally(PlayerStats *s, const GameTally *t, int slots[]);
+
+/**
+ * @brief Gets the statistics of a player.
+ *
+ * @param[in]  s   The table.
+ * @param[in]  key The packed name of the player.
+ * @param[out] row The statistics of the player, if found.
+ *
+ * @return @c TRUE if the player is in the table, @c FALSE otherwise.
+ */
+int get_stats_row(const PlayerStats *s, const unsigned key, StatsRow *row);
+
+/**
+ * @brief Sums a statistic over every player.
+ *
+ * The column is read from start to end with nothing else in the loop, so the
+ * compiler adds several players at once with vector instructions.
+ *
+ * @param[in] column      The column of the statistic, such as
+ *                        @c PlayerStats::turns.
+ * @param[in] num_players The number of players of the table.
+ *
+ * @return The sum of the statistic.
+ */
+long long sum_stats_column(const int column[], const int num_players);
+
+/**
+ * @brief Encodes the players of a list of slots and advances the cursor.
+ *
+ * @param[out] cursor The position where the players are written, with at
+ *                    least @e count * @c STATS_ENTRY_SIZE bytes available.
+ * @param[in]  s      The table.
+ * @param[in]  slots  The slots of the players.
+ * @param[in]  count  The number of players.
+ *
+ * @return The position right after the encoded players.
+ */
+unsigned char *encode_player_stats(unsigned char *cursor, const PlayerStats *s,
+                                   const int slots[], const int count);
+
+/**
+ * @brief Checks whether players encoded with @c encode_player_stats() are
+ *        valid, without decoding them.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[in] data The bytes of the players.
+ * @param[in] size The size in bytes of the players.
+ *
+ * @return @c TRUE if the players are valid, @c FALSE otherwise.
+ */
+int are_player_stats_valid(const unsigned char data[], const int size);
+
+/**
+ * @brief Decodes players encoded with @c encode_player_stats() into the
+ *        table, replacing their statistics if they are already in.
+ *
+ * @param[in]     data The bytes of the players.
+ * @param[in]     size The size in bytes of the players.
+ * @param[in,out] s    The table.
+ *
+ * @return @c TRUE if the players are valid, @c FALSE otherwise, in which case
+ *         the table is left unchanged.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+int decode_player_stats(const unsigned char data[], const int size,
+                        PlayerStats *s);
+
+#endif  // !PLAYERSTATS_H
@@ -0,0 +1,204 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file ranking.h
+ * @brief Header file for the ordered set of entries behind the leaderboard.
+ *
+ * The entries are kept in an AVL tree ordered by rank, that is by score from
+ * the highest and then by name. Every node also stores the size of its
+ * subtree, so that the rank of an entry and the entry at a given rank are
+ * found in O(log n) without walking the entries before it. The node of each
+ * player is found from their name through a hash index (see nameindex.h), so
+ * that finding an entry takes constant time.
+ *
+ * A player has at most one entry, holding their best score. Entries are never
+ * removed, so the nodes are allocated from an array that only grows and a node
+ * keeps its index for the whole life of the ranking.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 01:05
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RANKING_H
+#define RANKING_H
+
+#include "./nameindex.h"
+#include "./types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of nodes allocated for an empty ranking.
+ */
+#define RANKING_INITIAL_CAPACITY 64
+
+/**
+ * @brief The index of a missing node.
+ */
+#define RANK_NO_NODE -1
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing the links of a node inside the tree.
+ *
+ * @var RankLinks::left
+ * The index of the left child, or @c RANK_NO_NODE.
+ *
+ * @var RankLinks::right
+ * The index of the right child, or @c RANK_NO_NODE.
+ *
+ * @var RankLinks::height
+ * The height of the subtree rooted at the node.
+ *
+ * @var RankLinks::size
+ * The number of nodes of the subtree rooted at the node.
+ */
+typedef struct RankLinks {
+  int left;    ///< The index of the left child.
+  int right;   ///< The index of the right child.
+  int height;  ///< The height of the subtree.
+  int size;    ///< The number of nodes of the subtree.
+} RankLinks;
+
+/**
+ * @brief A struct representing an entry of the ranking.
+ *
+ * @var RankNode::entry
+ * The entry.
+ *
+ * @var RankNode::by_rank
+ * The links of the node inside the tree ordered by rank.
+ */
+typedef struct RankNode {
+  Entry entry;        ///< The entry.
+  RankLinks by_rank;  ///< The links inside the tree ordered by rank.
+} RankNode;
+
+/**
+ * @brief A struct representing a set of entries ordered by rank.
+ *
+ * @var Ranking::nodes
+ * The nodes, in the order their entries were added.
+ *
+ * @var Ranking::num_entries
+ * The number of entries.
+ *
+ * @var Ranking::capacity
+ * The number of nodes allocated.
+ *
+ * @var Ranking::rank_root
+ * The root of the tree ordered by rank.
+ *
+ * @var Ranking::names
+ * The node of each player, by name.
+ */
+typedef struct Ranking {
+  RankNode *nodes;   ///< The nodes.
+  int num_entries;   ///< The number of entries.
+  int capacity;      ///< The number of nodes allocated.
+  int rank_root;     ///< The root of the tree ordered by rank.
+  NameIndex *names;  ///< The node of each player.
+} Ranking;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Allocates an empty ranking.
+ *
+ * @return A pointer to the ranking, to free with @c free_ranking().
+ *
+ * @throws ALLOCATION_ERROR If the ranking can not be allocated.
+ */
+Ranking *new_ranking(void);
+
+/**
+ * @brief Frees a ranking allocated with @c new_ranking().
+ *
+ * @param[in,out] r The ranking, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void free_ranking(Ranking *r);
+
+/**
+ * @brief Adds an entry to the ranking, or raises the score of the entry of the
+ *        same player.
+ *
+ * The entry of the player is found in constant time, and moving it to its new
+ * rank takes O(log n) time. An entry whose score is not higher is left where
+ * it is in constant time.
+ *
+ * @param[in,out] r The ranking.
+ * @param[in]     e The entry.
+ *
+ * @return @c TRUE if the ranking changed, @c FALSE if the player already has
+ *         an entry with a score not lower than the given one.
+ *
+ * @throws ALLOCATION_ERROR If the ranking can not grow.
+ */
+int upsert_ranking(Ranking *r, const Entry *e);
+
+/**
+ * @brief Gets the number of entries of the ranking.
+ *
+ * @param[in] r The ranking.
+ *
+ * @return The number of entries.
+ */
+int get_num_ranked(const Ranking *r);
+
+/**
+ * @brief Finds the entry of a player.
+ *
+ * It takes constant time.
+ *
+ * @param[in]  r    The ranking.
+ * @param[in]  name The name of the player.
+ * @param[out] e    The entry of the player, if found.
+ *
+ * @return @c TRUE if the player has an entry, @c FALSE otherwise.
+ */
+int find_ranked(const Ranking *r, const char name[], Entry *e);
+
+/**
+ * @brief Gets the rank of a player.
+ *
+ * Players with the same score share the same rank, that is one more than the
+ * number of players with a higher score. It takes O(log n) time.
+ *
+ * @param[in] r    The ranking.
+ * @param[in] name The name of the player.
+ *
+ * @return The rank, starting from 1, or @c INDEX_NOT_FOUND if the player has
+ *         no entry.
+ */
+int get_rank(const Ranking *r, const char name[]);
+
+/**
+ * @brief Copies a range of consecutive entries in order of rank.
+ *
+ * It takes O(log n + count) time, so the top entries are read without walking
+ * the whole ranking.
+ *
+ * @param[in]  r       The ranking.
+ * @param[in]  first   The position of the first entry, starting from 0.
+ * @param[in]  count   The maximum number of entries to copy.
+ * @param[out] entries The entries, with room for @e count entries.
+ *
+ * @return The number of entries copied.
+ */
+int get_ranked_entries(const Ranking *r, const int first, const int count,
+                       Entry entries[]);
+
+#endif  // !RANKING_H
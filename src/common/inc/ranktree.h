@@ -0,0 +1,348 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file ranktree.h
+ * @brief Header file for the leaderboard file, a B+tree of fixed-size pages
+ *        mapped in memory.
+ *
+ * The file is made of @c RANK_TREE_PAGE_SIZE byte pages. The first two pages
+ * are meta pages, and the other ones are the nodes of two B+trees holding the
+ * same entries: one ordered by rank, that is by score from the highest and
+ * then by name, and one ordered by name. Every child of an inner node of the
+ * trees comes with the number of entries below it, so that the rank of an
+ * entry and the entries at a given rank are found by walking a single path
+ * down the tree.
+ *
+ *   page      content
+ *   0, 1      meta pages: magic, version, generation, roots, counts, crc32c
+ *   2...      nodes: kind, count, records or children, crc32c
+ *
+ * The file is mapped read-only when opened, and only the meta pages are read,
+ * so opening a leaderboard takes the same time whatever its size, and a query
+ * only touches the pages on its path.
+ *
+ * Pages are never written in place. An update copies the nodes it changes to
+ * new pages appended to the file, and then writes the new roots to the meta
+ * page not holding the latest ones. Each meta page has a generation and a
+ * checksum, and the valid one with the highest generation is used, so a crash
+ * while updating leaves the file as it was before the update. The pages
+ * appended since the file was mapped are kept in memory until it is mapped
+ * again. Once the pages no longer used outnumber the ones in use the file is
+ * rebuilt from scratch by the I/O pool, right after the update that left them,
+ * and every page is kept in memory until the file is mapped again before the
+ * next update.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 02:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RANKTREE_H
+#define RANKTREE_H
+
+#include "./iopool.h"
+#include "./nameindex.h"
+#include "./string.h"
+#include "./types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The size in bytes of a page of the leaderboard file.
+ */
+#define RANK_TREE_PAGE_SIZE 4096
+
+/**
+ * @brief The magic bytes at the start of a meta page.
+ */
+#define RANK_TREE_MAGIC "GLBT"
+
+/**
+ * @brief The length of @c RANK_TREE_MAGIC.
+ */
+#define RANK_TREE_MAGIC_LEN 4
+
+/**
+ * @brief The version of the format of the leaderboard file.
+ */
+#define RANK_TREE_VERSION 1
+
+/**
+ * @brief The number of pages appended since the file was mapped above which
+ *        it is mapped again.
+ */
+#define RANK_TREE_MAX_FRESH_PAGES 256
+
+/**
+ * @brief The number of pages no longer used below which the file is never
+ *        rebuilt.
+ */
+#define RANK_TREE_COMPACT_PAGES 64
+
+/**
+ * @brief The rank returned for a player without an entry.
+ */
+#define RANK_TREE_NOT_FOUND -1
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing an open leaderboard file.
+ *
+ * @var RankTree::path
+ * The path of the file.
+ *
+ * @var RankTree::file
+ * The handle of the opened file.
+ *
+ * @var RankTree::mapping
+ * The handle of the mapping of the file.
+ *
+ * @var RankTree::data
+ * The pages mapped, read-only.
+ *
+ * @var RankTree::num_mapped
+ * The number of pages mapped.
+ *
+ * @var RankTree::fresh
+ * The pages appended since the file was mapped, starting from page
+ * @c num_mapped.
+ *
+ * @var RankTree::fresh_capacity
+ * The number of pages allocated in @c fresh.
+ *
+ * @var RankTree::generation
+ * The generation of the latest meta page.
+ *
+ * @var RankTree::rank_root
+ * The root of the tree ordered by rank, or @c -1 if it is empty.
+ *
+ * @var RankTree::name_root
+ * The root of the tree ordered by name, or @c -1 if it is empty.
+ *
+ * @var RankTree::num_entries
+ * The number of entries.
+ *
+ * @var RankTree::num_pages
+ * The number of pages of the file, including the ones no longer used.
+ *
+ * @var RankTree::num_dead
+ * The number of pages no longer used.
+ *
+ * @var RankTree::first_new
+ * The first page appended by the update being made, which can be changed in
+ * place.
+ *
+ * @var RankTree::is_rebuilt
+ * Whether the file is being rebuilt by the I/O pool, so that every page is
+ * kept in memory and the file is mapped again before the next update.
+ *
+ * @var RankTree::scores
+ * The score of each player, by name, read from the file on the first update,
+ * or @c NULL.
+ */
+typedef struct RankTree {
+  char path[MAX_BUFFER_LEN];  ///< The path of the file.
+  void *file;                 ///< The handle of the opened file.
+  void *mapping;              ///< The handle of the mapping of the file.
+  const unsigned char *data;  ///< The pages mapped.
+  int num_mapped;             ///< The number of pages mapped.
+  unsigned char *fresh;       ///< The pages appended since mapped.
+  int fresh_capacity;         ///< The number of pages allocated in fresh.
+  int generation;             ///< The generation of the latest meta page.
+  int rank_root;              ///< The root of the tree ordered by rank.
+  int name_root;              ///< The root of the tree ordered by name.
+  int num_entries;            ///< The number of entries.
+  int num_pages;              ///< The number of pages of the file.
+  int num_dead;               ///< The number of pages no longer used.
+  int first_new;              ///< The first page of the current update.
+  int is_rebuilt;             ///< Whether the file is being rebuilt.
+  NameIndex *scores;          ///< The score of each player.
+} RankTree;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Opens a leaderboard file and maps it in memory.
+ *
+ * Only the meta pages are read. An empty file is a valid leaderboard without
+ * entries. The writes still queued on the file are waited for first.
+ *
+ * @param[in] path The path of the file.
+ *
+ * @return A pointer to the opened file, to close with @c close_rank_tree().
+ *
+ * @throws FILE_NOT_READABLE_ERROR      If the file can not be read.
+ * @throws CORRUPTED_LEADERBOARD_ERROR If no meta page is valid.
+ */
+RankTree *open_rank_tree(const char path[]);
+
+/**
+ * @brief Unmaps and closes a leaderboard file opened with
+ *        @c open_rank_tree().
+ *
+ * @param[in,out] t The leaderboard file, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void close_rank_tree(RankTree *t);
+
+/**
+ * @brief Gets the number of entries of a leaderboard file.
+ *
+ * @param[in] t The leaderboard file.
+ *
+ * @return The number of entries.
+ */
+int get_tree_size(const RankTree *t);
+
+/**
+ * @brief Finds the entry of a player.
+ *
+ * @param[in]  t    The leaderboard file.
+ * @param[in]  name The name of the player.
+ * @param[out] e    The entry of the player, if found.
+ *
+ * @return @c TRUE if the player has an entry, @c FALSE otherwise.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int find_in_tree(const RankTree *t, const char name[], Entry *e);
+
+/**
+ * @brief Gets the rank of a player.
+ *
+ * Players with the same score share the same rank, that is one more than the
+ * number of players with a higher score.
+ *
+ * @param[in] t    The leaderboard file.
+ * @param[in] name The name of the player.
+ *
+ * @return The rank, starting from 1, or @c RANK_TREE_NOT_FOUND if the player
+ *         has no entry.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int get_tree_rank(const RankTree *t, const char name[]);
+
+/**
+ * @brief Gets the rank shared by the players with a score.
+ *
+ * @param[in] t     The leaderboard file.
+ * @param[in] score The score.
+ *
+ * @return One more than the number of players with a higher score.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int get_score_rank(const RankTree *t, const int score);
+
+/**
+ * @brief Gets the position of the entry of a player in order of rank.
+ *
+ * Unlike the rank, the position tells apart players with the same score, so
+ * that the entry is found with @c get_tree_entries().
+ *
+ * @param[in] t    The leaderboard file.
+ * @param[in] name The name of the player.
+ *
+ * @return The position, starting from 0, or @c RANK_TREE_NOT_FOUND if the
+ *         player has no entry.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int get_tree_position(const RankTree *t, const char name[]);
+
+/**
+ * @brief Copies a range of consecutive entries in order of rank.
+ *
+ * Only the pages holding the entries and the pages on the way down to them
+ * are read, each of them once.
+ *
+ * @param[in]  t       The leaderboard file.
+ * @param[in]  first   The position of the first entry, starting from 0.
+ * @param[in]  count   The maximum number of entries to copy.
+ * @param[out] entries The entries, with room for @e count entries.
+ *
+ * @return The number of entries copied.
+ *
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+int get_tree_entries(const RankTree *t, const int first, const int count,
+                     Entry entries[]);
+
+/**
+ * @brief Adds a batch of entries to a leaderboard file, or raises the scores
+ *        of the entries of the same players.
+ *
+ * The pages changed by the whole batch are appended to the file along with a
+ * single new meta page, so the batch is written at once and a crash leaves
+ * either all of it or none of it. If too many of its pages are no longer used,
+ * the whole file is then rebuilt by the I/O pool in the same request, the
+ * caller only copying the mapped pages to memory instead of laying out every
+ * entry again. The next update waits for the file to be rebuilt before mapping
+ * it again.
+ *
+ * The score of each player is looked up in an index of the names kept in
+ * memory, so that an entry that does not change is found in constant time
+ * without reading any page. The index is read from the file on the first
+ * update, which takes O(n) time once.
+ *
+ * @param[in,out] t           The leaderboard file.
+ * @param[in]     entries     The entries, in any order, several of them
+ *                            possibly of the same player.
+ * @param[in]     num_entries The number of entries.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h), or
+ *         @c NULL if every player already has an entry with a score not lower
+ *         than the given one.
+ *
+ * @throws ALLOCATION_ERROR            If the pages can not be laid out.
+ * @throws FILE_NOT_READABLE_ERROR     If the file can not be mapped again.
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a page does not match its checksum.
+ */
+IoRequest *upsert_rank_tree(RankTree *t, const Entry entries[],
+                            const int num_entries);
+
+/**
+ * @brief Lays out a whole leaderboard file.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[in]  entries     The entries, in order of rank, with no two entries
+ *                         of the same player.
+ * @param[in]  num_entries The number of entries.
+ * @param[out] size        The size in bytes of the file.
+ *
+ * @return The bytes of the file, allocated with @c malloc(), or @c NULL if
+ *         they can not be allocated.
+ */
+unsigned char *layout_rank_tree(const Entry entries[], const int num_entries,
+                                int *size);
+
+/**
+ * @brief Replaces a leaderboard file with a new one holding the given entries.
+ *
+ * @param[in] path        The path of the file, which must not be open.
+ * @param[in] entries     The entries, in order of rank, with no two entries
+ *                        of the same player.
+ * @param[in] num_entries The number of entries.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws ALLOCATION_ERROR If the file can not be laid out.
+ */
+IoRequest *write_rank_tree(const char path[], const Entry entries[],
+                           const int num_entries);
+
+#endif  // !RANKTREE_H
@@ -0,0 +1,315 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file rating.h
+ * @brief Header file for the Elo ratings of the players.
+ *
+ * A game of n players is rated as the n(n - 1)/2 matches between each pair of
+ * them: the player finishing ahead wins the match, and players finishing
+ * together draw it. Each player then moves by @c RATING_K times the score of
+ * their matches minus the score their rating expected, divided by n - 1, so a
+ * game moves a rating as much as a single match whatever the number of
+ * players.
+ *
+ * Ratings are kept in hundredths of a point, so that they are exact integers
+ * that are stored and replayed without drifting.
+ *
+ * The table is laid out in columns, one array per field, indexed by a dense
+ * slot that the index of packed names (see nameindex.h) gives for each
+ * player, so a rating is found in constant time.
+ *
+ * The ratings of a game depend on the ones left by the games before it, but
+ * two games without players in common can be rated in any order. A batch of
+ * games is therefore split into rounds, each game going to the round after the
+ * last one of any of its players, and the games of a round are rated by
+ * several threads at once, which gives the same ratings as rating the games
+ * one at a time.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 09:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RATING_H
+#define RATING_H
+
+#include "./nameindex.h"
+#include "./types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of hundredths of a point in a point of rating.
+ */
+#define RATING_SCALE 100
+
+/**
+ * @brief The rating of a player who has never been rated, in hundredths of a
+ *        point.
+ */
+#define RATING_INITIAL (1500 * RATING_SCALE)
+
+/**
+ * @brief The most points a rating can move in a game.
+ */
+#define RATING_K 32
+
+/**
+ * @brief The difference of rating, in points, at which the higher rated
+ *        player is expected to win 10 matches out of 11.
+ */
+#define RATING_SPREAD 400
+
+/**
+ * @brief The number of players the table has room for when it is allocated.
+ */
+#define RATING_INITIAL_CAPACITY 64
+
+/**
+ * @brief The number of threads rating the games of a round.
+ */
+#define RATING_THREADS 4
+
+/**
+ * @brief The number of games of a round below which it is rated by the
+ *        calling thread alone, since starting threads would take longer.
+ */
+#define RATING_MIN_PARALLEL_GAMES 1024
+
+/**
+ * @brief The size in bytes of an encoded player, their packed name, their
+ *        rating and their number of rated games.
+ */
+#define RATING_ENTRY_SIZE 12
+
+/**
+ * @brief The most players encoded together, so that they fit in a record of
+ *        a journal (see journal.h).
+ */
+#define RATING_RECORD_MAX_PLAYERS 4096
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing how the players of a game finished it.
+ *
+ * @var GameOutcome::keys
+ * The packed names of the players (see nameindex.h).
+ *
+ * @var GameOutcome::places
+ * The place of each player, starting from 0 for the winner, the players
+ * finishing together sharing the same place.
+ *
+ * @var GameOutcome::num_players
+ * The number of players.
+ */
+typedef struct GameOutcome {
+  unsigned keys[MAX_NUM_PLAYERS];  ///< The packed names of the players.
+  int places[MAX_NUM_PLAYERS];     ///< The place of each player.
+  int num_players;                 ///< The number of players.
+} GameOutcome;
+
+/**
+ * @brief A struct representing the ratings of the players, one column per
+ *        field.
+ *
+ * @var RatingTable::index
+ * The slot of each packed name.
+ *
+ * @var RatingTable::keys
+ * The packed name of the player in each slot.
+ *
+ * @var RatingTable::ratings
+ * The rating of the player in each slot, in hundredths of a point.
+ *
+ * @var RatingTable::num_games
+ * The number of rated games of the player in each slot.
+ *
+ * @var RatingTable::num_players
+ * The number of players, who take the first slots.
+ *
+ * @var RatingTable::capacity
+ * The number of slots allocated.
+ */
+typedef struct RatingTable {
+  NameIndex *index;  ///< The slot of each packed name.
+  unsigned *keys;    ///< The packed names.
+  int *ratings;      ///< The ratings.
+  int *num_games;    ///< The numbers of rated games.
+  int num_players;   ///< The number of players.
+  int capacity;      ///< The number of slots allocated.
+} RatingTable;
+
+/**
+ * @brief A struct representing a part of a round handed over to a thread.
+ *
+ * @var RatingJob::table
+ * The table, whose players have all been added already.
+ *
+ * @var RatingJob::games
+ * The outcomes of the games of the batch.
+ *
+ * @var RatingJob::slots
+ * The slots of the players of each game of the batch, @c MAX_NUM_PLAYERS per
+ * game.
+ *
+ * @var RatingJob::order
+ * The games of the batch, round after round.
+ *
+ * @var RatingJob::first
+ * The position in @c order of the first game rated by the thread.
+ *
+ * @var RatingJob::last
+ * The position in @c order right after the last game rated by the thread.
+ *
+ * @var RatingJob::thread
+ * The handle of the thread, or @c NULL if no thread has been started.
+ */
+typedef struct RatingJob {
+  RatingTable *table;        ///< The table.
+  const GameOutcome *games;  ///< The outcomes of the games.
+  const int *slots;          ///< The slots of the players of each game.
+  const int *order;          ///< The games, round after round.
+  int first;                 ///< The first game rated.
+  int last;                  ///< Right after the last game rated.
+  void *thread;              ///< The handle of the thread.
+} RatingJob;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Allocates a table without players.
+ *
+ * @return A pointer to the table, to free with @c free_rating_table().
+ *
+ * @throws ALLOCATION_ERROR If the table can not be allocated.
+ */
+RatingTable *new_rating_table(void);
+
+/**
+ * @brief Frees a table allocated with @c new_rating_table().
+ *
+ * @param[in,out] t The table, or @c NULL to do nothing.
+ *
+ * @return void.
+ */
+void free_rating_table(RatingTable *t);
+
+/**
+ * @brief Finds the slot of a player, adding them with the initial rating if
+ *        they are not in the table.
+ *
+ * @param[in,out] t   The table.
+ * @param[in]     key The packed name of the player.
+ *
+ * @return The slot of the player.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+int add_rated_player(RatingTable *t, const unsigned key);
+
+/**
+ * @brief Gets the rating of a player.
+ *
+ * @param[in] t   The table.
+ * @param[in] key The packed name of the player.
+ *
+ * @return The rating in hundredths of a point, @c RATING_INITIAL if the
+ *         player has never been rated.
+ */
+int get_rating(const RatingTable *t, const unsigned key);
+
+/**
+ * @brief Gets the number of rated games of a player.
+ *
+ * @param[in] t   The table.
+ * @param[in] key The packed name of the player.
+ *
+ * @return The number of games, 0 if the player has never been rated.
+ */
+int get_rated_games(const RatingTable *t, const unsigned key);
+
+/**
+ * @brief Rates a game.
+ *
+ * @param[in,out] t       The table.
+ * @param[in]     g       The outcome of the game.
+ * @param[out]    changes The change of rating of each player of the game, in
+ *                        hundredths of a point, or @c NULL.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+void rate_game(RatingTable *t, const GameOutcome *g, int changes[]);
+
+/**
+ * @brief Rates games in the order given, rating the games of a round with
+ *        several threads.
+ *
+ * @param[in,out] t         The table.
+ * @param[in]     games     The outcomes of the games.
+ * @param[in]     num_games The number of games.
+ *
+ * @return void.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow or the rounds can not be
+ *                          allocated.
+ */
+void rate_games(RatingTable *t, const GameOutcome games[],
+                const int num_games);
+
+/**
+ * @brief Encodes the players of a range of slots and advances the cursor.
+ *
+ * @param[out] cursor The position where the players are written, with at
+ *                    least @e count * @c RATING_ENTRY_SIZE bytes available.
+ * @param[in]  t      The table.
+ * @param[in]  slots  The slots of the players.
+ * @param[in]  count  The number of players.
+ *
+ * @return The position right after the encoded players.
+ */
+unsigned char *encode_ratings(unsigned char *cursor, const RatingTable *t,
+                              const int slots[], const int count);
+
+/**
+ * @brief Checks whether players encoded with @c encode_ratings() are valid,
+ *        without decoding them.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[in] data The bytes of the players.
+ * @param[in] size The size in bytes of the players.
+ *
+ * @return @c TRUE if the players are valid, @c FALSE otherwise.
+ */
+int are_ratings_valid(const unsigned char data[], const int size);
+
+/**
+ * @brief Decodes players encoded with @c encode_ratings() into the table,
+ *        replacing their rating if they are already in.
+ *
+ * @param[in]     data The bytes of the players.
+ * @param[in]     size The size in bytes of the players.
+ * @param[in,out] t    The table.
+ *
+ * @return @c TRUE if the players are valid, @c FALSE otherwise, in which case
+ *         the table is left unchanged.
+ *
+ * @throws ALLOCATION_ERROR If the table can not grow.
+ */
+int decode_ratings(const unsigned char data[], const int size,
+                   RatingTable *t);
+
+#endif  // !RATING_H
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file rng.h
+ * @brief Header file for the seedable random number generator.
+ *
+ * This file declares a PCG32 generator: a 64 bit linear congruential state
+ * whose output is permuted into 32 bits. Unlike rand(), the whole sequence is
+ * determined by the seed and the stream the generator starts from, on any
+ * machine and with any C library, so that a game can be played again from its
+ * seed.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 22:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RNG_UTILS_H
+#define RNG_UTILS_H
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The multiplier of the state of the generator.
+ */
+#define RNG_MULTIPLIER 6364136223846793005ULL
+
+/**
+ * @brief The initializer of a generator that has not been seeded yet.
+ *
+ * A generator must never be left zeroed, since its increment must be odd.
+ */
+#define RNG_INITIALIZER {0x853C49E6748FEA9BULL, 0xDA3E39CB94B95BDBULL}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a random number generator.
+ *
+ * @var Rng::state
+ * The current state, advanced at every number.
+ *
+ * @var Rng::inc
+ * The increment of the state, always odd, selecting the stream.
+ */
+typedef struct Rng {
+  unsigned long long state;  ///< The current state.
+  unsigned long long inc;    ///< The increment of the state.
+} Rng;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Starts a generator from a seed.
+ *
+ * @param[out] rng    The generator.
+ * @param[in]  seed   The seed.
+ * @param[in]  stream The stream: generators with the same seed and different
+ *                    streams give unrelated sequences.
+ *
+ * @return void.
+ */
+void seed_rng(Rng *rng, const unsigned long long seed,
+              const unsigned long long stream);
+
+/**
+ * @brief Draws the next number of a generator.
+ *
+ * @param[in,out] rng The generator.
+ *
+ * @return A number in [0, 2^32).
+ */
+unsigned next_rng(Rng *rng);
+
+/**
+ * @brief Draws a number below a bound, with every number equally likely.
+ *
+ * @param[in,out] rng   The generator.
+ * @param[in]     bound The bound, greater than zero.
+ *
+ * @return A number in [0, @c bound).
+ */
+int next_rng_below(Rng *rng, const int bound);
+
+#endif  // !RNG_UTILS_H
@@ -0,0 +1,500 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file savefile.h
+ * @brief Header file for the on-disk format of the saved games.
+ *
+ * This file declares the functions to write the saved games to a file and to
+ * read them back in place from a memory mapped view of the file, without
+ * copying them into @c GameState structs.
+ *
+ * Every integer in the file is stored in little-endian order, regardless of the
+ * machine that wrote it, and every variable length field is prefixed by its
+ * length. The file is laid out as follows:
+ *
+ * @code
+ * header       magic "GSAV" (4) | version u16 | reserved u16 | saves u32
+ *              | index_offset u32 | index_size u32
+ * records      { game (see codec.h) }
+ * index        offset table  saves x { summary_offset u32 | summary_size u32
+ *                                      | record_offset u32 | record_size u32
+ *                                      | summary_crc u32 | record_crc u32 }
+ *              summaries     saves x { saved_at i64 | used_at i64
+ *                                      | name_len u16 | name | players u8
+ *                                      | players x { username (3)
+ *                                                    | position i32 }
+ *                                      | dim u8 }
+ * @endcode
+ *
+ * The offset table and the summaries make up the index of the file, whose
+ * offset and size are stored in the header: listing the saves only reads the
+ * index, the record of a game is only read when the game is loaded. Offsets
+ * are counted from the start of the file. Records use the compact encoding of
+ * codec.h, while summaries keep fixed size players so that they can be read in
+ * place.
+ *
+ * Saving a game appends its record and a new index at the end of the file,
+ * without rewriting the other records, and then points the header to the new
+ * index. Replaced records and old indexes are left in the file until they take
+ * more than half of it, then the file is compacted.
+ *
+ * The bytes are written and the file is compacted by the I/O pool (see
+ * iopool.h), but the caller still maps the file and lays out the new index,
+ * once the writes queued on the file are done. Saving a game therefore takes
+ * time linear in the number of saves, though not in the size of their records,
+ * and it waits for a previous save still being written.
+ *
+ * Every summary and every record has a CRC32C checksum (see crc.h) in the
+ * offset table. The checksum of a summary skips its two timestamps, so that the
+ * time of last use can be updated in place. A save whose summary or record does
+ * not match its checksum is skipped rather than making the whole file
+ * unreadable, and it is dropped the next time the file is written.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 21:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include <time.h>
+
+#include "./iopool.h"
+#include "./types/gamestate.h"
+#include "./types/gamestates.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The bytes every save file starts with.
+ */
+#define SAVE_MAGIC "GSAV"
+
+/**
+ * @brief The number of bytes of @c SAVE_MAGIC.
+ */
+#define SAVE_MAGIC_LEN 4
+
+/**
+ * @brief The version of the format written by this program.
+ */
+#define SAVE_VERSION 5
+
+/**
+ * @brief The size in bytes of the header of a save file.
+ */
+#define SAVE_HEADER_SIZE 20
+
+/**
+ * @brief The size in bytes of an entry of the offset table.
+ */
+#define SAVE_TABLE_ENTRY_SIZE 24
+
+/**
+ * @brief The size in bytes of a player inside a summary.
+ */
+#define SAVE_SUMMARY_PLAYER_SIZE (MAX_USERNAME_LENGTH + 4)
+
+/**
+ * @brief The size in bytes of a timestamp of a summary.
+ */
+#define SAVE_TIMESTAMP_SIZE 8
+
+/**
+ * @brief The size in bytes of the timestamps at the start of a summary, the
+ *        time the game was saved at and the time it was last used.
+ */
+#define SAVE_SUMMARY_TIMES_SIZE (2 * SAVE_TIMESTAMP_SIZE)
+
+/**
+ * @brief The timestamp of a save whose date is unknown.
+ */
+#define SAVE_NO_TIMESTAMP 0
+
+/**
+ * @brief Indicates that no save has a given name.
+ */
+#define SAVE_NOT_FOUND -1
+
+/**
+ * @brief The ratio between the size of a save file and the bytes actually used
+ *        by its saves above which the file is compacted.
+ */
+#define SAVE_COMPACT_RATIO 2
+
+/**
+ * @brief The suffix appended to the name of a legacy save file when it is
+ *        migrated, so that the original file is kept as a backup.
+ */
+#define LEGACY_SAVES_SUFFIX ".legacy"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a save file mapped in memory.
+ *
+ * @var SaveFile::data
+ * The bytes of the file, read-only.
+ *
+ * @var SaveFile::size
+ * The size in bytes of the file.
+ *
+ * @var SaveFile::num_saves
+ * The number of valid saves in the file.
+ *
+ * @var SaveFile::num_corrupted
+ * The number of saves skipped because they are corrupted.
+ *
+ * @var SaveFile::index_offset
+ * The offset of the index in the file.
+ *
+ * @var SaveFile::index_size
+ * The size in bytes of the index.
+ *
+ * @var SaveFile::saves
+ * The positions in the offset table of the valid saves.
+ *
+ * @var SaveFile::names
+ * The hash table of the names of the saves, holding their positions or
+ * @c SAVE_NOT_FOUND in empty slots.
+ *
+ * @var SaveFile::names_capacity
+ * The number of slots of the hash table, always a power of two.
+ *
+ * @var SaveFile::file
+ * The handle of the opened file.
+ *
+ * @var SaveFile::mapping
+ * The handle of the mapping of the file.
+ */
+typedef struct SaveFile {
+  const unsigned char *data;  ///< The bytes of the file.
+  int size;                   ///< The size in bytes of the file.
+  int num_saves;              ///< The number of valid saves in the file.
+  int num_corrupted;          ///< The number of corrupted saves skipped.
+  int index_offset;           ///< The offset of the index.
+  int index_size;             ///< The size in bytes of the index.
+  int *saves;                 ///< The table positions of the valid saves.
+  int *names;                 ///< The hash table of the names of the saves.
+  int names_capacity;         ///< The number of slots of the hash table.
+  void *file;                 ///< The handle of the opened file.
+  void *mapping;              ///< The handle of the mapping of the file.
+} SaveFile;
+
+/**
+ * @brief A struct representing the summary of a saved game inside a mapped
+ *        save file.
+ *
+ * A summary only points to the bytes of the file, so it is valid as long as
+ * the file it comes from is open.
+ *
+ * @var SaveSummary::data
+ * The first byte of the summary.
+ *
+ * @var SaveSummary::size
+ * The size in bytes of the summary.
+ */
+typedef struct SaveSummary {
+  const unsigned char *data;  ///< The first byte of the summary.
+  int size;                   ///< The size in bytes of the summary.
+} SaveSummary;
+
+/**
+ * @brief A struct representing a saved game inside a mapped save file.
+ *
+ * A record only points to the bytes of the file, so it is valid as long as the
+ * file it comes from is open.
+ *
+ * @var SaveRecord::data
+ * The first byte of the record.
+ *
+ * @var SaveRecord::size
+ * The size in bytes of the record.
+ */
+typedef struct SaveRecord {
+  const unsigned char *data;  ///< The first byte of the record.
+  int size;                   ///< The size in bytes of the record.
+} SaveRecord;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Opens a save file and maps it in memory.
+ *
+ * The header, the offset table and every summary are checked once here, so
+ * that the accessors below can read the summaries without any further check,
+ * and the names of the saves are indexed for @c find_save(). An empty file is a
+ * valid save file without saves. The writes still queued on the file are
+ * waited for first.
+ *
+ * A save out of the file or whose summary does not match its checksum is
+ * skipped and counted in @c num_corrupted, the other saves keep their order.
+ *
+ * @param[in] path The path of the save file.
+ *
+ * @return A pointer to the opened file, to close with @c close_save_file().
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the file can not be opened or mapped.
+ * @throws CORRUPTED_SAVES_ERROR   If the header is not valid or the file has
+ *                                 an unsupported version.
+ */
+SaveFile *open_save_file(const char path[]);
+
+/**
+ * @brief Unmaps and closes a save file opened with @c open_save_file().
+ *
+ * @param[in,out] sf The save file to close.
+ *
+ * @return void.
+ */
+void close_save_file(SaveFile *sf);
+
+/**
+ * @brief Finds a save by the name of its game.
+ *
+ * The name is looked up in the hash table built when the file is opened, so
+ * only the summaries whose name has the same hash are compared.
+ *
+ * @param[in] sf   The save file.
+ * @param[in] name The null-terminated name of the game.
+ *
+ * @return The position of the save, or @c SAVE_NOT_FOUND.
+ */
+int find_save(const SaveFile *sf, const char name[]);
+
+/**
+ * @brief Gets the summary of a save.
+ *
+ * @param[in] sf    The save file.
+ * @param[in] index The position of the save, in [0, @c num_saves).
+ *
+ * @return The summary, pointing inside the mapped file.
+ */
+SaveSummary get_summary(const SaveFile *sf, const int index);
+
+/**
+ * @brief Gets the time a game was saved at.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return The time the game was saved at, or @c SAVE_NO_TIMESTAMP if unknown.
+ */
+time_t get_summary_timestamp(const SaveSummary *sum);
+
+/**
+ * @brief Gets the time a saved game was last saved or loaded at.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return The time the game was last used at, or @c SAVE_NO_TIMESTAMP if
+ *         unknown.
+ */
+time_t get_summary_last_used(const SaveSummary *sum);
+
+/**
+ * @brief Gets the name of a saved game.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return A pointer to the name inside the file. It is @b not null-terminated,
+ *         its length is given by @c get_summary_name_len().
+ */
+const char *get_summary_name(const SaveSummary *sum);
+
+/**
+ * @brief Gets the length of the name of a saved game.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return The length of the name.
+ */
+int get_summary_name_len(const SaveSummary *sum);
+
+/**
+ * @brief Gets the number of players of a saved game.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return The number of players.
+ */
+int get_summary_players_num(const SaveSummary *sum);
+
+/**
+ * @brief Gets the username of a player of a saved game.
+ *
+ * @param[in] sum    The summary of the saved game.
+ * @param[in] player The position of the player.
+ *
+ * @return A pointer to the username inside the file. It is always
+ *         @c MAX_USERNAME_LENGTH bytes long, padded with null-terminators if
+ *         the username is shorter, so it is @b not null-terminated otherwise.
+ */
+const char *get_summary_username(const SaveSummary *sum, const int player);
+
+/**
+ * @brief Gets the position of a player of a saved game.
+ *
+ * @param[in] sum    The summary of the saved game.
+ * @param[in] player The position of the player.
+ *
+ * @return The position of the player on the board.
+ */
+int get_summary_position(const SaveSummary *sum, const int player);
+
+/**
+ * @brief Gets the dimension of the board of a saved game.
+ *
+ * @param[in] sum The summary of the saved game.
+ *
+ * @return The dimension of the board.
+ */
+int get_summary_dim(const SaveSummary *sum);
+
+/**
+ * @brief Gets the full record of a save.
+ *
+ * The record is checked against its checksum here, the first time it is
+ * accessed, rather than when the file is opened.
+ *
+ * @param[in]  sf    The save file.
+ * @param[in]  index The position of the save, in [0, @c num_saves).
+ * @param[out] rec   The record, pointing inside the mapped file.
+ *
+ * @return @c TRUE if the record has been read, @c FALSE if it is corrupted.
+ */
+int get_record(const SaveFile *sf, const int index, SaveRecord *rec);
+
+/**
+ * @brief Checks that the fields of a record fit inside it.
+ *
+ * @param[in] rec The record to check.
+ *
+ * @return @c TRUE if the record can be decoded, @c FALSE otherwise.
+ */
+int is_record_valid(const SaveRecord *rec);
+
+/**
+ * @brief Copies a saved game into a @c GameState struct.
+ *
+ * This is the only function that copies a record out of the file, it is meant
+ * to be used when a game is actually loaded. Only the dimension of the board
+ * is stored, the caller gets its squares with @c get_cached_board().
+ *
+ * @param[in]  rec The record of the saved game.
+ * @param[out] gs  The game state to fill.
+ *
+ * @return void.
+ */
+void decode_record(const SaveRecord *rec, GameState *gs);
+
+/**
+ * @brief Computes the size in bytes of the record of a game.
+ *
+ * @param[in] gs The game.
+ *
+ * @return The size in bytes of the record.
+ */
+int get_record_size(GameState *gs);
+
+/**
+ * @brief Encodes the record of a game and advances the cursor.
+ *
+ * This is the encoding used by the records of a save file, so that it can be
+ * read back with @c decode_record().
+ *
+ * @param[out] cursor The position where the record is written, with at least
+ *                    @c get_record_size() bytes available.
+ * @param[in]  gs     The game.
+ *
+ * @return The position right after the written record.
+ */
+unsigned char *encode_record(unsigned char *cursor, GameState *gs);
+
+/**
+ * @brief Saves a game in a save file, at a given position.
+ *
+ * The game is encoded with the current time as timestamp and its record is
+ * appended to the file, followed by a new index. The other records are not
+ * rewritten, unless the file needs to be compacted, in which case the I/O pool
+ * rewrites it once the record is appended. The corrupted saves are left out of
+ * the new index. The caller does not wait for the record and the index to be
+ * written nor for the compaction, but it waits for the writes already queued
+ * on the file, then maps it and lays out the new index itself, copying every
+ * summary, in time linear in the number of saves.
+ *
+ * @param[in] path  The path of the save file.
+ * @param[in] gs    The game to save.
+ * @param[in] index The position of the save: the save at that position is
+ *                  overwritten, or the game is appended if it is equal to the
+ *                  number of saves in the file.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the file can not be read.
+ * @throws ALLOCATION_ERROR        If the write can not be laid out.
+ */
+IoRequest *put_save(const char path[], GameState *gs, const int index);
+
+/**
+ * @brief Marks a save as used now, e.g. when it is loaded.
+ *
+ * Only the time of last use of the summary is written, in place.
+ *
+ * @param[in] path  The path of the save file.
+ * @param[in] index The position of the save.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the file can not be read.
+ */
+IoRequest *touch_save(const char path[], const int index);
+
+/**
+ * @brief Converts a save file written by older versions of the game.
+ *
+ * Older versions wrote the raw bytes of a @c GameStates struct. If the file at
+ * the given path is such a file, it is renamed by appending
+ * @c LEGACY_SAVES_SUFFIX and its valid games (see legacy.h) are written to a
+ * new save file at the original path.
+ *
+ * @param[in] path The path of the save file.
+ *
+ * @return @c TRUE if the file has been migrated, @c FALSE if it was already in
+ *         the current format (or empty).
+ *
+ * @throws CORRUPTED_SAVES_ERROR If the legacy file has too many saves.
+ *
+ * @note A legacy file can only be read by a build with the same struct layout
+ *       as the one that wrote it, that is any build of the game for Windows.
+ */
+int migrate_save_file(const char path[]);
+
+/**
+ * @brief Lays out in memory a whole save file holding some games.
+ *
+ * Unlike the other functions of this file it does not log anything, so it can
+ * be called from any thread.
+ *
+ * @param[in]  games     The games, at most @c MAX_SAVED_GAMES.
+ * @param[in]  num_games The number of games.
+ * @param[in]  timestamp The time the games are marked as saved and last used
+ *                       at.
+ * @param[out] size      The size in bytes of the file.
+ *
+ * @return The content of the file, to free with @c free(), or @c NULL if it
+ *         can not be allocated.
+ */
+unsigned char *layout_save_file(GameState games[], const int num_games,
+                                const time_t timestamp, int *size);
+
+#endif  // !SAVEFILE_H
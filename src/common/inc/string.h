@@ -143,6 +143,46 @@ void nconcat(char *buffer, const char source[], const int n_times);
  */
 void fconcat(char *buffer, const int source_size, const char *format, ...);
 
+/**
+ * @brief Copies a fixed number of bytes at a cursor and advances it.
+ *
+ * This function copies exactly @e size bytes of the source string at the
+ * position pointed by @e cursor, and returns the position right after the
+ * copied bytes. Unlike @c concat() it neither scans the buffer for its end nor
+ * formats the source, so it can be used to build long strings piece by piece
+ * in linear time.
+ *
+ * @param[out] cursor The position of the buffer where the bytes are copied.
+ * @param[in]  source The bytes to copy.
+ * @param[in]  size   The number of bytes to copy.
+ *
+ * @return The position of the buffer right after the copied bytes.
+ *
+ * @warning This function does not null-terminate the buffer, it is
+ *          responsibility of the caller to terminate it once done.
+ */
+char *str_put(char *cursor, const char source[], const int size);
+
+/**
+ * @brief Copies a fixed number of bytes at a cursor multiple times and
+ *        advances it.
+ *
+ * This function works like @c str_put(), copying the @e size bytes of the
+ * source string @e n_times times, one after the other.
+ *
+ * @param[out] cursor  The position of the buffer where the bytes are copied.
+ * @param[in]  source  The bytes to copy.
+ * @param[in]  size    The number of bytes to copy each time.
+ * @param[in]  n_times The number of times the source is copied.
+ *
+ * @return The position of the buffer right after the copied bytes.
+ *
+ * @warning This function does not null-terminate the buffer, it is
+ *          responsibility of the caller to terminate it once done.
+ */
+char *str_nput(char *cursor, const char source[], const int size,
+               const int n_times);
+
 /**
  * @brief Allocates a character buffer of a specified size and copies a string
  *        into it.
@@ -220,6 +260,22 @@ void str_copy(char *buffer, const char source[]);
  */
 void str_truncate(char *buffer, const int len);
 
+/**
+ * @brief Computes the number of columns a string takes when printed.
+ *
+ * This function counts the characters of a UTF-8 encoded string, skipping the
+ * continuation bytes of multi-byte characters, so that e.g. "─" (three bytes)
+ * takes a single column.
+ *
+ * @param[in] buffer The null-terminated UTF-8 string to measure.
+ *
+ * @return The number of columns taken by the string.
+ *
+ * @note Every character is assumed to take a single column, which holds for
+ *       ascii and box-drawing characters but not for wide (e.g. CJK) ones.
+ */
+int str_display_width(const char buffer[]);
+
 /**
  * @brief Converts a buffer string to uppercase.
  *
@@ -46,6 +46,22 @@
  * @brief The ASCII value that represents the SPACEBAR key.
  */
 #define SPACEBAR 32
+
+/**
+ * @brief The value @c read_key() adds to the code of a key sent after a
+ *        prefix, such as the arrows and the page keys, so that it can not be
+ *        taken for an ASCII value.
+ */
+#define EXTENDED_KEYS 256
+
+/**
+ * @brief The values @c read_key() returns for the HOME, END, PAGE UP and
+ *        PAGE DOWN keys.
+ */
+#define HOME_KEY (EXTENDED_KEYS + 71)
+#define END_KEY (EXTENDED_KEYS + 79)
+#define PAGE_UP_KEY (EXTENDED_KEYS + 73)
+#define PAGE_DOWN_KEY (EXTENDED_KEYS + 81)
 /** @} */  // End of KeyboardKeys group
 
 // ------------------------------------------------------------
@@ -65,6 +81,19 @@
  */
 #define MAX_FILE_LINES 23
 
+/**
+ * @brief The maximum length of the text of a screen drawn at once.
+ */
+#define SCREEN_BUFFER_LEN 16384
+
+/**
+ * @brief The sequences moving the cursor to the top left corner, erasing the
+ *        rest of the line and erasing the lines below the cursor.
+ */
+#define CURSOR_HOME "\x1B[H"
+#define ERASE_LINE_END "\x1B[K"
+#define ERASE_BELOW "\x1B[J"
+
 // ------------------------------------------------------------
 
 /**
@@ -199,6 +228,27 @@
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
+/**
+ * @brief A struct representing the text of a screen, drawn at once.
+ *
+ * The screen is drawn over the previous one instead of clearing it first,
+ * each line erasing what is left of the previous line after it, so that it
+ * is written to the console with a single call and does not flicker.
+ *
+ * @var ScreenBuffer::text
+ * The text of the screen, with the sequences moving the cursor.
+ *
+ * @var ScreenBuffer::len
+ * The length of @c text.
+ */
+typedef struct ScreenBuffer {
+  char text[SCREEN_BUFFER_LEN];  ///< The text of the screen.
+  int len;                       ///< The length of the text.
+} ScreenBuffer;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
 /**
  * @brief Retrieve the terminal size (width and height).
  *
@@ -214,6 +264,18 @@
  */
 void get_term_size(int *width, int *height);
 
+/**
+ * @brief Makes the console print the UTF-8 text written to it.
+ *
+ * The borders of the non-ascii board themes (see theme.h) are UTF-8 strings,
+ * which the console would otherwise print with its own code page.
+ *
+ * @note This function uses Windows API for console manipulation.
+ *
+ * @return void.
+ */
+void use_utf8_output(void);
+
 /**
  * @brief Clears the terminal screen.
  *
@@ -252,6 +314,45 @@ void clear_line();
  */
 void new_screen();
 
+/**
+ * @brief Starts the text of a screen drawn at once.
+ *
+ * The text starts from the top left corner of the console, with the title bar
+ * and the horizontal line below it, as @c new_screen() prints them.
+ *
+ * @param[out] sb The text of the screen.
+ *
+ * @return void.
+ */
+void start_screen(ScreenBuffer *sb);
+
+/**
+ * @brief Adds a formatted line to the text of a screen.
+ *
+ * The line erases what is left of the previous screen after it. A line not
+ * fitting in the text is cut.
+ *
+ * @param[in,out] sb     The text of the screen.
+ * @param[in]     format The format string of the line, without newline.
+ * @param[in]     ...    Optional arguments for the format string.
+ *
+ * @return void.
+ */
+void screen_line(ScreenBuffer *sb, const char format[], ...);
+
+/**
+ * @brief Writes the text of a screen to the console with a single call,
+ *        erasing the lines of the previous screen below it.
+ *
+ * The text is then empty, so that more lines can be added below the cursor
+ * and written with another call.
+ *
+ * @param[in,out] sb The text of the screen.
+ *
+ * @return void.
+ */
+void flush_screen(ScreenBuffer *sb);
+
 /**
  * @brief Prints a menu from a file on the console screen.
  *
@@ -323,6 +424,17 @@ int is_back_key(const char key);
  */
 int is_quit_key(const char key);
 
+/**
+ * @brief Reads a key without echoing it.
+ *
+ * The keys sent as a prefix followed by a code, such as the arrows and the
+ * page keys, are read whole and returned as their code plus
+ * @c EXTENDED_KEYS.
+ *
+ * @return The ASCII value of the key, or its code plus @c EXTENDED_KEYS.
+ */
+int read_key(void);
+
 /**
  * @brief Waits for a keypress and displays a formatted message.
  *
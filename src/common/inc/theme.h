@@ -0,0 +1,95 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file theme.h
+ * @brief Header file for the border themes used to print the board.
+ *
+ * This file declares the @c BorderTheme struct and the functions to access the
+ * registry of the available themes (ascii, light, heavy, rounded and double).
+ * The borders of the non-ascii themes are multi-byte UTF-8 strings, so each
+ * theme caches the size in bytes and the display width of its borders: the
+ * layout of the board must be computed from these values and never from
+ * @c strlen().
+ *
+ * @note The non-ascii themes need a terminal that prints UTF-8 text (see
+ *       @c use_utf8_output() in term.h).
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 10:12
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef THEME_H
+#define THEME_H
+
+#include "./types/board.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The name of the theme used when none is chosen.
+ */
+#define DEFAULT_THEME "ascii"
+
+/**
+ * @brief The number of available border themes.
+ */
+#define NUM_THEMES 5
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a set of borders used to print the board.
+ *
+ * The borders are in the order described by the @c BorderIndexes constants.
+ *
+ * @var BorderTheme::name
+ * The name used to look the theme up.
+ *
+ * @var BorderTheme::borders
+ * The border strings, possibly multi-byte.
+ *
+ * @var BorderTheme::sizes
+ * The size in bytes of each border, without the null-terminator.
+ *
+ * @var BorderTheme::widths
+ * The number of columns each border takes when printed.
+ */
+typedef struct BorderTheme {
+  const char *name;                  ///< The name of the theme.
+  const char *borders[NUM_BORDERS];  ///< The border strings.
+  int sizes[NUM_BORDERS];            ///< The size in bytes of each border.
+  int widths[NUM_BORDERS];           ///< The display width of each border.
+} BorderTheme;
+
+/**
+ * @brief Gets a theme from its name.
+ *
+ * The metrics of every theme are computed the first time any theme is
+ * requested.
+ *
+ * @param[in] name The name of the theme.
+ *
+ * @return A pointer to the theme, or @c NULL if no theme has the given name.
+ */
+const BorderTheme *get_theme(const char name[]);
+
+/**
+ * @brief Gets the theme that follows a theme in the registry, going back to
+ *        the first one after the last one, so that the themes can be browsed.
+ *
+ * @param[in] theme A theme of the registry, as given by @c get_theme().
+ *
+ * @return A pointer to the next theme.
+ */
+const BorderTheme *get_next_theme(const BorderTheme *theme);
+
+#endif  // !THEME_H
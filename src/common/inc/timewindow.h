@@ -0,0 +1,186 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file timewindow.h
+ * @brief Header file for the best entries of the last few days.
+ *
+ * Each day has a bucket holding its best @c WINDOW_TOP entries in order of
+ * rank, one per player. The buckets of the last @c WINDOW_DAYS days are kept
+ * in a ring, the bucket of a day taking the place of the one of
+ * @c WINDOW_DAYS days before, so a day expires by emptying its bucket when the
+ * next entry falls in the same place.
+ *
+ * The best entries of a window of days are found by merging the buckets of
+ * those days only. A player among the best of the window is among the best of
+ * the day of their best score, since every player ahead of them that day is
+ * ahead of them in the window too, so merging the buckets misses no one.
+ *
+ * Days are counted in UTC from the epoch.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 06:20
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef TIMEWINDOW_H
+#define TIMEWINDOW_H
+
+#include <time.h>
+
+#include "./types/entries.h"
+#include "./types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of days kept, the longest window.
+ */
+#define WINDOW_DAYS 7
+
+/**
+ * @brief The number of entries kept for each day.
+ */
+#define WINDOW_TOP MAX_ENTRIES
+
+/**
+ * @brief The number of seconds in a day.
+ */
+#define SECONDS_PER_DAY 86400
+
+/**
+ * @brief The day of a bucket holding no day.
+ */
+#define WINDOW_NO_DAY -1
+
+/**
+ * @brief The size in bytes of the start of an encoded bucket, its day and its
+ *        number of entries.
+ */
+#define WINDOW_RECORD_HEADER_SIZE 5
+
+/**
+ * @brief The size in bytes of an encoded entry, its name padded to
+ *        @c MAX_USERNAME_LENGTH followed by its score.
+ */
+#define WINDOW_ENTRY_SIZE (MAX_USERNAME_LENGTH + 4)
+
+/**
+ * @brief The maximum size in bytes of an encoded bucket.
+ */
+#define WINDOW_RECORD_MAX_SIZE \
+  (WINDOW_RECORD_HEADER_SIZE + WINDOW_TOP * WINDOW_ENTRY_SIZE)
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing the best entries of a day.
+ *
+ * @var TimeBucket::day
+ * The day, or @c WINDOW_NO_DAY.
+ *
+ * @var TimeBucket::entries
+ * The best entries of the day, in order of rank, one per player.
+ *
+ * @var TimeBucket::num_entries
+ * The number of entries.
+ */
+typedef struct TimeBucket {
+  int day;                    ///< The day.
+  Entry entries[WINDOW_TOP];  ///< The best entries.
+  int num_entries;            ///< The number of entries.
+} TimeBucket;
+
+/**
+ * @brief A struct representing the ring of the buckets of the last days.
+ *
+ * @var TimeWindows::buckets
+ * The buckets, the one of a day being at the day modulo @c WINDOW_DAYS.
+ */
+typedef struct TimeWindows {
+  TimeBucket buckets[WINDOW_DAYS];  ///< The buckets.
+} TimeWindows;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Computes the day of a time.
+ *
+ * @param[in] t The time.
+ *
+ * @return The number of days from the epoch.
+ */
+int day_of(const time_t t);
+
+/**
+ * @brief Empties every bucket.
+ *
+ * @param[out] w The buckets.
+ *
+ * @return void.
+ */
+void clear_time_windows(TimeWindows *w);
+
+/**
+ * @brief Adds an entry to the bucket of a day, emptying the bucket first if
+ *        it holds an older day.
+ *
+ * The entry is kept if it is the best one of its player that day and is
+ * among the best @c WINDOW_TOP entries of the day. An entry of a day older
+ * than the one already in its bucket has expired and is dropped.
+ *
+ * @param[in,out] w   The buckets.
+ * @param[in]     day The day of the entry.
+ * @param[in]     e   The entry.
+ *
+ * @return @c TRUE if the bucket has changed, @c FALSE otherwise.
+ */
+int add_window_entry(TimeWindows *w, const int day, const Entry *e);
+
+/**
+ * @brief Merges the best entries of a window of days.
+ *
+ * @param[in]  w        The buckets.
+ * @param[in]  today    The last day of the window.
+ * @param[in]  num_days The number of days of the window, at most
+ *                      @c WINDOW_DAYS.
+ * @param[out] entries  The best entries of the window, in order of rank, one
+ *                      per player, with room for @c WINDOW_TOP entries.
+ *
+ * @return The number of entries.
+ */
+int get_window_entries(const TimeWindows *w, const int today,
+                       const int num_days, Entry entries[]);
+
+/**
+ * @brief Encodes a bucket and advances the cursor.
+ *
+ * @param[out] cursor The position where the bucket is written, with at least
+ *                    @c WINDOW_RECORD_MAX_SIZE bytes available.
+ * @param[in]  b      The bucket.
+ *
+ * @return The position right after the encoded bucket.
+ */
+unsigned char *encode_time_bucket(unsigned char *cursor, const TimeBucket *b);
+
+/**
+ * @brief Decodes a bucket encoded with @c encode_time_bucket().
+ *
+ * @param[in]  data The bytes of the bucket.
+ * @param[in]  size The size in bytes of the bucket.
+ * @param[out] b    The bucket.
+ *
+ * @return @c TRUE if the bucket is valid, @c FALSE otherwise.
+ */
+int decode_time_bucket(const unsigned char data[], const int size,
+                       TimeBucket *b);
+
+#endif  // !TIMEWINDOW_H
@@ -214,6 +214,59 @@
  */
 #define DEFAULT_BORDERS                                                        \
   { "+", "+", "+", "+", "+", "+", "-", "|" }
+
+/**
+ * @defgroup BorderIndexes Border Indexes
+ * @ingroup BoardConstants
+ * @brief Position of each border inside a borders array.
+ * @{
+ */
+
+/**
+ * @brief The number of borders needed to print the board.
+ */
+#define NUM_BORDERS 8
+
+/**
+ * @brief The index of the top-left corner of a square.
+ */
+#define BORDER_NW 0
+
+/**
+ * @brief The index of the top-right corner of a square.
+ */
+#define BORDER_NE 1
+
+/**
+ * @brief The index of the bottom-left corner of a square.
+ */
+#define BORDER_SW 2
+
+/**
+ * @brief The index of the bottom-right corner of a square.
+ */
+#define BORDER_SE 3
+
+/**
+ * @brief The index of the join between two squares on the top border.
+ */
+#define BORDER_JOIN_DOWN 4
+
+/**
+ * @brief The index of the join between two squares on the bottom border.
+ */
+#define BORDER_JOIN_UP 5
+
+/**
+ * @brief The index of the horizontal border.
+ */
+#define BORDER_DASH 6
+
+/**
+ * @brief The index of the vertical border.
+ */
+#define BORDER_VERT 7
+/** @} */  // End of BorderIndexes
 /** @} */  // End of BoardConstants
 
 // -------------------------------------------------------------------------- //
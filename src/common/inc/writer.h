@@ -0,0 +1,144 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file writer.h
+ * @brief Header file for writing a file from a background thread.
+ *
+ * A writer owns a file and a thread that appends to it the buffers queued by
+ * the caller, so that the caller never waits on the disk. Buffers are written
+ * in the order they are queued and flushed one by one.
+ *
+ * The thread of a writer does not log anything, since the logger keeps a
+ * single call stack that must only be used by the main thread.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 19:05
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The maximum number of buffers waiting to be written.
+ */
+#define WRITER_QUEUE_LEN 8
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing a buffer waiting to be written.
+ *
+ * @var PendingWrite::data
+ * The bytes to write, freed once written.
+ *
+ * @var PendingWrite::size
+ * The number of bytes to write.
+ *
+ * @var PendingWrite::is_replaceable
+ * Whether a buffer queued after this one can take its place.
+ */
+typedef struct PendingWrite {
+  unsigned char *data;  ///< The bytes to write.
+  int size;             ///< The number of bytes to write.
+  int is_replaceable;   ///< Whether a later buffer can take its place.
+} PendingWrite;
+
+/**
+ * @brief A struct representing a file written by a background thread.
+ *
+ * @var Writer::fp
+ * The file, only used by the thread.
+ *
+ * @var Writer::queue
+ * The buffers waiting to be written, in a ring starting at @c head.
+ *
+ * @var Writer::head
+ * The position in @c queue of the next buffer to write.
+ *
+ * @var Writer::num_pending
+ * The number of buffers waiting to be written.
+ *
+ * @var Writer::is_stopping
+ * Whether the thread must exit once the queue is empty.
+ *
+ * @var Writer::thread
+ * The handle of the thread.
+ *
+ * @var Writer::lock
+ * The critical section guarding the queue.
+ *
+ * @var Writer::changed
+ * The condition variable signalled when the queue changes.
+ */
+typedef struct Writer {
+  FILE *fp;                               ///< The file.
+  PendingWrite queue[WRITER_QUEUE_LEN];  ///< The buffers to write.
+  int head;                               ///< The next buffer to write.
+  int num_pending;                        ///< The number of buffers to write.
+  int is_stopping;                        ///< Whether the thread must exit.
+  void *thread;                           ///< The handle of the thread.
+  void *lock;                             ///< The lock of the queue.
+  void *changed;                          ///< Signalled when the queue changes.
+} Writer;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Creates a file and starts a thread that writes to it.
+ *
+ * The file is truncated if it already exists.
+ *
+ * @param[in] path The path of the file.
+ *
+ * @return A pointer to the writer, to stop with @c stop_writer().
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the file can not be created.
+ * @throws ALLOCATION_ERROR        If the thread can not be started.
+ */
+Writer *start_writer(const char path[]);
+
+/**
+ * @brief Queues a buffer to be appended to the file of a writer.
+ *
+ * The writer takes ownership of the buffer and frees it once written. If the
+ * last buffer still waiting is replaceable and so is this one, this one takes
+ * its place, so that a slow disk only drops intermediate states. The caller
+ * only waits if the queue is full of buffers that can not be replaced.
+ *
+ * @param[in,out] w              The writer.
+ * @param[in]     data           The bytes to write, allocated with
+ *                               @c malloc().
+ * @param[in]     size           The number of bytes to write.
+ * @param[in]     is_replaceable Whether a buffer queued later can take the
+ *                               place of this one.
+ *
+ * @return void.
+ */
+void queue_write(Writer *w, unsigned char *data, const int size,
+                 const int is_replaceable);
+
+/**
+ * @brief Writes the buffers still waiting, stops the thread of a writer and
+ *        closes its file.
+ *
+ * @param[in,out] w The writer to stop.
+ *
+ * @return void.
+ */
+void stop_writer(Writer *w);
+
+#endif  // !WRITER_H
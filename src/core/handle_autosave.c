@@ -0,0 +1,265 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <conio.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../inc/globals.h"
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/gamestate.h"
+#include "../common/inc/types/player.h"
+#include "../common/inc/types/players.h"
+
+#include "../common/inc/bytes.h"
+#include "../common/inc/codec.h"
+#include "../common/inc/error.h"
+#include "../common/inc/journal.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/savefile.h"
+#include "../common/inc/term.h"
+#include "../common/inc/writer.h"
+
+#include "../inc/handle_game.h"
+
+#include "../inc/handle_autosave.h"
+#include "../inc/private/handle_autosave.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The writer of the autosave of the game being played, or @c NULL if no
+ *        game is being played.
+ */
+static Writer *autosave_writer = NULL;
+
+/**
+ * @brief The players at the last keyframe, which deltas are computed against.
+ */
+static Players keyframe_pls;
+
+void queue_keyframe(Players *pls, Board *board, const int turn,
+                    const int is_first) {
+  GameState gs;
+  set_game_name(&gs, AUTOSAVE_GAME_NAME);
+  set_players(&gs, pls);
+  set_board(&gs, board);
+
+  const int size = AUTOSAVE_RECORD_HEADER_SIZE + get_record_size(&gs);
+  unsigned char *record = (unsigned char *)malloc(size);  // NOLINT
+  unsigned char *buffer = (unsigned char *)malloc(  // NOLINT
+      JOURNAL_HEADER_SIZE + JOURNAL_RECORD_HEADER_SIZE + size);
+  if (!record || !buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  record[0] = AUTOSAVE_KEYFRAME;
+  write_i32(record + 1, turn);
+  encode_record(record + AUTOSAVE_RECORD_HEADER_SIZE, &gs);
+
+  unsigned char *cursor = buffer;
+  if (is_first) {
+    cursor = write_journal_header(cursor);
+  }
+  cursor = write_journal_record(cursor, record, size);
+  free(record);
+
+  keyframe_pls = *pls;
+  queue_write(autosave_writer, buffer, cursor - buffer, FALSE);
+}
+
+void queue_delta(Players *pls, const int turn) {
+  unsigned char record[AUTOSAVE_RECORD_HEADER_SIZE + 1 +
+                       MAX_NUM_PLAYERS * AUTOSAVE_DELTA_PLAYER_MAX_SIZE];
+  record[0] = AUTOSAVE_DELTA;
+  write_i32(record + 1, turn);
+
+  int changed = 0;
+  unsigned char *cursor = record + AUTOSAVE_RECORD_HEADER_SIZE + 1;
+  int i = 0;
+  while (i < get_players_num(pls)) {
+    const Player *pl = get_player(pls, i);
+    const Player *before = get_player(&keyframe_pls, i);
+    if (get_position(pl) != get_position(before) ||
+        get_score(pl) != get_score(before) ||
+        get_turns_blocked(pl) != get_turns_blocked(before)) {
+      *cursor = i;
+      cursor = encode_player_state(cursor + 1, pl);
+      changed = changed + 1;
+    }
+    i = i + 1;
+  }
+  record[AUTOSAVE_RECORD_HEADER_SIZE] = changed;
+
+  const int size = cursor - record;
+  unsigned char *buffer = (unsigned char *)malloc(  // NOLINT
+      JOURNAL_RECORD_HEADER_SIZE + size);
+  if (!buffer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  write_journal_record(buffer, record, size);
+
+  // a delta still waiting is superseded by this one
+  queue_write(autosave_writer, buffer, JOURNAL_RECORD_HEADER_SIZE + size,
+              TRUE);
+}
+
+void start_autosave(Players *pls, Board *board, const int turn) {
+  logger.enter_fn(__func__);
+  logger.log("starting autosave at turn %i", turn);
+
+  autosave_writer = start_writer(AUTOSAVE_FILE);
+  queue_keyframe(pls, board, turn, TRUE);
+
+  logger.exit_fn();
+}
+
+void autosave_turn(Players *pls, Board *board, const int turn) {
+  if (turn % AUTOSAVE_KEYFRAME_TURNS == 0) {
+    queue_keyframe(pls, board, turn, FALSE);
+  } else {
+    queue_delta(pls, turn);
+  }
+}
+
+void stop_autosave(void) {
+  logger.enter_fn(__func__);
+
+  stop_writer(autosave_writer);
+  autosave_writer = NULL;
+  discard_autosave();
+
+  logger.exit_fn();
+}
+
+int apply_delta(const JournalRecord *rec, GameState *gs) {
+  Players pls = get_players(gs);
+  if (rec->size < AUTOSAVE_RECORD_HEADER_SIZE + 1) {
+    return FALSE;
+  }
+  const int changed = rec->data[AUTOSAVE_RECORD_HEADER_SIZE];
+  const unsigned char *end = rec->data + rec->size;
+
+  const unsigned char *cursor = rec->data + AUTOSAVE_RECORD_HEADER_SIZE + 1;
+  int i = 0;
+  while (i < changed) {
+    if (cursor >= end || *cursor >= get_players_num(&pls)) {
+      return FALSE;
+    }
+    cursor = decode_player_state(cursor + 1, end, get_player(&pls, *cursor));
+    if (!cursor) {
+      return FALSE;
+    }
+    i = i + 1;
+  }
+  if (cursor != end) {
+    return FALSE;
+  }
+  set_players(gs, &pls);
+  return TRUE;
+}
+
+int load_autosave(GameState *gs, int *turn) {
+  logger.enter_fn(__func__);
+
+  FILE *fp;
+  if (fopen_s(&fp, AUTOSAVE_FILE, "rb")) {
+    logger.log("no autosave found");
+    logger.exit_fn();
+    return FALSE;
+  }
+  fclose(fp);
+
+  // only the last keyframe and the last delta after it are needed
+  Journal *j = open_journal(AUTOSAVE_FILE);
+  JournalRecord rec;
+  JournalRecord keyframe = {NULL, 0};
+  JournalRecord delta = {NULL, 0};
+  while (next_journal_record(j, &rec)) {
+    if (rec.size < AUTOSAVE_RECORD_HEADER_SIZE) {
+      continue;
+    }
+    if (rec.data[0] == AUTOSAVE_KEYFRAME) {
+      keyframe = rec;
+      delta.data = NULL;
+    } else if (rec.data[0] == AUTOSAVE_DELTA) {
+      delta = rec;
+    }
+  }
+
+  int is_found = FALSE;
+  if (keyframe.data) {
+    SaveRecord save;
+    save.data = keyframe.data + AUTOSAVE_RECORD_HEADER_SIZE;
+    save.size = keyframe.size - AUTOSAVE_RECORD_HEADER_SIZE;
+    is_found = is_record_valid(&save);
+    if (is_found) {
+      decode_record(&save, gs);
+      *turn = read_i32(keyframe.data + 1);
+    }
+  }
+  if (is_found && delta.data && apply_delta(&delta, gs)) {
+    *turn = read_i32(delta.data + 1);
+  }
+  logger.log("read %i records, found game: %i", j->num_records, is_found);
+  close_journal(j);
+
+  logger.exit_fn();
+  return is_found;
+}
+
+void discard_autosave(void) {
+  FILE *fp;
+  if (fopen_s(&fp, AUTOSAVE_FILE, "wb")) {
+    throw_err(FILE_NOT_WRITABLE_ERROR);
+  }
+  fclose(fp);
+}
+
+void resume_autosave(void) {
+  logger.enter_fn(__func__);
+
+  GameState gs;
+  int turn;
+  if (!load_autosave(&gs, &turn)) {
+    logger.exit_fn();
+    return;
+  }
+
+  Players pls = get_players(&gs);
+  // only the dimension of the board is saved
+  const Board saved = get_board(&gs);
+  Board board = *get_cached_board(get_dim(&saved));
+  new_screen();
+  printf("Found a game that was interrupted at turn %i, with %i players on a "
+         "board with %i squares.\n",
+         turn + 1, get_players_num(&pls), get_dim(&board));
+  printf("resume this game? (y/n) : ");
+  printf("\n> ");
+  char key;
+  do {
+    key = _getch();
+    if (key != 'y' && key != 'n') {
+      print_err(INVALID_INPUT_ERROR);
+      printf("\n> ");
+    }
+  } while (key != 'y' && key != 'n');
+
+  if (key == 'y') {
+    logger.log("resuming game at turn %i", turn);
+    game_loop(&pls, &board, get_cached_render(get_dim(&board)), turn);
+  } else {
+    logger.log("discarding interrupted game");
+    discard_autosave();
+  }
+
+  logger.exit_fn();
+}
@@ -23,18 +23,117 @@
 #include "../common/inc/types/players.h"
 
 #include "../common/inc/error.h"
+#include "../common/inc/iopool.h"
 #include "../common/inc/logger.h"
 #include "../common/inc/math.h"
+#include "../common/inc/nameindex.h"
+#include "../common/inc/playerstats.h"
+#include "../common/inc/rating.h"
 #include "../common/inc/string.h"
 #include "../common/inc/term.h"
+#include "../common/inc/theme.h"
 
+#include "../inc/handle_autosave.h"
+#include "../inc/handle_history.h"
 #include "../inc/handle_leaderboard.h"
+#include "../inc/handle_rating.h"
 #include "../inc/handle_saving.h"
+#include "../inc/handle_stats.h"
 
 #include "../inc/handle_game.h"
 #include "../inc/private/handle_game.h"
 
-static const char *BORDERS[8] = DEFAULT_BORDERS;
+/**
+ * @brief The label of every square value, indexed by value - MIN_SQUARE_VALUE.
+ */
+static char square_labels[NUM_SQUARE_LABELS][SQUARE_LABEL_LEN + 1];
+
+/**
+ * @brief Whether the @c square_labels table has been built.
+ */
+static int are_labels_built = FALSE;
+
+/**
+ * @brief The board of every supported dimension, indexed by
+ *        dim - MIN_NUM_SQUARES.
+ */
+static Board cached_boards[NUM_BOARD_DIMS];
+
+/**
+ * @brief The visual representation of every cached board, with the chosen
+ *        theme, @c NULL until the board of that dimension is first requested.
+ */
+static BoardRender *cached_renders[NUM_BOARD_DIMS];
+
+/**
+ * @brief The theme the boards are printed with, @c NULL until it is first
+ *        requested.
+ */
+static const BorderTheme *board_theme = NULL;
+
+/**
+ * @brief Whether the messages about the moves are hidden, while turns are
+ *        replayed.
+ */
+static int are_moves_quiet = FALSE;
+
+/**
+ * @brief The tally the moves are counted in, or @c NULL if they are not
+ *        counted.
+ */
+static GameTally *tally = NULL;
+
+/**
+ * @brief Finds the statistics of a player in the tally of the moves.
+ *
+ * @return The statistics of the player in the game, or @c NULL if the moves
+ *         are not counted.
+ */
+static StatsRow *tallied(const Player *pl) {
+  if (!tally) {
+    return NULL;
+  }
+  return tally_player(tally, pack_name(get_username(pl)));
+}
+
+/**
+ * @brief Chooses the character a player is drawn with on the board.
+ *
+ * The first character of the username that no previous player is drawn with
+ * is chosen, so that players whose names start with the same letter are told
+ * apart. If every character of the username is taken, the number of the
+ * player is chosen instead.
+ *
+ * @return The character the player is drawn with.
+ */
+static char pick_initial(const TokenLayer *layer, const char username[],
+                         const int player_idx) {
+  int i = 0;
+  while (username[i] != '\0' && username[i] != FILLER_CHAR[0]) {
+    int j = 0;
+    while (j < player_idx && layer->initials[j] != username[i]) {
+      j = j + 1;
+    }
+    if (j == player_idx) {
+      return username[i];
+    }
+    i = i + 1;
+  }
+  return (char)('1' + player_idx);
+}
+
+/**
+ * @brief Prints a message about a move, unless turns are being replayed.
+ */
+static void print_move(const char format[], ...) {
+  if (are_moves_quiet) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+}
 
 int ask_num_in_range(const int min, const int max, const char name[]) {
   // this function asks the user to input a number within a given range. It
@@ -427,6 +526,8 @@ Board *create_board(const int board_dim) {
   logger.enter_fn(__func__);
   logger.log("creating game board (array)");
 
+  build_square_labels();
+
   Board *board = (Board *)malloc(sizeof(Board));  // NOLINT
   set_dim(board, board_dim);
 
@@ -444,157 +545,232 @@ Board *create_board(const int board_dim) {
   return board;
 }
 
-char *build_border(const char *borders[4], const int square_len, const int cols,
-                   const int rows, const int row, const Board board) {
-  /* segments contains the four segments needed to create a border:
-   * - west  0;
-   * - east  1;
-   * - join  2;
-   * - dash  3.
-   */
+void build_square_labels() {
+  // this function formats the label of every possible square value once, so
+  // that printing a square is just a lookup in the table.
   logger.enter_fn(__func__);
-  logger.log("attempting to build board border");
-
-  char *buffer = alloc_char(borders[0], cols * square_len);
-  char *ndash = alloc_char(borders[3], square_len - 1);
-  nconcat(ndash, borders[3], square_len - 1);
-
-  const int square_size = 1 + square_len * strlen(borders[0]);
-  const int board_dim = get_dim(&board);
-
-  int col = 0;
-  while (col < cols) {
-    if (row % 2 == 0) {
-      int pos = row * cols + col;
-      int is_last_of_row =
-          ((col == cols - 1) && (row != rows - 1)) || (pos == board_dim - 1);
-
-      if (col == 0) {                    // 1st sq of the row
-        fconcat(buffer, square_size, "%s%s", borders[0], ndash);
-      } else if (is_last_of_row) {       // last sq of the row
-        fconcat(buffer, square_size, "%s%s", borders[2], ndash);
-        concat(buffer, borders[1]);
-      } else if (pos < board_dim - 1) {  // between 1st & last
-        fconcat(buffer, square_size, "%s%s", borders[2], ndash);
-      } else {                           // when traveling RtL
-        fconcat(buffer, square_size, "%*s", square_len, "");
-      }
-    } else {
-      int pos = (row + 1) * cols - col - 1;
-      int is_fist = (col == 0) && (row != rows - 1);
-
-      if (is_fist || pos == board_dim - 1) {  // 1st sq of the row and last sq
-        fconcat(buffer, square_size, "%s%s", borders[0], ndash);
-      } else if (col == cols - 1) {           // last sq of the row
-        fconcat(buffer, square_size, "%s%s", borders[2], ndash);
-        concat(buffer, borders[1]);
-      } else if (pos < board_dim - 1) {       // between 1st & last
-        fconcat(buffer, square_size, "%s%s", borders[2], ndash);
-      } else {                                // when traveling LtR
-        fconcat(buffer, square_size, "%*s", square_len, "");
-      }
-    }
-    col = col + 1;
+
+  if (are_labels_built) {
+    logger.exit_fn();
+    return;
   }
-  // add line end char since nothing should be present on the same line
-  concat(buffer, LINE_END);
+  logger.log("building square labels table");
 
-  logger.log("built game border");
+  const int special_vals[] = {GOOSE_VALUE,  BRIDGE_VALUE,    INN_VALUE,
+                              WELL_VALUE,   LABYRINTH_VALUE, PRISON_VALUE,
+                              SKELETON_VALUE};
+  const char *special_labels[] = {"X2", "BR", "IN", "WE", "LA", "PR", "SK"};
+  const int num_special_vals = sizeof(special_vals) / sizeof(special_vals[0]);
+
+  int i = 0;
+  while (i < num_special_vals) {
+    snprintf(square_labels[special_vals[i] - MIN_SQUARE_VALUE],
+             SQUARE_LABEL_LEN + 1, "%2s", special_labels[i]);
+    i = i + 1;
+  }
+
+  int square = 1;
+  while (square <= MAX_NUM_SQUARES) {
+    snprintf(square_labels[square - MIN_SQUARE_VALUE], SQUARE_LABEL_LEN + 1,
+             "%2d", square);
+    square = square + 1;
+  }
+  are_labels_built = TRUE;
+
+  logger.log("built %i square labels", NUM_SQUARE_LABELS);
   logger.exit_fn();
-  return buffer;
 }
 
-char *sq_to_str(const int square) {
-  logger.enter_fn(__func__);
-  logger.log("converting square int to string");
+const char *sq_to_str(const int square) {
+  if (!are_labels_built) {
+    build_square_labels();
+  }
+  return square_labels[square - MIN_SQUARE_VALUE];
+}
 
-  char *buffer = str_allocate((int)sizeof(square));  // NOLINT
-  if (square == GOOSE_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "X2");
-  } else if (square == BRIDGE_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "BR");
-  } else if (square == INN_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "IN");
-  } else if (square == WELL_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "WE");
-  } else if (square == LABYRINTH_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "LA");
-  } else if (square == PRISON_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "PR");
-  } else if (square == SKELETON_VALUE) {
-    snprintf(buffer, sizeof(buffer), "%2s", "SK");
-  } else {
-    snprintf(buffer, sizeof(buffer), "%2d", square);
+int count_row_squares(const Board *board, const int cols, const int row) {
+  int num_cells = get_dim(board) - row * cols;
+  if (num_cells > cols) {
+    num_cells = cols;
   }
+  return num_cells;
+}
+
+BoardTemplate *create_template(const BorderTheme *theme, const int cols,
+                               const int square_len) {
+  logger.enter_fn(__func__);
+  logger.log("creating '%s' board template (%i cols, square len %i)",
+             theme->name, cols, square_len);
 
-  logger.log("converted %i to '%s'", square, buffer);
+  BoardTemplate *tmpl =
+      (BoardTemplate *)malloc(sizeof(BoardTemplate));  // NOLINT
+  if (!tmpl) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  tmpl->theme = theme;
+  tmpl->cols = cols;
+
+  // borders may be multi-byte strings: bytes are used to size the buffers,
+  // widths to lay the squares out
+  const char *const *borders = theme->borders;
+  const int dash_size = theme->sizes[BORDER_DASH];
+  const int vert_size = theme->sizes[BORDER_VERT];
+
+  // a missing square is as wide as a square, vertical border included
+  tmpl->blank_size = theme->widths[BORDER_VERT] + square_len - 1;
+
+  const int num_dashes = (square_len - 1) / theme->widths[BORDER_DASH];
+  tmpl->dashes_size = num_dashes * dash_size;
+  tmpl->dashes = str_allocate(tmpl->dashes_size);
+  str_nput(tmpl->dashes, borders[BORDER_DASH], dash_size, num_dashes);
+
+  // the label is centered, the extra space goes to the right
+  const int lspacing = (square_len - 1 - SQUARE_LABEL_LEN) / 2;
+  tmpl->label_offset = vert_size + lspacing;
+  tmpl->cell_size = vert_size + square_len - 1;
+  tmpl->cell = str_allocate(tmpl->cell_size);
+  char *cursor = str_put(tmpl->cell, borders[BORDER_VERT], vert_size);
+  memset(cursor, SPACE_CHAR, square_len - 1);
+
+  const int top_segments[3] = {BORDER_NW, BORDER_NE, BORDER_JOIN_DOWN};
+  const int bot_segments[3] = {BORDER_SW, BORDER_SE, BORDER_JOIN_UP};
+
+  tmpl->top_row = str_allocate(row_size(tmpl, cols));
+  tmpl->top_size = put_border(tmpl->top_row, tmpl, top_segments, cols, FALSE) -
+                   tmpl->top_row;
+
+  tmpl->squares_row = str_allocate(row_size(tmpl, cols));
+  tmpl->squares_size = put_squares(tmpl->squares_row, tmpl, cols, FALSE) -
+                       tmpl->squares_row;
+
+  tmpl->bot_row = str_allocate(row_size(tmpl, cols));
+  tmpl->bot_size = put_border(tmpl->bot_row, tmpl, bot_segments, cols, FALSE) -
+                   tmpl->bot_row;
+
+  logger.log("created board template, full row of %i bytes",
+             tmpl->top_size + tmpl->squares_size + tmpl->bot_size);
   logger.exit_fn();
-  return buffer;
+  return tmpl;
 }
 
-char *build_squares(const char *vert, const int square_len, const int cols,
-                    const int rows, const int row, const Board board) {
-  logger.enter_fn(__func__);
-  logger.log("attempting to build board squares");
+void free_template(BoardTemplate *tmpl) {
+  free(tmpl->dashes);
+  free(tmpl->cell);
+  free(tmpl->top_row);
+  free(tmpl->squares_row);
+  free(tmpl->bot_row);
+  free(tmpl);
+}
+
+int row_size(const BoardTemplate *tmpl, const int num_cells) {
+  const int *sizes = tmpl->theme->sizes;
+  const int blanks_size = (tmpl->cols - num_cells) * tmpl->blank_size;
+  const int line_end_size = strlen(LINE_END);
+
+  const int top_size = sizes[BORDER_NW] + sizes[BORDER_NE] +
+                       num_cells * tmpl->dashes_size +
+                       (num_cells - 1) * sizes[BORDER_JOIN_DOWN];
+  const int bot_size = sizes[BORDER_SW] + sizes[BORDER_SE] +
+                       num_cells * tmpl->dashes_size +
+                       (num_cells - 1) * sizes[BORDER_JOIN_UP];
+  const int squares_size = num_cells * tmpl->cell_size + sizes[BORDER_VERT];
+
+  return top_size + squares_size + bot_size + 3 * (blanks_size + line_end_size);
+}
+
+char *put_border(char *cursor, const BoardTemplate *tmpl,
+                 const int segments[3], const int num_cells, const int is_rtl) {
+  /* segments contains the indexes of the borders needed to create a border:
+   * - west  0;
+   * - east  1;
+   * - join  2.
+   */
+  const char *const *borders = tmpl->theme->borders;
+  const int *sizes = tmpl->theme->sizes;
+  const int blanks = (tmpl->cols - num_cells) * tmpl->blank_size;
+  const int west = segments[0];
+  const int east = segments[1];
+  const int join = segments[2];
+
+  if (is_rtl) {  // missing squares are on the left
+    memset(cursor, SPACE_CHAR, blanks);
+    cursor = cursor + blanks;
+  }
 
-  char *buffer = alloc_char(vert, cols * square_len);
+  cursor = str_put(cursor, borders[west], sizes[west]);
+  cursor = str_put(cursor, tmpl->dashes, tmpl->dashes_size);
+  int i = 1;
+  while (i < num_cells) {
+    cursor = str_put(cursor, borders[join], sizes[join]);
+    cursor = str_put(cursor, tmpl->dashes, tmpl->dashes_size);
+    i = i + 1;
+  }
+  cursor = str_put(cursor, borders[east], sizes[east]);
 
-  const int square_size = 1 + square_len * strlen(vert);
-  const int board_dim = get_dim(&board);
-  const int lspacing = (square_len - 3) / 2;
-  int rspacing;
-  if (square_len % 2 != 0) {
-    rspacing = lspacing;
-  } else {
-    rspacing = lspacing + 1;
+  if (!is_rtl) {  // missing squares are on the right
+    memset(cursor, SPACE_CHAR, blanks);
+    cursor = cursor + blanks;
   }
 
-  int col = 0;
-  while (col < cols) {
-    if (row % 2 == 0) {
-      int pos = row * cols + col;
-      int square = get_square(&board, pos);
-      char *sq = sq_to_str(square);
+  // add line end char since nothing should be present on the same line
+  return str_put(cursor, LINE_END, strlen(LINE_END));
+}
 
-      int is_fist = (col == cols - 1) && (row != rows - 1);
-      int is_last = (pos == board_dim - 1) && (row == rows - 1);
-      if (is_fist || is_last) {
-        fconcat(buffer, square_size, "%s%*s%2s%*s%s", vert, lspacing, "", sq,
-                rspacing, "", vert);
-      } else if (pos < board_dim) {
-        fconcat(buffer, square_size, "%s%*s%2s%*s", vert, lspacing, "", sq,
-                rspacing, "");
-      } else {
-        fconcat(buffer, square_size, "%*s", square_len, "");
-      }
-    } else {
-      int pos = (row + 1) * cols - col - 1;
-      int square = get_square(&board, pos);
-      char *sq = sq_to_str(square);
-
-      if (col == cols - 1) {
-        fconcat(buffer, square_size, "%s%*s%2s%*s%s", vert, lspacing, "", sq,
-                rspacing, "", vert);
-      } else if (pos < board_dim) {
-        fconcat(buffer, square_size, "%s%*s%2s%*s", vert, lspacing, "", sq,
-                rspacing, "");
-      } else {
-        fconcat(buffer, square_size, "%*s", square_len, "");
-      }
-    }
-    col = col + 1;
+char *put_squares(char *cursor, const BoardTemplate *tmpl, const int num_cells,
+                  const int is_rtl) {
+  const int blanks = (tmpl->cols - num_cells) * tmpl->blank_size;
+
+  if (is_rtl) {  // missing squares are on the left
+    memset(cursor, SPACE_CHAR, blanks);
+    cursor = cursor + blanks;
+  }
+
+  cursor = str_nput(cursor, tmpl->cell, tmpl->cell_size, num_cells);
+  cursor = str_put(cursor, tmpl->theme->borders[BORDER_VERT],
+                   tmpl->theme->sizes[BORDER_VERT]);
+
+  if (!is_rtl) {  // missing squares are on the right
+    memset(cursor, SPACE_CHAR, blanks);
+    cursor = cursor + blanks;
   }
+
   // add line end char since nothing should be present on the same line
-  concat(buffer, LINE_END);
+  return str_put(cursor, LINE_END, strlen(LINE_END));
+}
 
-  logger.log("built game squares");
-  logger.exit_fn();
-  return buffer;
+void stamp_labels(BoardRender *render, char *squares, const BoardTemplate *tmpl,
+                  const Board *board, const int row) {
+  const int cols = tmpl->cols;
+  const int num_cells = count_row_squares(board, cols, row);
+  const int is_rtl = row % 2 != 0;
+
+  // squares traveled right to left are preceded by the missing ones
+  char *label_pos = squares + tmpl->label_offset;
+  if (is_rtl) {
+    label_pos = label_pos + (cols - num_cells) * tmpl->blank_size;
+  }
+
+  int i = 0;
+  while (i < num_cells) {
+    int pos;
+    if (is_rtl) {
+      pos = row * cols + num_cells - i - 1;
+    } else {
+      pos = row * cols + i;
+    }
+
+    memcpy(label_pos, sq_to_str(get_square(board, pos)), SQUARE_LABEL_LEN);
+    render->label_offsets[pos] = label_pos - render->text;
+
+    label_pos = label_pos + tmpl->cell_size;
+    i = i + 1;
+  }
 }
 
-char *build_board(const Board board, const int cols, const int square_len,
-                  const char *borders[8]) {
-  /* border chars will be in the following order:
+BoardRender *build_board(const Board board, const int cols,
+                         const int square_len, const BorderTheme *theme) {
+  /* border chars of the theme are in the following order:
    * - nw_corner  0  (ex. "┌");
    * - ne_corner  1  (ex. "┐");
    * - sw_corner  2  (ex. "└");
@@ -608,35 +784,209 @@ char *build_board(const Board board, const int cols, const int square_len,
   logger.log("building game board (visual)");
 
   int rows = (get_dim(&board) + cols - 1) / cols;  // calculate rows needed
+  BoardTemplate *tmpl = create_template(theme, cols, square_len);
+
+  // only the last row may differ from the full one
+  const int last_cells = count_row_squares(&board, cols, rows - 1);
+  const int board_size =
+      (rows - 1) * row_size(tmpl, cols) + row_size(tmpl, last_cells);
+  BoardRender *render = (BoardRender *)malloc(sizeof(BoardRender));  // NOLINT
+  if (!render) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  render->text = str_allocate(board_size);
+  render->size = board_size;
+  render->square_len = square_len;
+  logger.log("allocated %i bytes for the game board", board_size);
 
-  // char *game_board = alloc_char(borders[0], 3 * rows * cols * square_len);
-  char *game_board =
-      str_allocate(3 * rows * cols * square_len * sizeof(borders[0]));
-  const char *top_borders[4] = {borders[0], borders[1], borders[4], borders[6]};
-  const char *bot_borders[4] = {borders[2], borders[3], borders[5], borders[6]};
-  const char *vert = borders[7];
+  const int top_segments[3] = {BORDER_NW, BORDER_NE, BORDER_JOIN_DOWN};
+  const int bot_segments[3] = {BORDER_SW, BORDER_SE, BORDER_JOIN_UP};
 
+  char *cursor = render->text;
   int row = 0;
   while (row < rows) {
-    char *top = build_border(top_borders, square_len, cols, rows, row, board);
-    char *squares = build_squares(vert, square_len, cols, rows, row, board);
-    char *bot = build_border(bot_borders, square_len, cols, rows, row, board);
+    const int num_cells = count_row_squares(&board, cols, row);
+    const int is_rtl = row % 2 != 0;
+    char *squares;
+
+    if (num_cells == cols) {
+      cursor = str_put(cursor, tmpl->top_row, tmpl->top_size);
+      squares = cursor;
+      cursor = str_put(cursor, tmpl->squares_row, tmpl->squares_size);
+      cursor = str_put(cursor, tmpl->bot_row, tmpl->bot_size);
+    } else {
+      cursor = put_border(cursor, tmpl, top_segments, num_cells, is_rtl);
+      squares = cursor;
+      cursor = put_squares(cursor, tmpl, num_cells, is_rtl);
+      cursor = put_border(cursor, tmpl, bot_segments, num_cells, is_rtl);
+    }
+    stamp_labels(render, squares, tmpl, &board, row);
+
+    row = row + 1;
+  }
+  *cursor = STR_END;
 
-    const int source_size = 1 + strlen(top) + strlen(squares) + strlen(bot);
-    logger.log("attempting to concatenate rows");
-    fconcat(game_board, source_size, "%s%s%s", top, squares, bot);
-    logger.log("concatenated rows");
+  free_template(tmpl);
 
-    free(top);
-    free(squares);
-    free(bot);
-    logger.log("memory freed");
+  logger.log("built game board of %i rows", rows);
+  logger.exit_fn();
+  return render;
+}
 
-    row = row + 1;
+void free_render(BoardRender *render) {
+  free(render->text);
+  free(render);
+}
+
+void cache_board(const int board_dim) {
+  // this function builds the board of the given dimension and its visual
+  // representation, and stores both in the cache.
+  logger.enter_fn(__func__);
+  logger.log("caching board of %i squares", board_dim);
+
+  const int index = board_dim - MIN_NUM_SQUARES;
+  Board *board = create_board(board_dim);
+  cached_boards[index] = *board;
+  free(board);
+
+  cached_renders[index] =
+      build_board(cached_boards[index], DEFAULT_COLS, DEFAULT_SQUARE_LEN,
+                  get_board_theme());
+
+  logger.exit_fn();
+}
+
+const BorderTheme *get_board_theme(void) {
+  if (!board_theme) {
+    board_theme = get_theme(DEFAULT_THEME);
+  }
+  return board_theme;
+}
+
+void set_board_theme(const BorderTheme *theme) {
+  logger.enter_fn(__func__);
+  logger.log("printing boards with the '%s' theme", theme->name);
+
+  board_theme = theme;
+  // the boards already cached are printed again, so that the cache still
+  // tells which boards have been created
+  int i = 0;
+  while (i < NUM_BOARD_DIMS) {
+    if (cached_renders[i]) {
+      free_render(cached_renders[i]);
+      cached_renders[i] = build_board(cached_boards[i], DEFAULT_COLS,
+                                      DEFAULT_SQUARE_LEN, board_theme);
+    }
+    i = i + 1;
+  }
+
+  logger.exit_fn();
+}
+
+const Board *get_cached_board(const int board_dim) {
+  if (board_dim < MIN_NUM_SQUARES || board_dim > MAX_NUM_SQUARES) {
+    logger.stop();
+    throw_err(VALUE_OUT_OF_BOUND_ERROR);
+  }
+
+  if (!cached_renders[board_dim - MIN_NUM_SQUARES]) {
+    cache_board(board_dim);
+  }
+  return &cached_boards[board_dim - MIN_NUM_SQUARES];
+}
+
+const BoardRender *get_cached_render(const int board_dim) {
+  get_cached_board(board_dim);  // checks the bounds and fills the cache
+  return cached_renders[board_dim - MIN_NUM_SQUARES];
+}
+
+TokenLayer *create_token_layer(const BoardRender *render, const Board *board,
+                               Players *pls) {
+  logger.enter_fn(__func__);
+  logger.log("creating token layer for %i players", get_players_num(pls));
+
+  TokenLayer *layer = (TokenLayer *)malloc(sizeof(TokenLayer));  // NOLINT
+  if (!layer) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  layer->render = render;
+  layer->dim = get_dim(board);
+  layer->game_board = str_allocate(render->size);
+  memcpy(layer->game_board, render->text, render->size);
+
+  // slots are the spaces around the label: first the left ones, then the
+  // right ones
+  const int lspacing = (render->square_len - 1 - SQUARE_LABEL_LEN) / 2;
+  const int rspacing = render->square_len - 1 - SQUARE_LABEL_LEN - lspacing;
+  layer->num_slots = 0;
+  int i = 0;
+  while (i < lspacing + rspacing && i < MAX_NUM_PLAYERS) {
+    if (i < lspacing) {
+      layer->slot_offsets[i] = i - lspacing;
+    } else {
+      layer->slot_offsets[i] = SQUARE_LABEL_LEN + i - lspacing;
+    }
+    layer->num_slots = layer->num_slots + 1;
+    i = i + 1;
+  }
+
+  memset(layer->occupancy, 0, sizeof(layer->occupancy));
+  i = 0;
+  while (i < get_players_num(pls)) {
+    Player *pl = get_player(pls, i);
+    layer->initials[i] = pick_initial(layer, get_username(pl), i);
+
+    const int position = get_position(pl);
+    if (position >= 0 && position < layer->dim) {
+      layer->occupancy[position] = layer->occupancy[position] | (1 << i);
+      stamp_tokens(layer, position);
+    }
+    i = i + 1;
   }
 
+  logger.log("created token layer with %i slots per square", layer->num_slots);
   logger.exit_fn();
-  return game_board;
+  return layer;
+}
+
+void free_token_layer(TokenLayer *layer) {
+  free(layer->game_board);
+  free(layer);
+}
+
+void stamp_tokens(TokenLayer *layer, const int position) {
+  if (position < 0 || position >= layer->dim) {
+    return;
+  }
+
+  char *label = layer->game_board + layer->render->label_offsets[position];
+  const int occupancy = layer->occupancy[position];
+  int i = 0;
+  while (i < layer->num_slots) {
+    if (occupancy & (1 << i)) {
+      label[layer->slot_offsets[i]] = layer->initials[i];
+    } else {
+      label[layer->slot_offsets[i]] = SPACE_CHAR;
+    }
+    i = i + 1;
+  }
+}
+
+void move_token(TokenLayer *layer, const int player_idx, const int from,
+                const int to) {
+  const int token = 1 << player_idx;
+
+  if (from >= 0 && from < layer->dim) {
+    layer->occupancy[from] = layer->occupancy[from] & ~token;
+  }
+  if (to >= 0 && to < layer->dim) {
+    layer->occupancy[to] = layer->occupancy[to] | token;
+  }
+
+  stamp_tokens(layer, from);
+  stamp_tokens(layer, to);
 }
 
 void print_board(const char game_board[]) { printf("%s", game_board); }
@@ -679,7 +1029,9 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
 
   int current_sq = get_square(board, get_position(pl));
   int target_pos = roll + get_position(pl);
-  int target_sq = get_square(board, target_pos);
+  // past the last square there are no special squares, the player bounces back
+  int target_sq = target_pos < get_dim(board) ? get_square(board, target_pos)
+                                              : target_pos + 1;
 
   int turns_blocked = get_turns_blocked(pl);
 
@@ -690,19 +1042,19 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
     if (current_sq == INN_VALUE) {
       logger.exit_fn();
       set_turns_blocked(pl, get_turns_blocked(pl) - 1);
-      printf("turns still blocked for the INN square : %d\n",
+      print_move("turns still blocked for the INN square : %d\n",
              get_turns_blocked(pl) + 1);
       return get_position(pl);
     }
 
     if ((current_sq == PRISON_VALUE || current_sq == WELL_VALUE) &&
         (roll == ESCAPE_ROLL1 || roll == ESCAPE_ROLL2)) {
-      printf("\nThanks to your roll you are free now!\n");
+      print_move("\nThanks to your roll you are free now!\n");
       set_turns_blocked(pl, NO_TURNS_BLOCKED);
       logger.exit_fn();
       return get_position(pl);
     } else {
-      printf("\nYou are blocked indefinitely\n");
+      print_move("\nYou are blocked indefinitely\n");
       logger.exit_fn();
       return get_position(pl);
     }
@@ -711,6 +1063,10 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
   } else if (turns_blocked == NO_TURNS_BLOCKED) {
     // score has to be updated for each roll
     update_score(pl);
+    StatsRow *row = tallied(pl);
+    if (row) {
+      tally_landing(row, target_sq);
+    }
 
     logger.log("player is free to move");
     // check if player goes beyond the number of squares
@@ -724,15 +1080,13 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
       logger.exit_fn();
 
       if (target_sq == GOOSE_VALUE) {
-        printf("Landed on a GOOSE SQUARE: %s", GOOSE_TEXT);
+        print_move("Landed on a GOOSE SQUARE: %s", GOOSE_TEXT);
       } else {
-        printf("Landed on the BRIDGE SQUARE: %s", BRIDGE_TEXT);
+        print_move("Landed on the BRIDGE SQUARE: %s", BRIDGE_TEXT);
       }
       if (((roll * 2) + get_position(pl)) < get_dim(board)) {
-        logger.exit_fn();
         return ((roll * 2) + get_position(pl));
       } else {
-        logger.exit_fn();
         return (get_dim(board) -
                 (get_position(pl) + (roll * 2) - get_dim(board)));
       }
@@ -740,23 +1094,24 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
     } else if (target_sq == SKELETON_VALUE) {
       logger.log("player on skeleton square, back to start");
       logger.exit_fn();
-      printf("Landed on the SKELETON SQUARE: %s", SKELETON_TEXT);
+      print_move("Landed on the SKELETON SQUARE: %s", SKELETON_TEXT);
       return INITIAL_POSITION;
 
     } else if (target_sq == LABYRINTH_VALUE) {
       logger.log("player on labyrinth square");
       logger.exit_fn();
-      printf("Landed on the LABYRINTH : ");
-      printf(LABYRINTH_TEXT, (proportion(get_dim(board), LABYRINTH_DEFAULT_POS,
-                                         MAX_NUM_SQUARES)) +
-                                 1);
+      print_move("Landed on the LABYRINTH : ");
+      print_move(LABYRINTH_TEXT,
+                 (proportion(get_dim(board), LABYRINTH_DEFAULT_POS,
+                             MAX_NUM_SQUARES)) +
+                     1);
       return proportion(get_dim(board), LABYRINTH_DEFAULT_POS, MAX_NUM_SQUARES);
 
     } else if (target_sq == INN_VALUE) {
       logger.log("player on inn square");
       logger.exit_fn();
-      printf("Landed on the INN : ");
-      printf("%s", INN_TEXT);
+      print_move("Landed on the INN : ");
+      print_move("%s", INN_TEXT);
       set_turns_blocked(pl, TURNS_BLOCKED_BY_INN);
       return target_pos;
 
@@ -765,9 +1120,9 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
       logger.log("player is in prison/well");
 
       if (target_sq == PRISON_VALUE) {
-        printf("Landed on the PRISON : %s", PRISON_TEXT);
+        print_move("Landed on the PRISON : %s", PRISON_TEXT);
       } else {
-        printf("Landed on the WELL : %s", WELL_TEXT);
+        print_move("Landed on the WELL : %s", WELL_TEXT);
       }
 
       set_turns_blocked(pl, INDEF_BLOCK);
@@ -779,7 +1134,7 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
         set_turns_blocked(get_player(pls, other_pl_pos), NO_TURNS_BLOCKED);
         logger.log("blocking player indefinetly");
         logger.exit_fn();
-        printf("\n%s got out of prison thanks to %s that got in\n",
+        print_move("\n%s got out of prison thanks to %s that got in\n",
                get_username(get_player(pls, other_pl_pos)), get_username(pl));
         return target_pos;
       } else {
@@ -789,7 +1144,6 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
     } else {
       // player isn't on special square, return the roll + it's current position
       logger.log("no special case for player");
-      logger.exit_fn();
       if (target_pos > get_dim(board)) {
         logger.log("player going out of bounds");
         logger.exit_fn();
@@ -806,6 +1160,10 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll) {
 void move_player(Players *pls, Player *pl, const int roll, Board *board) {
   logger.enter_fn(__func__);
   logger.log("moving %s based on it's roll %i", get_username(pl), roll);
+  StatsRow *row = tallied(pl);
+  if (row) {
+    row->turns = row->turns + 1;
+  }
   set_position(pl, check_player_pos(pls, pl, board, roll));
   logger.exit_fn();
 }
@@ -828,6 +1186,36 @@ int find_winner(Players *pls, Board *board) {
   return INDEX_NOT_FOUND;
 }
 
+int are_players_at_start(Players *pls) {
+  int i = 0;
+  while (i < get_players_num(pls)) {
+    const Player *pl = get_player(pls, i);
+    if (get_position(pl) != INITIAL_POSITION ||
+        get_score(pl) != INITIAL_SCORE ||
+        get_turns_blocked(pl) != NO_TURNS_BLOCKED) {
+      return FALSE;
+    }
+    i = i + 1;
+  }
+  return TRUE;
+}
+
+void print_ratings(Players *pls, const int changes[]) {
+  logger.enter_fn(__func__);
+  logger.log("printing player ratings");
+
+  printf("\n" RATINGS_BANNER "\n");
+  int i = 0;
+  while (i < get_players_num(pls)) {
+    const char *username = get_username(get_player(pls, i));
+    printf(RATING_ROW_FMT, username,
+           (double)get_player_rating(username) / RATING_SCALE,
+           (double)changes[i] / RATING_SCALE);
+    i = i + 1;
+  }
+  logger.exit_fn();
+}
+
 void print_positions(Board *board, Players *pls) {
   logger.enter_fn(__func__);
   logger.log("printing player positions");
@@ -835,8 +1223,13 @@ void print_positions(Board *board, Players *pls) {
   printf("NAME\tPOS\n");
   int i = 0;
   while (i < get_players_num(pls)) {
-    int sq = get_square(board, get_position(get_player(pls, i)));
-    char *square = sq_to_str(sq);
+    // a player who went past the last square in this round is shown on it
+    int position = get_position(get_player(pls, i));
+    if (position >= get_dim(board)) {
+      position = get_dim(board) - 1;
+    }
+    int sq = get_square(board, position);
+    const char *square = sq_to_str(sq);
 
     printf("%s\t", get_username(get_player(pls, i)));
     printf("%d ", 1 + get_position(get_player(pls, i)));
@@ -862,7 +1255,7 @@ int pause_menu(Players *pls, Board *board, const char game_board[]) {
     if (key == 's') {
       logger.log("saving game");
       save_game(pls, board);
-      wait_keypress("game saved, press any key to return to game...");
+      wait_keypress("saving game, press any key to return to game...");
     } else if (key == 'l') {
       logger.log("exiting game");
       quit = TRUE;
@@ -879,16 +1272,36 @@ int pause_menu(Players *pls, Board *board, const char game_board[]) {
   return quit;
 }
 
-void game_loop(Players *pls, Board *board, const char game_board[]) {
+void game_loop(Players *pls, Board *board, const BoardRender *render,
+               const int turn) {
   logger.enter_fn(__func__);
-  logger.log("entering game loop");
+  logger.log("entering game loop at turn %i", turn);
+
+  TokenLayer *layer = create_token_layer(render, board, pls);
+  start_autosave(pls, board, turn);
+
+  // the dice of the game only depend on its seed, so a game played from its
+  // start can be rebuilt from the seed and the number of turns
+  const unsigned long long seed = new_dice_seed();
+  seed_dice(seed);
+  // a resumed game can not be replayed, so it is neither archived, rated nor
+  // counted, which keeps the ratings and statistics rebuildable from the
+  // history
+  const int is_archivable = turn == 0 && are_players_at_start(pls);
+  GameTally game_tally;
+  if (is_archivable) {
+    clear_game_tally(&game_tally);
+    set_game_tally(&game_tally);
+  }
 
+  int turns_played = turn;
   int quit_game = FALSE;
   while (!quit_game) {
-    int i = 0;
+    // a resumed game starts the round with the player it was interrupted at
+    int i = turns_played % get_players_num(pls);
     while (i < get_players_num(pls)) {
       new_screen();
-      print_board(game_board);
+      print_board(layer->game_board);
       print_positions(board, pls);
       printf("\nTURN: %s", get_username(get_player(pls, i)));
       printf("\npress 'r' to roll, 'p' to pause game\n");
@@ -896,20 +1309,24 @@ void game_loop(Players *pls, Board *board, const char game_board[]) {
 
       logger.log("asking %s for keypress", get_username(get_player(pls, i)));
       int get_keypress = TRUE;
+      int is_rolled = FALSE;
       while (get_keypress) {
         char keypress = _getch();
         get_keypress = FALSE;
 
         if (keypress == 'p') {
           logger.log("game paused");
-          quit_game = pause_menu(pls, board, game_board);
+          quit_game = pause_menu(pls, board, layer->game_board);
         } else if (keypress == 'r') {
           logger.log("rolling dice");
           const int roll = roll_dice();
+          is_rolled = TRUE;
           printf("\n%s rolled a %d\n", get_username(get_player(pls, i)), roll);
           logger.log("%s rolled a %i", get_username(get_player(pls, i)), roll);
 
+          const int from = get_position(get_player(pls, i));
           move_player(pls, get_player(pls, i), roll, board);
+          move_token(layer, i, from, get_position(get_player(pls, i)));
           wait_keypress("press to continue...");
 
           logger.log("moved player");
@@ -922,9 +1339,22 @@ void game_loop(Players *pls, Board *board, const char game_board[]) {
       }
       if (quit_game) {
         logger.log("returning to main menu");
+        stop_autosave();
+        set_game_tally(NULL);
+        free_token_layer(layer);
         logger.exit_fn();
         return;
       }
+      if (!is_rolled) {
+        // back from the pause menu, the same player is asked again, since a
+        // turn without a roll would not be replayed from the archive
+        logger.log("resuming game");
+        continue;
+      }
+      turns_played = turns_played + 1;
+      autosave_turn(pls, board, turns_played);
+      poll_saving();
+      poll_leaderboard();
       i = i + 1;
     }
 
@@ -937,6 +1367,17 @@ void game_loop(Players *pls, Board *board, const char game_board[]) {
       Player pl = *get_player(pls, winner_idx);
       logger.log("winner is: %s", get_username(&pl));
 
+      // the history and the leaderboard are written while the winner is shown
+      IoRequest *archived = NULL;
+      int changes[MAX_NUM_PLAYERS];
+      if (is_archivable) {
+        // ratings and statistics read for the first time are computed from
+        // the history, so they are updated before the game is in it
+        rate_players(pls, board, changes);
+        record_game_stats(&game_tally, pls, board);
+        archived = archive_game(pls, board, seed, turns_played);
+      }
+
       logger.log("creating entry for leaderboard");
       Entry winner;
       set_name(&winner, get_username(&pl));
@@ -945,13 +1386,46 @@ void game_loop(Players *pls, Board *board, const char game_board[]) {
 
       new_screen();
       printf("Congratulations %s, you are the winner!\n", get_username(&pl));
+      if (is_archivable) {
+        print_ratings(pls, changes);
+      }
       wait_keypress("press any key to return to main menu");
+      finish_io(archived);
+      sync_leaderboard();
     }
   }
+  stop_autosave();
+  set_game_tally(NULL);
+  free_token_layer(layer);
+
   logger.exit_fn();
   return;
 }
 
+void set_game_tally(GameTally *t) { tally = t; }
+
+void replay_turns(Players *pls, Board *board, const unsigned long long seed,
+                  const int turns, GameTally *t) {
+  logger.enter_fn(__func__);
+  logger.log("replaying %i turns", turns);
+
+  // a game being played keeps its own tally while another one is replayed
+  GameTally *played_tally = tally;
+  tally = t;
+  seed_dice(seed);
+  are_moves_quiet = TRUE;
+  int turns_played = 0;
+  while (turns_played < turns) {
+    Player *pl = get_player(pls, turns_played % get_players_num(pls));
+    move_player(pls, pl, roll_dice(), board);
+    turns_played = turns_played + 1;
+  }
+  are_moves_quiet = FALSE;
+  tally = played_tally;
+
+  logger.exit_fn();
+}
+
 void new_game() {
   logger.enter_fn(__func__);
   new_screen();
@@ -962,20 +1436,18 @@ void new_game() {
   int num_players =
       ask_num_in_range(MIN_NUM_PLAYERS, MAX_NUM_PLAYERS, "players");
 
-  Board *board = create_board(num_squares);
+  // the board is copied since the game loop takes a mutable one, the cached
+  // render is only read
+  Board board = *get_cached_board(num_squares);
   Players *pls = create_players(num_players);
 
-  const char *game_board =
-      build_board(*board, DEFAULT_COLS, DEFAULT_SQUARE_LEN, BORDERS);
-
   new_screen();
   sort_players_by_dice(pls);
 
   new_screen();
-  game_loop(pls, board, game_board);
+  game_loop(pls, &board, get_cached_render(num_squares), 0);
 
   free(pls);
-  free(board);
 
   logger.exit_fn();
 }
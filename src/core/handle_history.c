@@ -0,0 +1,131 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <string.h>
+
+#include "../inc/globals.h"
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/gamestate.h"
+#include "../common/inc/types/player.h"
+#include "../common/inc/types/players.h"
+
+#include "../common/inc/bytes.h"
+#include "../common/inc/iopool.h"
+#include "../common/inc/journal.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/string.h"
+
+#include "../inc/handle_game.h"
+
+#include "../inc/handle_history.h"
+#include "../inc/private/handle_history.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+unsigned char *encode_history_record(unsigned char *cursor, Players *pls,
+                                     Board *board,
+                                     const unsigned long long seed,
+                                     const int turns) {
+  cursor = write_u64(cursor, seed);
+  cursor[0] = get_dim(board);
+  cursor[1] = get_players_num(pls);
+  cursor = cursor + 2;
+
+  int i = 0;
+  while (i < get_players_num(pls)) {
+    const Player *pl = get_player(pls, i);
+    // usernames are always padded to their maximum length
+    memset(cursor, STR_END, MAX_USERNAME_LENGTH);
+    memcpy(cursor, get_username(pl), strlen(get_username(pl)));
+    cursor = cursor + MAX_USERNAME_LENGTH;
+    i = i + 1;
+  }
+  return write_varint(cursor, turns);
+}
+
+IoRequest *archive_game(Players *pls, Board *board,
+                        const unsigned long long seed, const int turns) {
+  logger.enter_fn(__func__);
+  logger.log("archiving game of %i turns", turns);
+
+  unsigned char record[HISTORY_RECORD_MAX_SIZE];
+  const unsigned char *end =
+      encode_history_record(record, pls, board, seed, turns);
+
+  // the record is appended after the last valid one
+  Journal *j = open_journal(HISTORY_FILE);
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+  }
+  logger.log("archiving game after %i others", j->num_records);
+  IoRequest *req = append_journal(HISTORY_FILE, j, record, end - record);
+  close_journal(j);
+
+  logger.exit_fn();
+  return req;
+}
+
+int replay_game(const unsigned char data[], const int size, GameState *gs,
+                GameTally *t) {
+  logger.enter_fn(__func__);
+
+  const unsigned char *end = data + size;
+  if (size < HISTORY_RECORD_HEADER_SIZE) {
+    logger.exit_fn();
+    return FALSE;
+  }
+  const unsigned long long seed = read_u64(data);
+  const int dim = data[8];
+  const int players_num = data[9];
+  const unsigned char *cursor = data + HISTORY_RECORD_HEADER_SIZE;
+  if (dim < MIN_NUM_SQUARES || dim > MAX_NUM_SQUARES ||
+      players_num < MIN_NUM_PLAYERS || players_num > MAX_NUM_PLAYERS ||
+      end - cursor < players_num * MAX_USERNAME_LENGTH) {
+    logger.log("malformed record");
+    logger.exit_fn();
+    return FALSE;
+  }
+
+  Players pls;
+  set_players_num(&pls, players_num);
+  int i = 0;
+  while (i < players_num) {
+    char username[MAX_USERNAME_LENGTH + 1];
+    memcpy(username, cursor, MAX_USERNAME_LENGTH);
+    username[MAX_USERNAME_LENGTH] = STR_END;
+
+    Player *pl = get_player(&pls, i);
+    set_username(pl, username);
+    set_id(pl);
+    set_position(pl, INITIAL_POSITION);
+    set_score(pl, INITIAL_SCORE);
+    set_turns_blocked(pl, NO_TURNS_BLOCKED);
+    cursor = cursor + MAX_USERNAME_LENGTH;
+    i = i + 1;
+  }
+
+  unsigned turns;
+  cursor = read_varint(cursor, end, &turns);
+  if (cursor != end || turns > HISTORY_MAX_TURNS) {
+    logger.log("malformed record");
+    logger.exit_fn();
+    return FALSE;
+  }
+
+  Board board = *get_cached_board(dim);
+  replay_turns(&pls, &board, seed, turns, t);
+  set_game_name(gs, HISTORY_GAME_NAME);
+  set_players(gs, &pls);
+  set_board(gs, &board);
+
+  logger.log("replayed game of %i turns", turns);
+  logger.exit_fn();
+  return TRUE;
+}
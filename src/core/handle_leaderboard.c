@@ -9,14 +9,27 @@
 #include "../inc/globals.h"
 #include "../inc/inputs.h"
 
+#include "../common/inc/bytes.h"
 #include "../common/inc/error.h"
+#include "../common/inc/extsort.h"
+#include "../common/inc/iopool.h"
+#include "../common/inc/journal.h"
+#include "../common/inc/legacy.h"
 #include "../common/inc/logger.h"
+#include "../common/inc/merge.h"
+#include "../common/inc/ranking.h"
+#include "../common/inc/ranktree.h"
 #include "../common/inc/string.h"
 #include "../common/inc/term.h"
+#include "../common/inc/timewindow.h"
 
 #include "../common/inc/types/entries.h"
+#include "../common/inc/types/gamestate.h"
 
+#include "../inc/handle_game.h"
+#include "../inc/handle_history.h"
 #include "../inc/handle_leaderboard.h"
+#include "../inc/handle_stats.h"
 #include "../inc/private/handle_leaderboard.h"
 
 #include <conio.h>
@@ -29,190 +42,610 @@
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
-void read_leaderboard(Entries *es) {
-  logger.enter_fn(__func__);
-  logger.log("attempting to read leaderboard");
+void decode_entry(const JournalRecord *rec, Entry *e) {
+  char name[MAX_USERNAME_LENGTH + 1];
+  snprintf(name, MAX_USERNAME_LENGTH + 1, "%.*s", MAX_USERNAME_LENGTH,
+           (const char *)rec->data);
+  set_name(e, name);
+  set_final_score(e, read_i32(rec->data + MAX_USERNAME_LENGTH));
+}
+
+/**
+ * @brief The leaderboard file, opened the first time it is needed.
+ */
+static RankTree *tree = NULL;
+
+/**
+ * @brief The entries queued since the last batch, or @c NULL if none is.
+ */
+static Ranking *batch = NULL;
+
+/**
+ * @brief The time the last batch was merged into the leaderboard.
+ */
+static clock_t last_batch = 0;
+
+/**
+ * @brief The write of the last batch, whose outcome has not been checked yet.
+ */
+static IoRequest *pending_batch = NULL;
+
+/**
+ * @brief The best entries of the last days, read the first time they are
+ *        needed.
+ */
+static TimeWindows windows;
+
+/**
+ * @brief Whether @c windows has been read from its file.
+ */
+static int is_windows_loaded = FALSE;
+
+/**
+ * @brief Whether @c windows has changed since it was last written.
+ */
+static int is_windows_changed = FALSE;
+
+/**
+ * @brief The last write of @c windows, whose outcome has not been checked yet.
+ */
+static IoRequest *pending_windows = NULL;
+
+/**
+ * @brief Reads the valid entries of a legacy leaderboard, one at a time.
+ */
+static Ranking *read_legacy_entries(LegacyFile *lf) {
+  Ranking *r = new_ranking();
+  int i = 0;
+  while (i < lf->count) {
+    Entry e;
+    const int outcome = next_legacy_entry(lf, &e);
+    if (outcome == LEGACY_VALID) {
+      upsert_ranking(r, &e);
+    } else {
+      logger.log("skipping legacy entry %i, problem %i", i, outcome);
+    }
+    i = i + 1;
+  }
+  return r;
+}
 
+/**
+ * @brief Checks whether the leaderboard file starts like a journal.
+ */
+static int is_leaderboard_journal(void) {
   FILE *fp;
   if (fopen_s(&fp, LEADERBOARD_FILE, "rb")) {
+    return FALSE;
+  }
+  char magic[JOURNAL_MAGIC_LEN];
+  const int is_journal =
+      fread(magic, 1, JOURNAL_MAGIC_LEN, fp) == JOURNAL_MAGIC_LEN &&
+      memcmp(magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) == 0;
+  fclose(fp);
+  return is_journal;
+}
+
+/**
+ * @brief Replays the records of a leaderboard journal, in the order they were
+ *        written.
+ */
+static Ranking *replay_leaderboard_journal(void) {
+  Journal *j = open_journal(LEADERBOARD_FILE);
+  Ranking *r = new_ranking();
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+    if (rec.size != LEADERBOARD_RECORD_SIZE) {
+      logger.log("skipping record of %i bytes", rec.size);
+      continue;
+    }
+    Entry e;
+    decode_entry(&rec, &e);
+    upsert_ranking(r, &e);
+  }
+  logger.log("replayed %i records, %i corrupted", j->num_records,
+             j->num_corrupted);
+  close_journal(j);
+  return r;
+}
+
+void migrate_leaderboard(void) {
+  logger.enter_fn(__func__);
+
+  wait_file_io(LEADERBOARD_FILE);
+  LegacyFile lf;
+  if (!open_legacy(&lf, LEADERBOARD_FILE)) {
     throw_err(FILE_NOT_READABLE_ERROR);
   }
+  if (lf.kind == LEGACY_LEADERBOARD && !is_legacy_count_valid(&lf)) {
+    logger.log("legacy leaderboard has %i entries", lf.count);
+    logger.stop();
+    throw_err(CORRUPTED_LEADERBOARD_ERROR);
+  }
+  Ranking *migrated = NULL;
+  if (lf.kind == LEGACY_LEADERBOARD) {
+    migrated = read_legacy_entries(&lf);
+  }
+  close_legacy(&lf);
+  if (!migrated && is_leaderboard_journal()) {
+    migrated = replay_leaderboard_journal();
+  }
+  if (!migrated) {
+    logger.exit_fn();
+    return;
+  }
 
-  if (is_file_empty(fp)) {
-    logger.log("the leaderboard is empty");
-    set_num_entries(es, NO_ENTRIES);
-  } else {
-    logger.log("reading leaderboard from file");
-    fread(es, sizeof(*es), 1, fp);
+  // one more item than needed, so that an empty leaderboard allocates too
+  const int num_entries = get_num_ranked(migrated);
+  Entry *entries = (Entry *)malloc(  // NOLINT
+      (num_entries + 1) * sizeof(Entry));
+  if (!entries) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
   }
-  fclose(fp);
+  get_ranked_entries(migrated, 0, num_entries, entries);
+  logger.log("migrating %i entries", num_entries);
+  finish_io(write_rank_tree(LEADERBOARD_FILE, entries, num_entries));
+  free(entries);
+  free_ranking(migrated);
+
+  logger.exit_fn();
+}
+
+void load_leaderboard(void) {
+  if (tree) {
+    return;
+  }
+  logger.enter_fn(__func__);
+  logger.log("attempting to read leaderboard");
+
+  migrate_leaderboard();
+  tree = open_rank_tree(LEADERBOARD_FILE);
+  logger.log("opened leaderboard with %i entries", get_tree_size(tree));
 
   logger.exit_fn();
 }
 
-int find_duplicate_entry(Entries es, Entry e) {
+/**
+ * @brief Reads the best entries of the last days, unless they are already
+ *        read.
+ */
+static void load_windows(void) {
+  if (is_windows_loaded) {
+    return;
+  }
   logger.enter_fn(__func__);
-  logger.log("searching for another entry with username '%s'", get_name(&e));
 
-  int index = INDEX_NOT_FOUND;
+  clear_time_windows(&windows);
+  Journal *j = open_journal(WINDOWS_FILE);
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+    TimeBucket b;
+    if (!decode_time_bucket(rec.data, rec.size, &b)) {
+      logger.log("skipping bucket of %i bytes", rec.size);
+      continue;
+    }
+    TimeBucket *kept = &windows.buckets[b.day % WINDOW_DAYS];
+    if (b.day > kept->day) {
+      *kept = b;
+    }
+  }
+  close_journal(j);
+  is_windows_loaded = TRUE;
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Writes the best entries of the last days if they have changed, one
+ *        record per day.
+ */
+static void save_windows(void) {
+  if (!is_windows_changed) {
+    return;
+  }
+  logger.enter_fn(__func__);
 
+  unsigned char data[WINDOW_DAYS][WINDOW_RECORD_MAX_SIZE];
+  JournalRecord recs[WINDOW_DAYS];
+  int num_records = 0;
   int i = 0;
-  while (i < get_num_entries(&es)) {
-    const Entry ei = get_entry(&es, i);
-    if (strcmp(get_name(&e), get_name(&ei)) == 0) {
-      index = i;
+  while (i < WINDOW_DAYS) {
+    const TimeBucket *b = &windows.buckets[i];
+    if (b->day != WINDOW_NO_DAY) {
+      const unsigned char *end = encode_time_bucket(data[num_records], b);
+      recs[num_records].data = data[num_records];
+      recs[num_records].size = end - data[num_records];
+      num_records = num_records + 1;
     }
     i = i + 1;
   }
+  finish_io(pending_windows);
+  pending_windows = write_journal(WINDOWS_FILE, NULL, recs, num_records);
+  is_windows_changed = FALSE;
 
   logger.exit_fn();
-  return index;
 }
 
-void swap_entries(Entry *first, Entry *second) {
+void unload_leaderboard(void) {
   logger.enter_fn(__func__);
-  logger.log("swapping %s with %s", get_name(first), get_name(second));
 
-  Entry temp = *first;
-  *first = *second;
-  *second = temp;
+  sync_leaderboard();
+  close_rank_tree(tree);
+  tree = NULL;
+  is_windows_loaded = FALSE;
 
   logger.exit_fn();
-  return;
 }
 
-void rm_duplicate_entries(Entries *es) {
+/**
+ * @brief Merges the queued entries into the leaderboard, with a single write.
+ */
+static void merge_batch(void) {
+  if (!batch) {
+    return;
+  }
   logger.enter_fn(__func__);
-  logger.log("removing duplicate entries");
 
-  int num_entries = get_num_entries(es);
-  int i = 0;
-  while (i < num_entries - 1) {
-    Entry current = get_entry(es, i);
-    Entry next = get_entry(es, i + 1);
-    if (strcmp(get_name(&current), get_name(&next)) == 0) {
-      int j = i + 1;
-      while (j < num_entries - 1) {
-        Entry e = get_entry(es, j + 1);
-        set_entry(es, &e, j);
-        j = j + 1;
-      }
-      num_entries = num_entries - 1;
-      // Continue checking from this index to ensure no other duplicates were
-      // missed
-      i = i - 1;
-    }
-    i = i + 1;
+  load_leaderboard();
+  const int num_entries = get_num_ranked(batch);
+  Entry *entries = (Entry *)malloc(num_entries * sizeof(Entry));  // NOLINT
+  if (!entries) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  get_ranked_entries(batch, 0, num_entries, entries);
+  free_ranking(batch);
+  batch = NULL;
+
+  // waits for the write of the previous batch, usually done by now, and
+  // throws if it failed
+  finish_io(pending_batch);
+  pending_batch = upsert_rank_tree(tree, entries, num_entries);
+  free(entries);
+  save_windows();
+  last_batch = clock();
+  logger.log("merged batch of %i entries, %s", num_entries,
+             pending_batch ? "writing it" : "nothing changed");
+
+  logger.exit_fn();
+}
+
+void read_leaderboard(Entries *es) {
+  merge_batch();
+  load_leaderboard();
+  set_num_entries(es, get_tree_entries(tree, 0, MAX_ENTRIES, get_entries(es)));
+}
+
+void read_window_leaderboard(Entries *es, const int window) {
+  if (window == LEADERBOARD_ALL_TIME) {
+    read_leaderboard(es);
+    return;
+  }
+  load_windows();
+  const int num_days = window == LEADERBOARD_TODAY ? 1 : WINDOW_DAYS;
+  set_num_entries(es, get_window_entries(&windows, day_of(time(NULL)),
+                                         num_days, get_entries(es)));
+}
+
+void write_leaderboard(Entry e) {
+  logger.enter_fn(__func__);
+  logger.log("attempting to save current entry");
+
+  load_windows();
+  if (add_window_entry(&windows, day_of(time(NULL)), &e)) {
+    is_windows_changed = TRUE;
+  }
+  if (!batch) {
+    batch = new_ranking();
+  }
+  upsert_ranking(batch, &e);
+  logger.log("queued entry, %i in batch", get_num_ranked(batch));
+  poll_leaderboard();
+  if (batch && get_num_ranked(batch) >= LEADERBOARD_MAX_BATCH) {
+    merge_batch();
   }
 
   logger.exit_fn();
-  return;
 }
 
-void sort_entries(Entries *es) {
+void poll_leaderboard(void) {
+  if (pending_batch && poll_io(pending_batch) != IO_PENDING) {
+    finish_io(pending_batch);
+    pending_batch = NULL;
+  }
+  if (pending_windows && poll_io(pending_windows) != IO_PENDING) {
+    finish_io(pending_windows);
+    pending_windows = NULL;
+  }
+  // a batch is merged right away after a quiet interval, and entries coming
+  // in the meantime wait for the next one
+  if (batch && clock() - last_batch >=
+                   LEADERBOARD_BATCH_INTERVAL * CLOCKS_PER_SEC / 1000) {
+    merge_batch();
+  }
+}
+
+void sync_leaderboard(void) {
   logger.enter_fn(__func__);
-  logger.log("sorting entries");
 
-  int num_entries = get_num_entries(es) - 1;
+  merge_batch();
+  finish_io(pending_batch);
+  pending_batch = NULL;
+  finish_io(pending_windows);
+  pending_windows = NULL;
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Adds the winner of every game of the history to a sort.
+ */
+static void sort_history_winners(EntrySorter *s) {
+  Journal *j = open_journal(HISTORY_FILE);
+  int num_skipped = 0;
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+    GameState gs;
+    if (!replay_game(rec.data, rec.size, &gs, NULL)) {
+      num_skipped = num_skipped + 1;
+      continue;
+    }
+    Players pls = get_players(&gs);
+    Board board = get_board(&gs);
+    const int winner_idx = find_winner(&pls, &board);
+    if (winner_idx == INDEX_NOT_FOUND) {
+      num_skipped = num_skipped + 1;
+      continue;
+    }
+    const Player *pl = get_player(&pls, winner_idx);
+    Entry e;
+    set_name(&e, get_username(pl));
+    set_final_score(&e, get_score(pl));
+    add_sort_entry(s, &e);
+  }
+  logger.log("read %i games, skipped %i", j->num_records, num_skipped);
+  close_journal(j);
+}
+
+void rebuild_leaderboard(void) {
+  logger.enter_fn(__func__);
+  logger.log("rebuilding leaderboard from the history");
+
+  sync_leaderboard();
+  load_leaderboard();
+  EntrySorter *s =
+      new_entry_sorter(LEADERBOARD_FILE, LEADERBOARD_REBUILD_BUDGET);
+  sort_history_winners(s);
+  const int num_runs = finish_entry_sort(s);
+
+  // the leaderboard is merged too, so that no score is lost, such as the ones
+  // of games won before the history was kept
+  RankTree **shards = (RankTree **)malloc(  // NOLINT
+      (num_runs + 1) * sizeof(RankTree *));
+  int capacity = MERGE_BUFFER_ENTRIES;
+  int num_entries = 0;
+  Entry *entries = (Entry *)malloc(capacity * sizeof(Entry));  // NOLINT
+  if (!shards || !entries) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
   int i = 0;
-  while (i < num_entries) {
-    int j = i + 1;
-    while (j < num_entries) {
-      Entry ei = get_entry(es, i);
-      Entry ej = get_entry(es, j);
-      int is_score_greater = get_final_score(&ej) > get_final_score(&ei);
-      int is_score_equal = get_final_score(&ej) == get_final_score(&ei);
-      int is_name_previous = strcmp(get_name(&ej), get_name(&ei)) < 0;
-      int should_swap_entries =
-          is_score_greater || (is_score_equal && is_name_previous);
-
-      if (should_swap_entries) {
-        swap_entries(&ei, &ej);
+  while (i < num_runs) {
+    shards[i] = s->runs[i];
+    i = i + 1;
+  }
+  shards[num_runs] = tree;
+  Merge *m = start_merge(shards, num_runs + 1);
+  Entry e;
+  while (next_merged(m, &e)) {
+    if (num_entries == capacity) {
+      capacity = 2 * capacity;
+      Entry *grown = (Entry *)realloc(  // NOLINT
+          entries, capacity * sizeof(Entry));
+      if (!grown) {
+        logger.stop();
+        throw_err(ALLOCATION_ERROR);
       }
-      j = j + 1;
+      entries = grown;
     }
-    i = i + 1;
+    entries[num_entries] = e;
+    num_entries = num_entries + 1;
   }
-  rm_duplicate_entries(es);
+  end_merge(m);
+  free(shards);
+  free_entry_sorter(s);
+
+  unload_leaderboard();
+  finish_io(write_rank_tree(LEADERBOARD_FILE, entries, num_entries));
+  free(entries);
+  logger.log("rebuilt leaderboard with %i entries", num_entries);
 
   logger.exit_fn();
-  return;
 }
 
-void write_leaderboard(Entry e) {
+/**
+ * @brief The text of the leaderboard view, drawn at once.
+ */
+static ScreenBuffer screen;
+
+void read_leaderboard_page(LeaderboardView *v) {
   logger.enter_fn(__func__);
-  logger.log("attempting to save current entry");
 
-  Entries leaderboard;
-  read_leaderboard(&leaderboard);
-  int num_entries = get_num_entries(&leaderboard);
-  logger.log("read %i entries in leaderboard", num_entries);
-
-  int write_idx = num_entries;
-  int count = num_entries;
-  if (num_entries != NO_ENTRIES) {
-    write_idx = write_idx - 1;
-  }
-
-  logger.log("searching for a duplicate entry");
-  int duplicate_idx = find_duplicate_entry(leaderboard, e);
-  if (duplicate_idx != INDEX_NOT_FOUND) {
-    logger.log("duplicate found at pos. %i", duplicate_idx);
-    Entry duplicate = get_entry(&leaderboard, duplicate_idx);
-    // score in leaderboard is greater, do not write
-    if (get_final_score(&duplicate) > get_final_score(&e)) {
-      logger.log("score in file is greater than given score, not writing");
-      logger.exit_fn();
-      return;
-    }
-    logger.log("score in file is lesser, writing");
+  Entries es;
+  if (v->window == LEADERBOARD_ALL_TIME) {
+    merge_batch();
+    load_leaderboard();
+    v->num_entries = get_tree_size(tree);
+  } else {
+    read_window_leaderboard(&es, v->window);
+    v->num_entries = get_num_entries(&es);
+  }
+  if (v->first > v->num_entries - v->page_size) {
+    v->first = v->num_entries - v->page_size;
+  }
+  if (v->first < 0) {
+    v->first = 0;
+  }
 
-    write_idx = duplicate_idx;
-    logger.log("set writing index as %i", duplicate_idx);
+  if (v->window == LEADERBOARD_ALL_TIME) {
+    v->num_shown = get_tree_entries(tree, v->first, v->page_size, v->entries);
+    if (v->num_shown > 0) {
+      v->first_rank = get_score_rank(tree, get_final_score(&v->entries[0]));
+    }
+  } else {
+    v->num_shown = 0;
+    while (v->num_shown < v->page_size &&
+           v->first + v->num_shown < v->num_entries) {
+      v->entries[v->num_shown] = get_entry(&es, v->first + v->num_shown);
+      v->num_shown = v->num_shown + 1;
+    }
+    // the first entry shares the rank of the first entry with its score
+    int i = v->first;
+    while (i > 0 && v->num_shown > 0) {
+      const Entry e = get_entry(&es, i - 1);
+      if (get_final_score(&e) != get_final_score(&v->entries[0])) {
+        break;
+      }
+      i = i - 1;
+    }
+    v->first_rank = i + 1;
   }
-  logger.log("no duplicate found");
+  logger.log("read %i entries from %i of %i", v->num_shown, v->first,
+             v->num_entries);
 
-  if (num_entries == MAX_ENTRIES) {
-    logger.log("reached max number of entries in leaderboard");
+  logger.exit_fn();
+}
 
-    logger.log("checking if the last entry has lower score than given one");
-    Entry last = get_entry(&leaderboard, MAX_ENTRIES - 1);
-    if (get_final_score(&last) > get_final_score(&e)) {
-      logger.log("last entry has greater score, not writing");
-      logger.exit_fn();
-      return;
+void find_leaderboard_player(LeaderboardView *v, const char name[]) {
+  logger.enter_fn(__func__);
+
+  snprintf(v->sought, MAX_USERNAME_LENGTH + 1, "%s", name);
+  v->marked = LEADERBOARD_NO_MARK;
+  if (v->window == LEADERBOARD_ALL_TIME) {
+    merge_batch();
+    load_leaderboard();
+    const int position = get_tree_position(tree, name);
+    if (position != RANK_TREE_NOT_FOUND) {
+      v->marked = position;
     }
-    logger.log("entry has greater score, overwriting");
   } else {
-    logger.log("appending");
-    count = count + 1;
+    Entries es;
+    read_window_leaderboard(&es, v->window);
+    int i = 0;
+    while (i < get_num_entries(&es) && v->marked == LEADERBOARD_NO_MARK) {
+      const Entry e = get_entry(&es, i);
+      if (strcmp(get_name(&e), v->sought) == 0) {
+        v->marked = i;
+      }
+      i = i + 1;
+    }
   }
+  // the player is shown in the middle of the page
+  if (v->marked != LEADERBOARD_NO_MARK) {
+    v->first = v->marked - v->page_size / 2;
+  }
+  logger.log("player %s is at %i", v->sought, v->marked);
 
-  logger.log("setting entry in leaderboard");
-  set_entry(&leaderboard, &e, write_idx);
-  set_num_entries(&leaderboard, count);
-  sort_entries(&leaderboard);
+  logger.exit_fn();
+}
 
-  FILE *fp;
-  if (fopen_s(&fp, LEADERBOARD_FILE, "wb")) {
-    throw_err(FILE_NOT_WRITABLE_ERROR);
+/**
+ * @brief Names the window of days a leaderboard is shown for.
+ */
+static const char *window_name(const int window) {
+  if (window == LEADERBOARD_TODAY) {
+    return "today";
   }
-  fwrite(&leaderboard, sizeof(leaderboard), 1, fp);
-  fclose(fp);
+  if (window == LEADERBOARD_THIS_WEEK) {
+    return "this week";
+  }
+  return "all time";
+}
 
-  logger.log("wrote leaderboard to file");
-  logger.exit_fn();
+/**
+ * @brief Finds the window of days shown when a key is pressed.
+ *
+ * @return The window, or @c LEADERBOARD_NO_WINDOW if the key shows none.
+ */
+static int window_of_key(const int key) {
+  if (key == LEADERBOARD_TODAY_KEY) {
+    return LEADERBOARD_TODAY;
+  }
+  if (key == LEADERBOARD_THIS_WEEK_KEY) {
+    return LEADERBOARD_THIS_WEEK;
+  }
+  if (key == LEADERBOARD_ALL_TIME_KEY) {
+    return LEADERBOARD_ALL_TIME;
+  }
+  return LEADERBOARD_NO_WINDOW;
+}
+
+/**
+ * @brief Computes the number of entries fitting in the terminal, below the
+ *        title bar and above the keys of the view.
+ */
+static int leaderboard_page_size(void) {
+  int width, height;
+  get_term_size(&width, &height);
+  int page_size = height - LEADERBOARD_VIEW_LINES;
+  if (page_size > LEADERBOARD_MAX_PAGE) {
+    page_size = LEADERBOARD_MAX_PAGE;
+  }
+  return page_size < 1 ? 1 : page_size;
 }
 
-void print_leaderboard(Entries es) {
+/**
+ * @brief Adds the keys of the leaderboard view below the leaderboard.
+ */
+static void add_leaderboard_keys(const LeaderboardView *v) {
+  screen_line(&screen, "");
+  if (v->sought[0] != STR_END && v->marked == LEADERBOARD_NO_MARK) {
+    screen_line(&screen, "No entry of %s in the best scores of %s", v->sought,
+                window_name(v->window));
+  } else if (v->num_entries > 0) {
+    screen_line(&screen, "Showing %i-%i of %i, the best scores of %s",
+                v->first + 1, v->first + v->num_shown, v->num_entries,
+                window_name(v->window));
+  } else {
+    screen_line(&screen, "Showing the best scores of %s",
+                window_name(v->window));
+  }
+  StatsRow row;
+  if (v->sought[0] != STR_END && get_player_stats(v->sought, &row)) {
+    screen_line(&screen,
+                "%s won %i of %i games, in %.1f turns a game (%.1f for "
+                "everyone)",
+                v->sought, row.wins, row.games, (double)row.turns / row.games,
+                get_average_turns());
+  }
+  screen_line(&screen, "Scroll it with PGUP/PGDN/HOME/END, find a player "
+                       "with %c",
+              LEADERBOARD_FIND_KEY);
+  screen_line(&screen,
+              "Show the best scores of today/this week/all time by pressing "
+              "%c/%c/%c",
+              LEADERBOARD_TODAY_KEY, LEADERBOARD_THIS_WEEK_KEY,
+              LEADERBOARD_ALL_TIME_KEY);
+  screen_line(&screen, "Rebuild it from the history of the games by pressing "
+                       "%c",
+              LEADERBOARD_REBUILD_KEY);
+  screen_line(&screen, "Exit this view by pressing b/ESC/ENTER/SPACEBAR");
+}
+
+void print_leaderboard(const LeaderboardView *v) {
   logger.enter_fn(__func__);
   logger.log("printing leaderboard");
-  new_screen();
-  printf("\n\n");
 
-  if (get_num_entries(&es) == NO_ENTRIES) {
+  start_screen(&screen);
+  screen_line(&screen, "");
+  if (v->num_entries == NO_ENTRIES) {
+    // the message is read from the file of errors, so it is printed apart
     logger.log("leaderboard is empty");
+    flush_screen(&screen);
     print_err(EMPTY_LEADERBOARD);
+    add_leaderboard_keys(v);
+    flush_screen(&screen);
     logger.exit_fn();
     return;
   }
@@ -220,42 +653,98 @@ void print_leaderboard(Entries es) {
   int width, heigth;
   get_term_size(&width, &heigth);
   int padding = (width - strlen(LEADERBOARD_BANNER) - 1) / 2;
+  if (padding < 1) {
+    padding = 1;
+  }
 
   logger.log("leaderboard is NOT empty.");
-  printf("%*c%s", padding, SPACE_CHAR, LEADERBOARD_BANNER);
+  screen_line(&screen, "%*c%s", padding, SPACE_CHAR, LEADERBOARD_BANNER);
   int i = 0;
-  int rank = 1;
-  int prev_score = -1;
-
-  while (i < get_num_entries(&es)) {
-    Entry e = get_entry(&es, i);
-    if (get_final_score(&e) != prev_score) {
-      prev_score = get_final_score(&e);
-      rank = i + 1;
+  int rank = v->first_rank;
+  while (i < v->num_shown) {
+    const Entry *e = &v->entries[i];
+    if (i > 0 && get_final_score(e) != get_final_score(&v->entries[i - 1])) {
+      rank = v->first + i + 1;
     }
-    printf("%*c%3d  %5s  %5d\n", padding, SPACE_CHAR, rank, get_name(&e),
-           get_final_score(&e));
+    const int is_marked = v->first + i == v->marked;
+    screen_line(&screen, "%*c%s" LEADERBOARD_ROW_FMT "%s", padding,
+                SPACE_CHAR, is_marked ? INVERSE : "", rank, get_name(e),
+                get_final_score(e), is_marked ? RESET : "");
+    i = i + 1;
+  }
+  while (i < v->page_size) {
+    screen_line(&screen, "");
     i = i + 1;
   }
+  add_leaderboard_keys(v);
+  flush_screen(&screen);
 
-  logger.log("printed %i entries", i);
+  logger.log("printed %i entries", v->num_shown);
   logger.exit_fn();
 }
 
-void display_leaderboard(Entries es) {
+/**
+ * @brief Asks for the name of a player below the view, and shows their entry.
+ */
+static void ask_leaderboard_player(LeaderboardView *v) {
+  printf("\nFind the player: ");
+  char name[MAX_BUFFER_LEN];
+  scanf_s("%s", name, MAX_BUFFER_LEN);
+  getchar();
+  conform_username(name);
+  find_leaderboard_player(v, name);
+}
+
+void display_leaderboard(void) {
   logger.enter_fn(__func__);
   logger.log("displayin leaderboard");
 
-  print_leaderboard(es);
-  printf("\n\n");
-  printf("Exit this view by pressing b/ESC/ENTER/SPACEBAR");
+  LeaderboardView v;
+  v.window = LEADERBOARD_ALL_TIME;
+  v.first = 0;
+  v.page_size = leaderboard_page_size();
+  v.marked = LEADERBOARD_NO_MARK;
+  v.sought[0] = STR_END;
+  clear_screen();
+  read_leaderboard_page(&v);
+  print_leaderboard(&v);
 
   logger.log("waiting for back key...");
   int display = TRUE;
   while (display) {
-    char key = _getch();
-    if (is_back_key(key)) {
+    const int key = read_key();
+    int is_changed = TRUE;
+    if (key == PAGE_DOWN_KEY) {
+      v.first = v.first + v.page_size;
+    } else if (key == PAGE_UP_KEY) {
+      v.first = v.first - v.page_size;
+    } else if (key == HOME_KEY) {
+      v.first = 0;
+    } else if (key == END_KEY) {
+      v.first = v.num_entries;
+    } else if (key >= EXTENDED_KEYS) {
+      is_changed = FALSE;
+    } else if (is_back_key(key)) {
       display = FALSE;
+      is_changed = FALSE;
+    } else if (key == LEADERBOARD_FIND_KEY) {
+      ask_leaderboard_player(&v);
+    } else if (key == LEADERBOARD_REBUILD_KEY) {
+      rebuild_leaderboard();
+    } else if (window_of_key(key) != LEADERBOARD_NO_WINDOW) {
+      v.window = window_of_key(key);
+      v.first = 0;
+      v.marked = LEADERBOARD_NO_MARK;
+      v.sought[0] = STR_END;
+      logger.log("showing the best scores of %s", window_name(v.window));
+    } else {
+      is_changed = FALSE;
+    }
+    if (is_changed) {
+      // the terminal may have been resized in the meantime
+      v.page_size = leaderboard_page_size();
+      read_leaderboard_page(&v);
+      print_leaderboard(&v);
     }
   }
 
@@ -267,10 +756,7 @@ void leaderboard(void) {
   logger.enter_fn(__func__);
   logger.log("attempting to display leaderboard");
 
-  Entries leaderboard;
-  read_leaderboard(&leaderboard);
-
-  display_leaderboard(leaderboard);
+  display_leaderboard();
 
   logger.log("exited leaderboard view");
   logger.exit_fn();
@@ -0,0 +1,288 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+
+#include "../inc/globals.h"
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/gamestate.h"
+#include "../common/inc/types/player.h"
+#include "../common/inc/types/players.h"
+
+#include "../common/inc/error.h"
+#include "../common/inc/iopool.h"
+#include "../common/inc/journal.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/nameindex.h"
+#include "../common/inc/rating.h"
+
+#include "../inc/handle_game.h"
+#include "../inc/handle_history.h"
+
+#include "../inc/handle_rating.h"
+#include "../inc/private/handle_rating.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The ratings, or @c NULL if they have not been read.
+ */
+static RatingTable *table = NULL;
+
+/**
+ * @brief The journal of the ratings, with every record read, to append the
+ *        ratings of the next games to.
+ */
+static Journal *journal = NULL;
+
+/**
+ * @brief The last write of the ratings, or @c NULL if there is none.
+ */
+static IoRequest *pending = NULL;
+
+/**
+ * @brief Reads the ratings from their journal.
+ *
+ * @return The number of records read.
+ */
+static int read_ratings(void) {
+  logger.enter_fn(__func__);
+
+  table = new_rating_table();
+  journal = open_journal(RATINGS_FILE);
+  int num_skipped = 0;
+  JournalRecord rec;
+  while (next_journal_record(journal, &rec)) {
+    if (!decode_ratings(rec.data, rec.size, table)) {
+      num_skipped = num_skipped + 1;
+    }
+  }
+  release_journal(journal);
+  logger.log("read %i players from %i records, skipped %i",
+             table->num_players, journal->num_records, num_skipped);
+
+  logger.exit_fn();
+  return journal->num_records;
+}
+
+/**
+ * @brief Replaces the journal of the ratings with a snapshot of every player.
+ */
+static void save_ratings(void) {
+  logger.enter_fn(__func__);
+
+  const int num_players = table->num_players;
+  const int num_records =
+      (num_players + RATING_RECORD_MAX_PLAYERS - 1) / RATING_RECORD_MAX_PLAYERS;
+  int *slots = (int *)malloc((num_players + 1) * sizeof(int));  // NOLINT
+  unsigned char *data = (unsigned char *)malloc(  // NOLINT
+      num_players * RATING_ENTRY_SIZE + 1);
+  JournalRecord *recs = (JournalRecord *)malloc(  // NOLINT
+      (num_records + 1) * sizeof(JournalRecord));
+  if (!slots || !data || !recs) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < num_players) {
+    slots[i] = i;
+    i = i + 1;
+  }
+  unsigned char *cursor = data;
+  i = 0;
+  while (i < num_records) {
+    const int first = i * RATING_RECORD_MAX_PLAYERS;
+    int count = num_players - first;
+    if (count > RATING_RECORD_MAX_PLAYERS) {
+      count = RATING_RECORD_MAX_PLAYERS;
+    }
+    recs[i].data = cursor;
+    cursor = encode_ratings(cursor, table, &slots[first], count);
+    recs[i].size = cursor - recs[i].data;
+    i = i + 1;
+  }
+  finish_io(pending);
+  pending = write_journal(RATINGS_FILE, journal, recs, num_records);
+  free(slots);
+  free(data);
+  free(recs);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Compacts the journal of the ratings on a thread of the I/O pool (see
+ *        @c IoRewrite).
+ */
+static unsigned char *compact_ratings(const unsigned char content[],
+                                      const int size, int *new_size) {
+  return compact_keyed_journal(content, size, RATING_ENTRY_SIZE,
+                               RATING_RECORD_MAX_PLAYERS, are_ratings_valid,
+                               new_size);
+}
+
+/**
+ * @brief Computes every rating from the history of the games, then writes
+ *        them.
+ */
+static void rate_history(void) {
+  logger.enter_fn(__func__);
+
+  int capacity = RATING_INITIAL_CAPACITY;
+  int num_games = 0;
+  GameOutcome *games = (GameOutcome *)malloc(  // NOLINT
+      capacity * sizeof(GameOutcome));
+  if (!games) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  Journal *j = open_journal(HISTORY_FILE);
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+    GameState gs;
+    if (!replay_game(rec.data, rec.size, &gs, NULL)) {
+      continue;
+    }
+    if (num_games == capacity) {
+      capacity = 2 * capacity;
+      GameOutcome *grown = (GameOutcome *)realloc(  // NOLINT
+          games, capacity * sizeof(GameOutcome));
+      if (!grown) {
+        logger.stop();
+        throw_err(ALLOCATION_ERROR);
+      }
+      games = grown;
+    }
+    Players pls = get_players(&gs);
+    Board board = get_board(&gs);
+    get_game_outcome(&pls, &board, &games[num_games]);
+    num_games = num_games + 1;
+  }
+  close_journal(j);
+
+  free_rating_table(table);
+  table = new_rating_table();
+  rate_games(table, games, num_games);
+  free(games);
+  save_ratings();
+  logger.log("rated %i players from %i games", table->num_players,
+             num_games);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Reads the ratings, unless they are already read.
+ *
+ * Without any rating, the ratings are computed from the history, which holds
+ * the games played before the ratings were kept.
+ */
+static void load_ratings(void) {
+  if (table) {
+    return;
+  }
+  logger.enter_fn(__func__);
+
+  if (read_ratings() == 0) {
+    rate_history();
+  }
+
+  logger.exit_fn();
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+void get_game_outcome(Players *pls, Board *board, GameOutcome *g) {
+  const int winner_idx = find_winner(pls, board);
+  int progress[MAX_NUM_PLAYERS];
+  g->num_players = get_players_num(pls);
+  int i = 0;
+  while (i < g->num_players) {
+    const Player *pl = get_player(pls, i);
+    g->keys[i] = pack_name(get_username(pl));
+    progress[i] = i == winner_idx ? get_dim(board) : get_position(pl);
+    i = i + 1;
+  }
+  i = 0;
+  while (i < g->num_players) {
+    g->places[i] = 0;
+    int j = 0;
+    while (j < g->num_players) {
+      if (progress[j] > progress[i]) {
+        g->places[i] = g->places[i] + 1;
+      }
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+}
+
+void rate_players(Players *pls, Board *board, int changes[]) {
+  logger.enter_fn(__func__);
+
+  load_ratings();
+  GameOutcome g;
+  get_game_outcome(pls, board, &g);
+  rate_game(table, &g, changes);
+
+  int slots[MAX_NUM_PLAYERS];
+  int i = 0;
+  while (i < g.num_players) {
+    slots[i] = add_rated_player(table, g.keys[i]);
+    i = i + 1;
+  }
+  unsigned char data[MAX_NUM_PLAYERS * RATING_ENTRY_SIZE];
+  const unsigned char *end = encode_ratings(data, table, slots, g.num_players);
+  finish_io(pending);
+  // the pool compacts the journal right after the append, so that the game
+  // does not wait for a snapshot of every player
+  if (journal->num_records >= RATINGS_COMPACT_RATIO * table->num_players) {
+    pending = append_compact_journal(RATINGS_FILE, journal, data, end - data,
+                                     compact_ratings);
+  } else {
+    pending = append_journal(RATINGS_FILE, journal, data, end - data);
+  }
+  logger.log("rated game of %i players", g.num_players);
+
+  logger.exit_fn();
+}
+
+int get_player_rating(const char name[]) {
+  load_ratings();
+  return get_rating(table, pack_name(name));
+}
+
+void rebuild_ratings(void) {
+  logger.enter_fn(__func__);
+  logger.log("rebuilding ratings from the history");
+
+  if (!table) {
+    read_ratings();
+  }
+  rate_history();
+
+  logger.exit_fn();
+}
+
+void unload_ratings(void) {
+  logger.enter_fn(__func__);
+
+  finish_io(pending);
+  pending = NULL;
+  free_rating_table(table);
+  table = NULL;
+  if (journal) {
+    close_journal(journal);
+    journal = NULL;
+  }
+
+  logger.exit_fn();
+}
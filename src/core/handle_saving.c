@@ -13,7 +13,9 @@
 #include "../common/inc/types/players.h"
 
 #include "../common/inc/error.h"
+#include "../common/inc/iopool.h"
 #include "../common/inc/logger.h"
+#include "../common/inc/savefile.h"
 #include "../common/inc/string.h"
 #include "../common/inc/term.h"
 
@@ -27,8 +29,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
-static const char *BORDERS[8] = DEFAULT_BORDERS;
+/**
+ * @brief The last write queued on the save file, whose outcome has not been
+ *        checked yet.
+ */
+static IoRequest *pending_save = NULL;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+void poll_saving(void) {
+  if (pending_save && poll_io(pending_save) != IO_PENDING) {
+    finish_io(pending_save);
+    pending_save = NULL;
+  }
+}
+
+void finish_saving(void) {
+  finish_io(pending_save);
+  pending_save = NULL;
+}
 
 // for debugging purposes
 void print_gamestates(GameStates gss) {
@@ -75,38 +97,53 @@ void print_gamestates(GameStates gss) {
   wait_keypress("press to continue");
 }
 
-int choose_save(GameStates gss) {
+void print_save_details(const SaveSummary *sum) {
+  const int num_players = get_summary_players_num(sum);
+  printf("    * players (%i): [", num_players);
+  int j = 0;
+  while (j < num_players) {
+    printf("%.*s (pos. %i)", MAX_USERNAME_LENGTH,
+           get_summary_username(sum, j), get_summary_position(sum, j) + 1);
+    if (j < num_players - 1) {
+      printf(", ");
+    }
+    j = j + 1;
+  }
+  printf("]\n");
+  printf("    * board with %i squares\n", get_summary_dim(sum));
+
+  const time_t timestamp = get_summary_timestamp(sum);
+  if (timestamp == SAVE_NO_TIMESTAMP) {
+    printf("    * saved on an unknown date\n");
+  } else {
+    struct tm timeinfo;
+    char date[MAX_BUFFER_LEN];
+    localtime_s(&timeinfo, &timestamp);
+    strftime(date, sizeof(date), SAVE_DATE_FORMAT, &timeinfo);
+    printf("    * saved on %s\n", date);
+  }
+}
+
+int choose_save(const SaveFile *sf) {
   logger.enter_fn(__func__);
   logger.log("attempting to ask user to choose a save");
 
+  // only the summaries are read, the games are loaded once chosen
   printf("Please select a save from the following ones:\n");
-  int num_saves = get_num_games(&gss);
+  int num_saves = sf->num_saves;
   int i = 0;
   while (i < num_saves) {
-    GameState gs = *get_gamestate(&gss, i);
-    Players pls = get_players(&gs);
-    Board board = get_board(&gs);
-
-    printf("%i) \"%s\":\n", i, get_game_name(&gs));
-    printf("    * players (%i): [", get_players_num(&pls));
-    int j = 0;
-    while (j < get_players_num(&pls)) {
-      Player pl = *get_player(&pls, j);
-      printf("%s (pos. %i)", get_username(&pl), get_position(&pl) + 1);
-      if (j < get_players_num(&pls) - 1) {
-        printf(", ");
-      }
-      j = j + 1;
-    }
-    printf("]\n");
-    printf("    * board with %i squares\n", get_dim(&board));
+    const SaveSummary sum = get_summary(sf, i);
+    printf("%i) \"%.*s\":\n", i, get_summary_name_len(&sum),
+           get_summary_name(&sum));
+    print_save_details(&sum);
     i = i + 1;
   }
   printf("\nSelect a game or [q]uit and go back to the menu");
   printf("\n> ");
 
   int input;
-  char buffer[4];
+  char buffer[MAX_BUFFER_LEN];
   int invalid_input = FALSE;
 
   do {
@@ -117,7 +154,8 @@ int choose_save(GameStates gss) {
       break;
     }
 
-    if (buffer[0] < '0' || buffer[0] > '4') {
+    // there is no limit to the number of saves, so any number is accepted
+    if (buffer[0] < '0' || buffer[0] > '9') {
       invalid_input = TRUE;
       print_err(INVALID_INPUT_ERROR);
       printf("\n> ");
@@ -126,7 +164,7 @@ int choose_save(GameStates gss) {
 
     input = atoi(buffer);
 
-    if (input < NO_SAVED_GAMES || input > get_num_games(&gss) - 1) {
+    if (input < NO_SAVED_GAMES || input > num_saves - 1) {
       invalid_input = TRUE;
       print_err(INVALID_GAME);
       printf("\n> ");
@@ -139,65 +177,77 @@ int choose_save(GameStates gss) {
   return input;
 }
 
-void read_saves(GameStates *gss) {
+SaveFile *open_saves() {
   logger.enter_fn(__func__);
-  logger.log("attempting to read saves");
+  logger.log("attempting to open saves");
 
-  FILE *fp;
-  if (fopen_s(&fp, SAVED_GAMES_FILE, "rb")) {
-    logger.log("file is not readable");
-    throw_err(FILE_NOT_READABLE_ERROR);
+  if (migrate_save_file(SAVED_GAMES_FILE)) {
+    logger.log("migrated saves from the legacy format");
   }
+  SaveFile *sf = open_save_file(SAVED_GAMES_FILE);
+
+  logger.exit_fn();
+  return sf;
+}
+
+int choose_evicted_save(const SaveFile *sf) {
+  logger.enter_fn(__func__);
+
+  int index = QUIT_GAME;
+  if (EVICTION_POLICY == EVICT_PROMPT) {
+    logger.log("max number of saves reached, asking game to overwrite");
+    new_screen();
+    print_err(LIMIT_SAVES);
+    printf("\n");
 
-  if (is_file_empty(fp)) {
-    logger.log("no saves in file");
-    set_num_games(gss, NO_SAVED_GAMES);
+    index = choose_save(sf);
   } else {
-    logger.log("reading saves from file");
-    fread(gss, sizeof(*gss), 1, fp);
+    time_t min_time = 0;
+    int i = 0;
+    while (i < sf->num_saves) {
+      const SaveSummary sum = get_summary(sf, i);
+      const time_t t = EVICTION_POLICY == EVICT_OLDEST
+                           ? get_summary_timestamp(&sum)
+                           : get_summary_last_used(&sum);
+      if (index == QUIT_GAME || t < min_time) {
+        index = i;
+        min_time = t;
+      }
+      i = i + 1;
+    }
+    logger.log("max number of saves reached, overwriting save %i", index);
   }
-  fclose(fp);
-
-  // print_gamestates(*gss);
 
   logger.exit_fn();
+  return index;
 }
 
 void write_save(GameState gs) {
   logger.enter_fn(__func__);
   logger.log("attempting to save current game");
 
-  GameStates file_gss;
-  read_saves(&file_gss);
-
-  int num_saves = get_num_games(&file_gss);
+  finish_saving();
+  SaveFile *sf = open_saves();
+  int num_saves = sf->num_saves;
   logger.log("currently present %i saves", num_saves);
 
-  if (num_saves >= NO_SAVED_GAMES && num_saves < MAX_SAVED_GAMES) {
-    logger.log("num_saves is inside bounds, appending to struct");
-    set_gamestate(&file_gss, gs, get_num_games(&file_gss));
-    set_num_games(&file_gss, get_num_games(&file_gss) + 1);
-  } else if (num_saves == MAX_SAVED_GAMES) {
-    logger.log("max number of saves reached, asking game to overwrite");
-    new_screen();
-    print_err(LIMIT_SAVES);
-    printf("\n");
-
-    int index = choose_save(file_gss);
-    set_gamestate(&file_gss, gs, index);  // overwrite at index
+  // a game saved again with the same name replaces its previous save
+  int index = find_save(sf, get_game_name(&gs));
+  if (index == SAVE_NOT_FOUND) {
+    index = num_saves;  // append by default
+    if (SAVES_LIMIT != NO_SAVES_LIMIT && num_saves >= SAVES_LIMIT) {
+      index = choose_evicted_save(sf);  // overwrite at index
+    }
+  } else {
+    logger.log("updating save %i", index);
   }
+  close_save_file(sf);
 
-  FILE *fp;
-  if (fopen_s(&fp, SAVED_GAMES_FILE, "wb")) {
-    logger.log("file is not writable");
-    throw_err(FILE_NOT_WRITABLE_ERROR);
+  if (index != QUIT_GAME) {
+    logger.log("queueing save to file");
+    pending_save = put_save(SAVED_GAMES_FILE, &gs, index);
   }
-  fwrite(&file_gss, sizeof(file_gss), 1, fp);
-  fclose(fp);
 
-  logger.log("writing saves to file");
-
-  // print_gamestates(file_gss);  // debug
   logger.exit_fn();
 }
 
@@ -219,10 +269,16 @@ void saved_games() {
   logger.enter_fn(__func__);
   logger.log("checking if saves are present");
 
-  GameStates gss;
-  read_saves(&gss);
+  finish_saving();
+  SaveFile *sf = open_saves();
+  int index = QUIT_GAME;
+
+  if (sf->num_corrupted > 0) {
+    print_err(SKIPPED_RECORDS_ERROR);
+    printf("\n");
+  }
 
-  if (get_num_games(&gss) == 0) {
+  if (sf->num_saves == 0) {
     print_err(NO_SAVES);
     printf("\n");
 
@@ -240,26 +296,12 @@ void saved_games() {
       }
     }
 
-  } else if (get_num_games(&gss) == 1) {
+  } else if (sf->num_saves == 1) {
     printf("Found only the following game: ");
 
-    GameState gs = *get_gamestate(&gss, 0);
-    Players pls = get_players(&gs);
-    Board board = get_board(&gs);
-
-    printf("\n%s : \n", get_game_name(&gs));
-    printf("    * players: [", get_players_num(&pls));
-    int j = 0;
-    while (j < get_players_num(&pls)) {
-      Player pl = *get_player(&pls, j);
-      printf("%s (pos. %i)", get_username(&pl), get_position(&pl) + 1);
-      if (j < get_players_num(&pls) - 1) {
-        printf(", ");
-      }
-      j = j + 1;
-    }
-    printf("]\n");
-    printf("    * board with %i squares\n", get_dim(&board));
+    const SaveSummary sum = get_summary(sf, 0);
+    printf("\n%.*s : \n", get_summary_name_len(&sum), get_summary_name(&sum));
+    print_save_details(&sum);
 
     printf("launch this game? (y/n) : ");
     printf("\n> ");
@@ -273,12 +315,7 @@ void saved_games() {
     } while (key != 'y' && key != 'n');
 
     if (key == 'y') {
-      const char *game_board = build_board(get_board(&gs), DEFAULT_COLS,
-                                           DEFAULT_SQUARE_LEN, BORDERS);
-
-      wait_keypress("press to launch the game");
-      game_loop(&pls, &board, game_board);
-
+      index = 0;
     } else {
       wait_keypress("press to go back to the menu");
     }
@@ -286,22 +323,42 @@ void saved_games() {
   } else {
     new_screen();
     printf("Many games found. ");
-    int index = choose_save(gss);
+    index = choose_save(sf);
 
     if (index == QUIT_GAME) {
       wait_keypress("press to go back to the menu");
+    }
+  }
+
+  // only the chosen game is read in full, then the file is closed so that the
+  // game can be saved again while it is played
+  GameState gs;
+  if (index != QUIT_GAME) {
+    logger.log("loading save %i", index);
+    SaveRecord rec;
+    if (get_record(sf, index, &rec)) {
+      decode_record(&rec, &gs);
     } else {
+      print_err(CORRUPTED_SAVES_ERROR);
+      printf("\n");
+      wait_keypress("press to go back to the menu");
+      index = QUIT_GAME;
+    }
+  }
+  close_save_file(sf);
 
-      GameState gs = *get_gamestate(&gss, index);
-      Players pls = get_players(&gs);
-      Board board = get_board(&gs);
+  if (index != QUIT_GAME) {
+    pending_save = touch_save(SAVED_GAMES_FILE, index);
+  }
 
-      const char *game_board = build_board(get_board(&gs), DEFAULT_COLS,
-                                           DEFAULT_SQUARE_LEN, BORDERS);
+  if (index != QUIT_GAME) {
+    Players pls = get_players(&gs);
+    // only the dimension of the board is saved
+    const Board saved = get_board(&gs);
+    Board board = *get_cached_board(get_dim(&saved));
 
-      wait_keypress("press to launch the game");
-      game_loop(&pls, &board, game_board);
-    }
+    wait_keypress("press to launch the game");
+    game_loop(&pls, &board, get_cached_render(get_dim(&board)), 0);
   }
 
   logger.exit_fn();
@@ -0,0 +1,265 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+#include <stdlib.h>
+
+#include "../inc/globals.h"
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/gamestate.h"
+#include "../common/inc/types/player.h"
+#include "../common/inc/types/players.h"
+
+#include "../common/inc/error.h"
+#include "../common/inc/iopool.h"
+#include "../common/inc/journal.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/nameindex.h"
+#include "../common/inc/playerstats.h"
+
+#include "../inc/handle_game.h"
+#include "../inc/handle_history.h"
+
+#include "../inc/handle_stats.h"
+#include "../inc/private/handle_stats.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The statistics, or @c NULL if they have not been read.
+ */
+static PlayerStats *stats = NULL;
+
+/**
+ * @brief The journal of the statistics, with every record read, to append
+ *        the statistics of the next games to.
+ */
+static Journal *journal = NULL;
+
+/**
+ * @brief The last write of the statistics, or @c NULL if there is none.
+ */
+static IoRequest *pending = NULL;
+
+/**
+ * @brief Reads the statistics from their journal.
+ *
+ * @return The number of records read.
+ */
+static int read_stats(void) {
+  logger.enter_fn(__func__);
+
+  stats = new_player_stats();
+  journal = open_journal(STATS_FILE);
+  int num_skipped = 0;
+  JournalRecord rec;
+  while (next_journal_record(journal, &rec)) {
+    if (!decode_player_stats(rec.data, rec.size, stats)) {
+      num_skipped = num_skipped + 1;
+    }
+  }
+  release_journal(journal);
+  logger.log("read %i players from %i records, skipped %i",
+             stats->num_players, journal->num_records, num_skipped);
+
+  logger.exit_fn();
+  return journal->num_records;
+}
+
+/**
+ * @brief Replaces the journal of the statistics with a snapshot of every
+ *        player.
+ */
+static void save_stats(void) {
+  logger.enter_fn(__func__);
+
+  const int num_players = stats->num_players;
+  const int num_records =
+      (num_players + STATS_RECORD_MAX_PLAYERS - 1) / STATS_RECORD_MAX_PLAYERS;
+  int *slots = (int *)malloc((num_players + 1) * sizeof(int));  // NOLINT
+  unsigned char *data = (unsigned char *)malloc(  // NOLINT
+      num_players * STATS_ENTRY_SIZE + 1);
+  JournalRecord *recs = (JournalRecord *)malloc(  // NOLINT
+      (num_records + 1) * sizeof(JournalRecord));
+  if (!slots || !data || !recs) {
+    logger.stop();
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < num_players) {
+    slots[i] = i;
+    i = i + 1;
+  }
+  unsigned char *cursor = data;
+  i = 0;
+  while (i < num_records) {
+    const int first = i * STATS_RECORD_MAX_PLAYERS;
+    int count = num_players - first;
+    if (count > STATS_RECORD_MAX_PLAYERS) {
+      count = STATS_RECORD_MAX_PLAYERS;
+    }
+    recs[i].data = cursor;
+    cursor = encode_player_stats(cursor, stats, &slots[first], count);
+    recs[i].size = cursor - recs[i].data;
+    i = i + 1;
+  }
+  finish_io(pending);
+  pending = write_journal(STATS_FILE, journal, recs, num_records);
+  free(slots);
+  free(data);
+  free(recs);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Compacts the journal of the statistics on a thread of the I/O pool
+ *        (see @c IoRewrite).
+ */
+static unsigned char *compact_stats(const unsigned char content[],
+                                    const int size, int *new_size) {
+  return compact_keyed_journal(content, size, STATS_ENTRY_SIZE,
+                               STATS_RECORD_MAX_PLAYERS,
+                               are_player_stats_valid, new_size);
+}
+
+/**
+ * @brief Computes every statistic by replaying the history of the games, then
+ *        writes them.
+ */
+static void count_history(void) {
+  logger.enter_fn(__func__);
+
+  free_player_stats(stats);
+  stats = new_player_stats();
+  int num_games = 0;
+  Journal *j = open_journal(HISTORY_FILE);
+  JournalRecord rec;
+  while (next_journal_record(j, &rec)) {
+    // the moves are counted as the engine replays them
+    GameTally t;
+    clear_game_tally(&t);
+    GameState gs;
+    if (!replay_game(rec.data, rec.size, &gs, &t)) {
+      continue;
+    }
+    Players pls = get_players(&gs);
+    Board board = get_board(&gs);
+    finish_game_tally(&t, &pls, &board);
+    int slots[MAX_NUM_PLAYERS];
+    add_game_tally(stats, &t, slots);
+    num_games = num_games + 1;
+  }
+  close_journal(j);
+  save_stats();
+  logger.log("counted %i players from %i games", stats->num_players,
+             num_games);
+
+  logger.exit_fn();
+}
+
+/**
+ * @brief Reads the statistics, unless they are already read.
+ *
+ * Without any statistic, the statistics are computed from the history, which
+ * holds the games played before the statistics were kept.
+ */
+static void load_stats(void) {
+  if (stats) {
+    return;
+  }
+  logger.enter_fn(__func__);
+
+  if (read_stats() == 0) {
+    count_history();
+  }
+
+  logger.exit_fn();
+}
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+void finish_game_tally(GameTally *t, Players *pls, Board *board) {
+  const int winner_idx = find_winner(pls, board);
+  int i = 0;
+  while (i < get_players_num(pls)) {
+    const Player *pl = get_player(pls, i);
+    StatsRow *row = tally_player(t, pack_name(get_username(pl)));
+    row->games = 1;
+    row->wins = i == winner_idx;
+    i = i + 1;
+  }
+}
+
+void record_game_stats(GameTally *t, Players *pls, Board *board) {
+  logger.enter_fn(__func__);
+
+  load_stats();
+  finish_game_tally(t, pls, board);
+  int slots[MAX_NUM_PLAYERS];
+  add_game_tally(stats, t, slots);
+
+  unsigned char data[MAX_NUM_PLAYERS * STATS_ENTRY_SIZE];
+  const unsigned char *end =
+      encode_player_stats(data, stats, slots, t->num_players);
+  finish_io(pending);
+  // the pool compacts the journal right after the append, so that the game
+  // does not wait for a snapshot of every player
+  if (journal->num_records >= STATS_COMPACT_RATIO * stats->num_players) {
+    pending = append_compact_journal(STATS_FILE, journal, data, end - data,
+                                     compact_stats);
+  } else {
+    pending = append_journal(STATS_FILE, journal, data, end - data);
+  }
+  logger.log("counted game of %i players", t->num_players);
+
+  logger.exit_fn();
+}
+
+int get_player_stats(const char name[], StatsRow *row) {
+  load_stats();
+  return get_stats_row(stats, pack_name(name), row);
+}
+
+double get_average_turns(void) {
+  load_stats();
+  const long long games = sum_stats_column(stats->games, stats->num_players);
+  if (games == 0) {
+    return 0;
+  }
+  return (double)sum_stats_column(stats->turns, stats->num_players) / games;
+}
+
+void rebuild_stats(void) {
+  logger.enter_fn(__func__);
+  logger.log("rebuilding statistics from the history");
+
+  if (!stats) {
+    read_stats();
+  }
+  count_history();
+
+  logger.exit_fn();
+}
+
+void unload_stats(void) {
+  logger.enter_fn(__func__);
+
+  finish_io(pending);
+  pending = NULL;
+  free_player_stats(stats);
+  stats = NULL;
+  if (journal) {
+    close_journal(journal);
+    journal = NULL;
+  }
+
+  logger.exit_fn();
+}
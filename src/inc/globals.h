@@ -91,4 +91,29 @@
  */
 #define LEADERBOARD_FILE "../res/data/leaderboard.bin"
 
+/**
+ * @brief Path to the best scores of the last days binary file.
+ */
+#define WINDOWS_FILE "../res/data/windows.bin"
+
+/**
+ * @brief Path to the autosave binary file.
+ */
+#define AUTOSAVE_FILE "../res/data/autosave.bin"
+
+/**
+ * @brief Path to the history of the finished games binary file.
+ */
+#define HISTORY_FILE "../res/data/history.bin"
+
+/**
+ * @brief Path to the ratings of the players binary file.
+ */
+#define RATINGS_FILE "../res/data/ratings.bin"
+
+/**
+ * @brief Path to the statistics of the players binary file.
+ */
+#define STATS_FILE "../res/data/stats.bin"
+
 #endif  // GLOBALS_H
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file handle_autosave.h
+ * @brief This file contains functions related to the autosave module.
+ *
+ * The autosave module records the game being played after every turn, so that
+ * it can be resumed if the program ends without the game being saved, e.g.
+ * when the terminal is closed.
+ *
+ * The `start_autosave()` function is called when the game loop starts, the
+ * `autosave_turn()` function after every turn and the `stop_autosave()`
+ * function when the game ends or the players leave it. The records are written
+ * by a background thread, so the game loop never waits on the disk.
+ *
+ * The `resume_autosave()` function is called when the program starts and asks
+ * to resume the interrupted game, if any.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 19:05
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef AUTOSAVE_MODULE_H
+#define AUTOSAVE_MODULE_H
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Starts recording a game.
+ *
+ * A keyframe with the whole game is written first, replacing any previous
+ * autosave.
+ *
+ * @param[in] pls   The players in the game.
+ * @param[in] board The game board.
+ * @param[in] turn  The number of turns already played.
+ *
+ * @return void.
+ */
+void start_autosave(Players *pls, Board *board, const int turn);
+
+/**
+ * @brief Records the game after a turn.
+ *
+ * Every @c AUTOSAVE_KEYFRAME_TURNS turns the whole game is written as a new
+ * keyframe, otherwise only the players that changed since the last keyframe
+ * are written.
+ *
+ * @param[in] pls   The players in the game.
+ * @param[in] board The game board.
+ * @param[in] turn  The number of turns played so far.
+ *
+ * @return void.
+ */
+void autosave_turn(Players *pls, Board *board, const int turn);
+
+/**
+ * @brief Stops recording a game and discards its autosave.
+ *
+ * It is called when the game ends normally, so that only interrupted games are
+ * resumed.
+ *
+ * @return void.
+ */
+void stop_autosave(void);
+
+/**
+ * @brief Asks to resume a game that was interrupted, if any.
+ *
+ * The game is rebuilt from the last keyframe and the last delta after it, and
+ * played from the turn it was interrupted at. If the players do not want to
+ * resume it, the autosave is discarded.
+ *
+ * @return void.
+ */
+void resume_autosave(void);
+
+#endif  // !AUTOSAVE_MODULE_H
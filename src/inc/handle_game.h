@@ -38,48 +38,222 @@
 #ifndef GAME_MODULE_H
 #define GAME_MODULE_H
 
+#include "../common/inc/playerstats.h"
+#include "../common/inc/theme.h"
 #include "../common/inc/types/board.h"
 #include "../common/inc/types/players.h"
 
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
+/**
+ * @brief A struct representing the visual representation of a game board.
+ *
+ * Besides the printed board, this struct keeps where the label of each square
+ * has been written, so that the squares can be updated in place (e.g. to draw
+ * the players on them) without building the board again.
+ *
+ * @var BoardRender::text
+ * The printed board, null-terminated.
+ *
+ * @var BoardRender::size
+ * The size in bytes of @c text, without the null-terminator.
+ *
+ * @var BoardRender::square_len
+ * The length of each square.
+ *
+ * @var BoardRender::label_offsets
+ * The offset in bytes of the label of each square inside @c text.
+ */
+typedef struct BoardRender {
+  char *text;                          ///< The printed board.
+  int size;                            ///< The size in bytes of the text.
+  int square_len;                      ///< The length of each square.
+  int label_offsets[MAX_NUM_SQUARES];  ///< The offset of each square label.
+} BoardRender;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
 /**
  * @brief Builds the visual representation of the game board.
  *
  * This function builds the visual representation of the game board using the
- * provided board dimensions, square length, and border characters. It
- * constructs the board by building the borders and squares row by row. The
- * resulting visual representation of the game board is returned as a string.
+ * provided board dimensions, square length, and border theme. The shape
+ * of a full row is computed once, then each row is built by copying it and
+ * writing the labels of its squares at fixed offsets. The resulting visual
+ * representation of the game board is returned along with the offset of each
+ * label.
  *
  * @param[in] board      The Board struct representing the game board.
  * @param[in] cols       The number of columns in the game board.
  * @param[in] square_len The length of each square.
- * @param[in] borders    The array of border characters for different segments
- * of the border.
+ * @param[in] theme      The theme holding the border characters for different
+ *                       segments of the border.
+ *
+ * @return A pointer to the visual representation of the game board. It should
+ *         be freed with @c free_render().
+ */
+BoardRender *build_board(const Board board, const int cols,
+                         const int square_len, const BorderTheme *theme);
+
+/**
+ * @brief Frees a visual representation created with @c build_board().
+ *
+ * @param[in,out] render The visual representation to free.
+ *
+ * @return void.
+ */
+void free_render(BoardRender *render);
+
+/**
+ * @brief Gets the board of the given dimension from the cache.
+ *
+ * The layout of a board only depends on its dimension, so every board is
+ * created once, the first time it is requested, and then kept for the whole
+ * run of the program.
+ *
+ * @param[in] board_dim The dimension of the board, in
+ *                      [@c MIN_NUM_SQUARES, @c MAX_NUM_SQUARES].
+ *
+ * @return A pointer to the cached board. It must not be freed nor modified,
+ *         copy it if needed.
+ *
+ * @throws VALUE_OUT_OF_BOUND_ERROR If the dimension is not supported.
+ */
+const Board *get_cached_board(const int board_dim);
+
+/**
+ * @brief Gets the visual representation of the board of the given dimension
+ *        from the cache.
+ *
+ * The visual representation is built with the default columns and square
+ * length and with the chosen theme (see @c set_board_theme()), together with
+ * the board itself (see @c get_cached_board()).
+ *
+ * @param[in] board_dim The dimension of the board, in
+ *                      [@c MIN_NUM_SQUARES, @c MAX_NUM_SQUARES].
  *
- * @return The visual representation of the game board as a string.
+ * @return A pointer to the cached visual representation. It must not be freed
+ *         nor modified.
+ *
+ * @throws VALUE_OUT_OF_BOUND_ERROR If the dimension is not supported.
  */
-char *build_board(const Board board, const int cols, const int square_len,
-                  const char *borders[8]);
+const BoardRender *get_cached_render(const int board_dim);
+
+/**
+ * @brief Gets the theme the boards are printed with.
+ *
+ * @return The chosen theme, @c DEFAULT_THEME until another one is chosen.
+ */
+const BorderTheme *get_board_theme(void);
+
+/**
+ * @brief Chooses the theme the boards are printed with.
+ *
+ * The boards already in the cache are printed again with the new theme, so
+ * any visual representation given before by @c get_cached_render() must not
+ * be used anymore: the theme is only changed outside of a game.
+ *
+ * @param[in] theme The theme, from the registry of theme.h.
+ *
+ * @return void.
+ */
+void set_board_theme(const BorderTheme *theme);
 
 /**
  * @brief Runs the main game loop.
  *
  * This function runs the main game loop where players take turns rolling the
- * dice and moving on the game board. The function displays the game board and
- * player positions, and prompts the current player to roll the dice or pause
+ * dice and moving on the game board. The function displays the game board, with
+ * the initial of each player drawn inside their square, and the player
+ * positions, and prompts the current player to roll the dice or pause
  * the game. After each player's turn, the function checks for a winner. If a
  * winner is found, the game loop ends and the winner is displayed. If the game
- * is paused, the function returns to the main menu.
+ * is left from the pause menu, the function returns to the main menu,
+ * otherwise the same player is prompted again, since only rolls count as
+ * turns.
+ *
+ * The game is autosaved after every turn (see handle_autosave.h), and the
+ * autosave is discarded when the loop returns. The dice are restarted from a
+ * new seed, so that a game played from its start is archived as its seed and
+ * its number of turns when it is won (see handle_history.h), then rated and
+ * counted in the statistics. A resumed game was played with dice of another
+ * seed before it was saved, so it can not be replayed: when it is won, only
+ * the leaderboard is updated.
+ *
+ * @param[in] pls    The players in the game.
+ * @param[in] board  The game board.
+ * @param[in] render The visual representation of the game board.
+ * @param[in] turn   The number of turns already played, so that a resumed game
+ *                   continues with the right player.
+ *
+ * @return void.
+ */
+void game_loop(Players *pls, Board *board, const BoardRender *render,
+               const int turn);
+
+/**
+ * @brief Plays turns without any input or output.
+ *
+ * The dice are restarted from the given seed and rolled for each player in
+ * turn, as the game loop does, so that playing the same turns from the start
+ * of a game rebuilds it exactly.
+ *
+ * The moves replayed are counted in the given tally only, so a game being
+ * played when a game of the history is replayed keeps its own tally intact.
+ *
+ * @param[in,out] pls   The players in the game.
+ * @param[in,out] board The game board.
+ * @param[in]     seed  The seed of the dice.
+ * @param[in]     turns The number of turns to play.
+ * @param[in,out] t     The tally the moves are counted in (see
+ *                      playerstats.h), or @c NULL not to count them.
+ *
+ * @return void.
+ */
+void replay_turns(Players *pls, Board *board, const unsigned long long seed,
+                  const int turns, GameTally *t);
+
+/**
+ * @brief Sets the tally the moves of the next turns played are counted in
+ *        (see playerstats.h). Replayed turns are counted in the tally given to
+ *        @c replay_turns() instead.
+ *
+ * @param[in,out] t The tally, or @c NULL to stop counting the moves.
+ *
+ * @return void.
+ */
+void set_game_tally(GameTally *t);
+
+/**
+ * @brief Finds the winner of the game.
+ *
+ * This function searches for the winner of the game by checking if any player
+ * has reached or surpassed the board dimensions. It iterates through all the
+ * players and checks their positions. If a player is found to have reached or
+ * surpassed the board dimensions, the index of the player is returned;
+ * otherwise, INDEX_NOT_FOUND is returned.
+ *
+ * @param[in] pls   The Players struct containing all the players.
+ * @param[in] board The Board struct representing the game board.
+ *
+ * @return The index of the winner, or INDEX_NOT_FOUND if no winner is found.
+ */
+int find_winner(Players *pls, Board *board);
+
+/**
+ * @brief Modifies the provided username to conform to certain rules.
+ *
+ * This function modifies the provided username by truncating it to a maximum
+ * length, converting it to uppercase, and adding a filler character if the
+ * length is less than the maximum allowed length.
  *
- * @param[in] pls        The players in the game.
- * @param[in] board      The game board.
- * @param[in] game_board The string representation of the game board.
+ * @param[in,out] username The username to be conformed.
  *
  * @return void.
  */
-void game_loop(Players *pls, Board *board, const char game_board[]);
+void conform_username(char username[]);
 
 /**
  * @brief Starts a new game.
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file handle_history.h
+ * @brief This file contains functions related to the history module.
+ *
+ * The history module archives every finished game in a few dozen bytes. The
+ * dice of a game only depend on the seed it started with (see
+ * `replay_turns()`), so a game played from its start is fully described by the
+ * dimension of its board, the usernames of its players in turn order, the seed
+ * of its dice and the number of turns played.
+ *
+ * The `archive_game()` function is called by the game loop when a game is won,
+ * and the `replay_game()` function rebuilds an archived game by playing its
+ * turns again.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 22:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef HISTORY_MODULE_H
+#define HISTORY_MODULE_H
+
+#include "../common/inc/playerstats.h"
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/gamestate.h"
+#include "../common/inc/types/players.h"
+
+#include "../common/inc/iopool.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Appends a finished game to the history.
+ *
+ * @param[in] pls   The players in the game, in turn order.
+ * @param[in] board The game board.
+ * @param[in] seed  The seed the dice of the game started from.
+ * @param[in] turns The number of turns played.
+ *
+ * @return The handle of the write, queued to the I/O pool (see iopool.h).
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the history can not be read.
+ */
+IoRequest *archive_game(Players *pls, Board *board,
+                        const unsigned long long seed, const int turns);
+
+/**
+ * @brief Rebuilds an archived game by playing its turns again.
+ *
+ * @param[in]     data The bytes of the record of the game in the history.
+ * @param[in]     size The size in bytes of the record.
+ * @param[out]    gs   The game, as it was when it ended.
+ * @param[in,out] t    The tally the moves of the game are counted in (see
+ *                     playerstats.h), or @c NULL not to count them.
+ *
+ * @return @c TRUE if the game has been rebuilt, @c FALSE if the record is
+ *         malformed.
+ */
+int replay_game(const unsigned char data[], const int size, GameState *gs,
+                GameTally *t);
+
+#endif  // !HISTORY_MODULE_H
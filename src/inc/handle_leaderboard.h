@@ -14,31 +14,97 @@
 // -------------------------------------------------------------------------- //
 
 /**
- * @brief Writes a leaderboard entry to the file.
+ * @brief Queues a leaderboard entry to be written to the file.
  *
- * This function writes the provided entry to the leaderboard file. If the
- * leaderboard file is already full (MAX_ENTRIES), it checks if the last entry
- * has a higher score than the provided entry. If it does, the entry is not
- * written. If the leaderboard file has space for additional entries, the entry
- * is appended to the end. If a duplicate entry is found, it is overwritten with
- * the provided entry. After writing, the leaderboard is sorted, and any
- * duplicate entries are removed.
+ * The leaderboard holds one entry per player, with their best score, and has
+ * no limit on the number of players. If the player is already in the
+ * leaderboard, their entry is only updated when the given score is higher.
+ *
+ * Entries are written in batches: the queued entries are merged into the
+ * leaderboard all at once, and only the pages of the file holding them are
+ * written again, with a single write queued to the I/O pool (see ranktree.h).
+ * An entry coming after a quiet interval is merged right away, while entries
+ * coming within @c LEADERBOARD_BATCH_INTERVAL of the last batch wait for
+ * @c poll_leaderboard() to merge them together once the interval is over. A
+ * player finishing several games in the meantime is merged once. The best
+ * scores of the current day are updated right away, and written with the
+ * batch.
+ *
+ * The caller does not wait for the disk. To know that the entry is on disk,
+ * call @c sync_leaderboard().
  *
  * @param[in] e The Entry to write to the leaderboard file.
  *
  * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the previous batch could not be written.
  */
 void write_leaderboard(Entry e);
 
+/**
+ * @brief Merges the queued entries if the batch interval is over, without
+ *        waiting for the disk.
+ *
+ * This is called once per turn, so that the handle of a written batch is
+ * released and a batch that could not be written is reported.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the last batch could not be written.
+ */
+void poll_leaderboard(void);
+
+/**
+ * @brief Merges the queued entries right away and waits for them to be on
+ *        disk.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the leaderboard could not be written.
+ */
+void sync_leaderboard(void);
+
+/**
+ * @brief Rebuilds the leaderboard from the history of the games.
+ *
+ * Every archived game is replayed (see handle_history.h), and its winner is
+ * added to an external sort (see extsort.h), which takes at most
+ * @c LEADERBOARD_REBUILD_BUDGET bytes whatever the length of the history. The
+ * sorted runs are then merged with the leaderboard itself, so that a player
+ * keeps their best score among both, and the result replaces the leaderboard
+ * file. Only the leaderboard written at the end takes memory in proportion to
+ * its number of players.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If a sorted run can not be written.
+ */
+void rebuild_leaderboard(void);
+
 /**
  * @brief Displays the leaderboard view.
  *
- * This function reads the leaderboard data, displays the leaderboard using
+ * This function shows the leaderboard a page at a time using
  * display_leaderboard, and waits for a back key (b/ESC/ENTER/SPACEBAR) to be
- * pressed before returning.
+ * pressed before returning. Only the entries of the page shown are read, so
+ * scrolling takes the same time however many players there are. From this
+ * view a player can be found, the best scores of today or of the last week can
+ * be shown instead, and the leaderboard can be rebuilt from the history of the
+ * games.
  *
  * @return void.
  */
 void leaderboard(void);
 
+/**
+ * @brief Writes the queued entries, then closes the leaderboard file and
+ *        frees its pages kept in memory.
+ *
+ * The next call to the functions of this module opens the leaderboard file
+ * again.
+ *
+ * @return void.
+ */
+void unload_leaderboard(void);
+
 #endif  // !LEADERBOARD_MODULE_H
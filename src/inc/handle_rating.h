@@ -0,0 +1,87 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file handle_rating.h
+ * @brief This file contains functions related to the rating module.
+ *
+ * Every player has an Elo rating (see rating.h), updated after each game from
+ * the order in which its players finished it: the winner first, then the
+ * others from the one closest to the last square.
+ *
+ * Only the games archived in the history (see handle_history.h) are rated, so
+ * that the ratings can always be computed again from the history. A game is
+ * archived only if it is played from its start to its end in one go: a game
+ * resumed from a save or from the autosave can not be replayed from its seed,
+ * so it is neither archived nor rated.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 09:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RATING_MODULE_H
+#define RATING_MODULE_H
+
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Rates a finished game and writes the new ratings of its players.
+ *
+ * This is called before the game is archived: ratings read for the first
+ * time are computed from the history, which must not hold the game yet.
+ *
+ * @param[in]  pls     The players in the game.
+ * @param[in]  board   The game board.
+ * @param[out] changes The change of rating of each player, in hundredths of a
+ *                     point, in the order of @e pls.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the ratings can not be read.
+ */
+void rate_players(Players *pls, Board *board, int changes[]);
+
+/**
+ * @brief Gets the rating of a player.
+ *
+ * @param[in] name The name of the player.
+ *
+ * @return The rating in hundredths of a point, the initial one if the player
+ *         has never been rated.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the ratings can not be read.
+ */
+int get_player_rating(const char name[]);
+
+/**
+ * @brief Computes every rating again from the history of the games.
+ *
+ * The games are replayed one after the other, which is most of the work, then
+ * rated in batch (see @c rate_games()).
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the history can not be read.
+ */
+void rebuild_ratings(void);
+
+/**
+ * @brief Waits for the ratings to be written, then frees them.
+ *
+ * The next call to the functions of this module reads the ratings again.
+ *
+ * @return void.
+ */
+void unload_ratings(void);
+
+#endif  // !RATING_MODULE_H
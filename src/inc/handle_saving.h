@@ -71,4 +71,27 @@ void save_game(Players *pls, Board *board);
  */
 void saved_games();
 
+/**
+ * @brief Checks whether the last save has been written, without waiting for
+ *        it.
+ *
+ * Saves are written by the I/O pool (see iopool.h) while the game goes on.
+ * This is called once per turn, so that the handle of a written save is
+ * released and a save that could not be written is reported.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the save file could not be written.
+ */
+void poll_saving(void);
+
+/**
+ * @brief Waits for the last save to be written.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_WRITABLE_ERROR If the save file could not be written.
+ */
+void finish_saving(void);
+
 #endif  // !SAVING_MODULE_H
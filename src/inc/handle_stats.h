@@ -0,0 +1,97 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file handle_stats.h
+ * @brief This file contains functions related to the statistics module.
+ *
+ * The game engine counts the turns of each player and their landings on the
+ * special squares in a tally (see playerstats.h) while a game is played, and
+ * the tally is added to the statistics of the players when the game is won.
+ *
+ * Only the games archived in the history (see handle_history.h) are counted,
+ * so that the statistics can always be computed again by replaying the
+ * history. A game resumed from a save or from the autosave is not archived
+ * (see @c game_loop()), so it is not counted either.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 11:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef STATS_MODULE_H
+#define STATS_MODULE_H
+
+#include "../common/inc/playerstats.h"
+#include "../common/inc/types/board.h"
+#include "../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Adds the tally of a won game to the statistics and writes the
+ *        statistics of its players.
+ *
+ * This is called before the game is archived: statistics read for the first
+ * time are computed from the history, which must not hold the game yet.
+ *
+ * @param[in,out] t     The tally of the moves of the game, to which the
+ *                      games played and won are added.
+ * @param[in]     pls   The players in the game.
+ * @param[in]     board The game board.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the statistics can not be read.
+ */
+void record_game_stats(GameTally *t, Players *pls, Board *board);
+
+/**
+ * @brief Gets the statistics of a player.
+ *
+ * @param[in]  name The name of the player.
+ * @param[out] row  The statistics of the player, if found.
+ *
+ * @return @c TRUE if the player has played a counted game, @c FALSE
+ *         otherwise.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the statistics can not be read.
+ */
+int get_player_stats(const char name[], StatsRow *row);
+
+/**
+ * @brief Computes the number of turns a player plays in a game, on average
+ *        over every game of every player.
+ *
+ * @return The average number of turns, 0 if no game has been counted.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the statistics can not be read.
+ */
+double get_average_turns(void);
+
+/**
+ * @brief Computes every statistic again by replaying the history of the
+ *        games.
+ *
+ * @return void.
+ *
+ * @throws FILE_NOT_READABLE_ERROR If the history can not be read.
+ */
+void rebuild_stats(void);
+
+/**
+ * @brief Waits for the statistics to be written, then frees them.
+ *
+ * The next call to the functions of this module reads the statistics again.
+ *
+ * @return void.
+ */
+void unload_stats(void);
+
+#endif  // !STATS_MODULE_H
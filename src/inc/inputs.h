@@ -96,6 +96,29 @@
  */
 #define FINAL_ORDER_MSG "Based on the dice rolls, the turn order is:\n"
 
-#define LEADERBOARD_BANNER "RANK USERNAME SCORE\n"
+#define LEADERBOARD_BANNER "    RANK  USERNAME  SCORE"
+
+/**
+ * @brief Format string for printing a row of the leaderboard, below the
+ *        columns of @c LEADERBOARD_BANNER.
+ *
+ * Use with printf-like functions: printf(LEADERBOARD_ROW_FMT, rank, username,
+ * score);
+ */
+#define LEADERBOARD_ROW_FMT "%8d  %8s  %5d"
+
+/**
+ * @brief Header of the ratings printed at the end of a game.
+ */
+#define RATINGS_BANNER "NAME\tRATING"
+
+/**
+ * @brief Format string for printing the rating of a player at the end of a
+ *        game, below @c RATINGS_BANNER.
+ *
+ * Use with printf-like functions: printf(RATING_ROW_FMT, username, rating,
+ * change); The rating and its change are in points.
+ */
+#define RATING_ROW_FMT "%s\t%.0f (%+.2f)\n"
 
 #endif  // !INPUT_FORMATS_H
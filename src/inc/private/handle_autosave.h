@@ -0,0 +1,129 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file private/handle_autosave.h
+ * @brief This file contains private functions and declarations related to the
+ *        autosave module.
+ *
+ * The autosave is a journal (see journal.h) with two kinds of records, each
+ * starting with its kind and the number of turns played:
+ *
+ * @code
+ * keyframe  kind 'K' | turn u32 | record of the game (see savefile.h)
+ * delta     kind 'D' | turn u32 | changed u8
+ *           | changed x { player u8 | player state (see codec.h) }
+ * @endcode
+ *
+ * A delta holds every player that changed since the last keyframe, not since
+ * the last delta, so the game is rebuilt from the last keyframe and the last
+ * delta alone, and a delta not yet written can be replaced by a newer one.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 19:05
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef AUTOSAVE_MODULE_PRIVATE_H
+#define AUTOSAVE_MODULE_PRIVATE_H
+
+#include "../../common/inc/bytes.h"
+#include "../../common/inc/journal.h"
+#include "../../common/inc/types/gamestate.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of turns between two keyframes.
+ */
+#define AUTOSAVE_KEYFRAME_TURNS 16
+
+/**
+ * @brief The kind of a record holding the whole game.
+ */
+#define AUTOSAVE_KEYFRAME 'K'
+
+/**
+ * @brief The kind of a record holding the players changed since the last
+ *        keyframe.
+ */
+#define AUTOSAVE_DELTA 'D'
+
+/**
+ * @brief The size in bytes of the kind and the turn at the start of a record.
+ */
+#define AUTOSAVE_RECORD_HEADER_SIZE 5
+
+/**
+ * @brief The maximum size in bytes of a player inside a delta.
+ */
+#define AUTOSAVE_DELTA_PLAYER_MAX_SIZE (1 + 2 * VARINT_MAX_SIZE + 1)
+
+/**
+ * @brief The name given to an autosaved game.
+ */
+#define AUTOSAVE_GAME_NAME "autosave"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Queues a keyframe with the whole game to be written.
+ *
+ * The players are kept as the reference of the following deltas.
+ *
+ * @param[in] pls      The players in the game.
+ * @param[in] board    The game board.
+ * @param[in] turn     The number of turns played so far.
+ * @param[in] is_first Whether it is the first record of the autosave, to write
+ *                     along with the header of the journal.
+ *
+ * @return void.
+ */
+void queue_keyframe(Players *pls, Board *board, const int turn,
+                    const int is_first);
+
+/**
+ * @brief Queues a delta with the players changed since the last keyframe.
+ *
+ * @param[in] pls  The players in the game.
+ * @param[in] turn The number of turns played so far.
+ *
+ * @return void.
+ */
+void queue_delta(Players *pls, const int turn);
+
+/**
+ * @brief Applies a delta to the players of a game.
+ *
+ * @param[in]     rec The delta.
+ * @param[in,out] gs  The game, as rebuilt from the last keyframe.
+ *
+ * @return @c TRUE if the delta has been applied, @c FALSE if it is malformed.
+ */
+int apply_delta(const JournalRecord *rec, GameState *gs);
+
+/**
+ * @brief Rebuilds the interrupted game from the autosave.
+ *
+ * @param[out] gs   The game.
+ * @param[out] turn The number of turns played.
+ *
+ * @return @c TRUE if an interrupted game has been found, @c FALSE otherwise.
+ */
+int load_autosave(GameState *gs, int *turn);
+
+/**
+ * @brief Discards the autosave, leaving an empty file.
+ *
+ * @return void.
+ */
+void discard_autosave(void);
+
+#endif  // !AUTOSAVE_MODULE_PRIVATE_H
@@ -37,9 +37,87 @@
 #ifndef GAME_MODULE_PRIVATE_H
 #define GAME_MODULE_PRIVATE_H
 
+#include "../../common/inc/theme.h"
 #include "../../common/inc/types/board.h"
 #include "../../common/inc/types/players.h"
 
+#include "../handle_game.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of characters used to print the label of a square.
+ */
+#define SQUARE_LABEL_LEN 2
+
+/**
+ * @brief The lowest value a square can have (a special square).
+ */
+#define MIN_SQUARE_VALUE SKELETON_VALUE
+
+/**
+ * @brief The number of labels needed to print any square: one for each special
+ *        value and one for each numbered square.
+ */
+#define NUM_SQUARE_LABELS (MAX_NUM_SQUARES - MIN_SQUARE_VALUE + 1)
+
+/**
+ * @brief The number of supported board dimensions, i.e. of cached boards.
+ */
+#define NUM_BOARD_DIMS (MAX_NUM_SQUARES - MIN_NUM_SQUARES + 1)
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct holding the precomputed pieces used to print a board.
+ *
+ * For a given number of columns, square length and theme, the rows of the
+ * printed board always have the same shape: only the labels of the squares
+ * change. This struct caches a single square with a blank label and the three
+ * lines that make up a full row of the board, so that each row can be built by
+ * copying them and writing the labels at fixed offsets. All the sizes are
+ * computed from the metrics cached in the theme.
+ */
+typedef struct BoardTemplate {
+  const BorderTheme *theme;  ///< The theme used to print the board.
+  int cols;                  ///< The number of columns of the board.
+  int blank_size;    ///< The size in bytes of a missing square (spaces).
+  char *dashes;      ///< The dashes drawn above and below a square.
+  int dashes_size;   ///< The size in bytes of @c dashes.
+  char *cell;        ///< A square with a blank label, without closing border.
+  int cell_size;     ///< The size in bytes of @c cell.
+  int label_offset;  ///< The offset in bytes of the label inside @c cell.
+  char *top_row;      ///< The top border of a full row.
+  int top_size;       ///< The size in bytes of @c top_row.
+  char *squares_row;  ///< The squares of a full row, with blank labels.
+  int squares_size;   ///< The size in bytes of @c squares_row.
+  char *bot_row;      ///< The bottom border of a full row.
+  int bot_size;       ///< The size in bytes of @c bot_row.
+} BoardTemplate;
+
+/**
+ * @brief A struct holding the players drawn on top of a printed board.
+ *
+ * Each player owns a slot inside every square, in the spaces around the label,
+ * where their initial is drawn when they stand on that square. The layer keeps
+ * which players stand on each square, so that when a player moves only the
+ * squares they leave and reach have to be drawn again.
+ */
+typedef struct TokenLayer {
+  char *game_board;  ///< A copy of the printed board the tokens are drawn on.
+  const BoardRender *render;  ///< The printed board the layer is built on.
+  int dim;                    ///< The dimension of the board.
+  int num_slots;  ///< The number of players that can be drawn in a square.
+  int slot_offsets[MAX_NUM_PLAYERS];  ///< The offset of each slot from the
+                                      ///< label of a square.
+  char initials[MAX_NUM_PLAYERS];     ///< The character each player is
+                                      ///< drawn with, unique in the game.
+  int occupancy[MAX_NUM_SQUARES];     ///< For each square, a bitmask of the
+                                      ///< players standing on it.
+} TokenLayer;
+
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
@@ -59,19 +137,6 @@
  */
 int ask_num_in_range(const int min, const int max, const char name[]);
 
-/**
- * @brief Modifies the provided username to conform to certain rules.
- *
- * This function modifies the provided username by truncating it to a maximum
- * length, converting it to uppercase, and adding a filler character if the
- * length is less than the maximum allowed length.
- *
- * @param[in,out] username The username to be conformed.
- *
- * @return void.
- */
-void conform_username(char username[]);
-
 /**
  * @brief Checks if a given username is valid.
  *
@@ -265,60 +330,208 @@ void insert_special_squares(Board *board);
 Board *create_board(const int board_dim);
 
 /**
- * @brief Builds the border of the game board at a specific row.
+ * @brief Stores the board of the given dimension in the cache.
  *
- * This function builds the border of the game board at a specific row. It
- * constructs the border using the provided border characters and fills the
- * spaces between squares with dashes. The resulting border is returned as a
- * string.
+ * This function creates the board of the given dimension and builds its
+ * default visual representation (default columns, square length and theme),
+ * then stores both in the static cache used by @c get_cached_board() and
+ * @c get_cached_render().
  *
- * @param[in] borders    The array of border characters for different segments
- *                       of the border.
- * @param[in] square_len The length of each square.
- * @param[in] cols       The number of columns in the game board.
- * @param[in] rows       The number of rows in the game board.
- * @param[in] row        The current row for which the border is being built.
- * @param[in] board      The Board struct representing the game board.
+ * @param[in] board_dim The dimension of the board, in
+ *                      [@c MIN_NUM_SQUARES, @c MAX_NUM_SQUARES].
  *
- * @return The built border of the game board as a string.
+ * @return void.
  */
-char *build_border(const char *borders[4], const int square_len, const int cols,
-                   const int rows, const int row, const Board board);
+void cache_board(const int board_dim);
+
+/**
+ * @brief Builds the table holding the label of every square value.
+ *
+ * This function formats once the label of each special square (such as goose,
+ * bridge, inn, well, labyrinth, prison, and skeleton) and of each numbered
+ * square up to @c MAX_NUM_SQUARES. Calling it again does nothing.
+ *
+ * @return void.
+ */
+void build_square_labels();
 
 /**
  * @brief Converts a square value to a string representation.
  *
- * This function converts a square value to a string representation. It checks
- * for special square values (such as goose, bridge, inn, well, labyrinth,
- * prison, and skeleton) and returns the corresponding strings. For other square
- * values, it converts the integer value to a string.
+ * This function returns the label of the given square value from the table
+ * built by @c build_square_labels(), building it if needed. Special square
+ * values (such as goose, bridge, inn, well, labyrinth, prison, and skeleton)
+ * have their own label, other values are printed as numbers.
  *
  * @param[in] square The square value to convert.
  *
- * @return The string representation of the square value.
+ * @return The string representation of the square value. It points into a
+ *         static table and must not be freed.
  */
-char *sq_to_str(const int square);
+const char *sq_to_str(const int square);
 
 /**
- * @brief Builds the squares of the game board at a specific row.
+ * @brief Counts the squares printed in a specific row of the game board.
  *
- * This function builds the squares of the game board at a specific row. It
- * retrieves the square values from the Board struct and converts them to string
- * representations. The squares are then filled with the corresponding strings,
- * separated by vertical border characters. The resulting squares are returned
- * as a string.
+ * Every row holds @e cols squares, except for the last one that may hold fewer
+ * squares if the dimension of the board is not a multiple of @e cols.
  *
- * @param[in] vert       The vertical border character.
- * @param[in] square_len The length of each square.
+ * @param[in] board The Board struct representing the game board.
+ * @param[in] cols  The number of columns in the game board.
+ * @param[in] row   The row whose squares are counted.
+ *
+ * @return The number of squares in the row.
+ */
+int count_row_squares(const Board *board, const int cols, const int row);
+
+/**
+ * @brief Creates the template used to print a game board.
+ *
+ * This function builds the dashes and the blank square every row is made of,
+ * and the three lines of a full row, using the sizes and widths cached in the
+ * theme. The returned template can be used to print any board with the same
+ * number of columns, square length and theme.
+ *
+ * @param[in] theme      The theme used to print the board.
  * @param[in] cols       The number of columns in the game board.
- * @param[in] rows       The number of rows in the game board.
- * @param[in] row        The current row for which the squares are being built.
- * @param[in] board      The Board struct representing the game board.
+ * @param[in] square_len The length of each square.
+ *
+ * @return A pointer to the created BoardTemplate struct. It should be freed
+ *         with @c free_template().
+ */
+BoardTemplate *create_template(const BorderTheme *theme, const int cols,
+                               const int square_len);
+
+/**
+ * @brief Frees a template created with @c create_template().
+ *
+ * @param[in,out] tmpl The template to free.
+ *
+ * @return void.
+ */
+void free_template(BoardTemplate *tmpl);
+
+/**
+ * @brief Computes the exact size in bytes of a printed row.
+ *
+ * The size includes the top border, the squares and the bottom border of the
+ * row, each with its line end char.
+ *
+ * @param[in] tmpl      The template used to print the board.
+ * @param[in] num_cells The number of squares in the row.
+ *
+ * @return The size in bytes of the row.
+ */
+int row_size(const BoardTemplate *tmpl, const int num_cells);
+
+/**
+ * @brief Writes a border line of a row at the given position.
+ *
+ * The border is made of the @e west corner, the dashes of each square
+ * separated by the @e join border, and the @e east corner. When the row holds
+ * fewer squares than the number of columns, the missing squares are left blank
+ * on the right (left to right rows) or on the left (right to left rows).
+ *
+ * @param[out] cursor    The position where the border is written.
+ * @param[in]  tmpl      The template used to print the board.
+ * @param[in]  segments  The indexes of the west, east and join borders.
+ * @param[in]  num_cells The number of squares in the row.
+ * @param[in]  is_rtl    Whether the row is traveled right to left.
+ *
+ * @return The position right after the written border.
+ */
+char *put_border(char *cursor, const BoardTemplate *tmpl,
+                 const int segments[3], const int num_cells, const int is_rtl);
+
+/**
+ * @brief Writes the squares line of a row, with blank labels, at the given
+ *        position.
+ *
+ * @param[out] cursor    The position where the squares are written.
+ * @param[in]  tmpl      The template used to print the board.
+ * @param[in]  num_cells The number of squares in the row.
+ * @param[in]  is_rtl    Whether the row is traveled right to left.
+ *
+ * @return The position right after the written squares.
+ */
+char *put_squares(char *cursor, const BoardTemplate *tmpl, const int num_cells,
+                  const int is_rtl);
+
+/**
+ * @brief Writes the labels of a row inside its squares line.
+ *
+ * Each label is written at a fixed offset inside the squares line written by
+ * @c put_squares() (or copied from the template), so no formatting is needed.
+ *
+ * The offset of each label is saved in the visual representation of the board.
+ *
+ * @param[in,out] render  The visual representation of the board being built.
+ * @param[in,out] squares The squares line of the row, inside @e render.
+ * @param[in]     tmpl    The template used to print the board.
+ * @param[in]     board   The Board struct representing the game board.
+ * @param[in]     row     The row whose labels are written.
+ *
+ * @return void.
+ */
+void stamp_labels(BoardRender *render, char *squares, const BoardTemplate *tmpl,
+                  const Board *board, const int row);
+
+/**
+ * @brief Creates the layer drawing the players on a printed board.
+ *
+ * This function copies the printed board, assigns a slot and a character to
+ * each player and draws every player on the square they currently stand on
+ * (which may not be the first one when the game has been loaded from a save).
+ * A player is drawn with their initial, or with the next character of their
+ * username when a previous player already has that initial.
  *
- * @return The built squares of the game board as a string.
+ * @param[in] render The visual representation of the game board.
+ * @param[in] board  The Board struct representing the game board.
+ * @param[in] pls    The Players struct containing all the players.
+ *
+ * @return A pointer to the created TokenLayer struct. It should be freed with
+ *         @c free_token_layer().
+ */
+TokenLayer *create_token_layer(const BoardRender *render, const Board *board,
+                               Players *pls);
+
+/**
+ * @brief Frees a layer created with @c create_token_layer().
+ *
+ * @param[in,out] layer The layer to free.
+ *
+ * @return void.
+ */
+void free_token_layer(TokenLayer *layer);
+
+/**
+ * @brief Draws the players standing on a square.
+ *
+ * Every slot of the square is written again: with the initial of its player
+ * if they stand on the square, with a space otherwise. Positions outside of the
+ * board are ignored.
+ *
+ * @param[in,out] layer    The layer the players are drawn on.
+ * @param[in]     position The position of the square on the board.
+ *
+ * @return void.
+ */
+void stamp_tokens(TokenLayer *layer, const int position);
+
+/**
+ * @brief Moves the token of a player from a square to another.
+ *
+ * Only the two squares involved are drawn again.
+ *
+ * @param[in,out] layer      The layer the players are drawn on.
+ * @param[in]     player_idx The index of the player that moved.
+ * @param[in]     from       The position the player left.
+ * @param[in]     to         The position the player reached.
+ *
+ * @return void.
  */
-char *build_squares(const char *vert, const int square_len, const int cols,
-                    const int rows, const int row, const Board board);
+void move_token(TokenLayer *layer, const int player_idx, const int from,
+                const int to);
 
 /**
  * @brief Prints the game board.
@@ -395,20 +608,14 @@ int check_player_pos(Players *pls, Player *pl, Board *board, const int roll);
 void move_player(Players *pls, Player *pl, const int roll, Board *board);
 
 /**
- * @brief Finds the winner of the game.
+ * @brief Checks whether no player has moved yet.
  *
- * This function searches for the winner of the game by checking if any player
- * has reached or surpassed the board dimensions. It iterates through all the
- * players and checks their positions. If a player is found to have reached or
- * surpassed the board dimensions, the index of the player is returned;
- * otherwise, INDEX_NOT_FOUND is returned.
+ * @param[in] pls The players in the game.
  *
- * @param[in] pls   The Players struct containing all the players.
- * @param[in] board The Board struct representing the game board.
- *
- * @return The index of the winner, or INDEX_NOT_FOUND if no winner is found.
+ * @return @c TRUE if every player is still at the start, with no score and not
+ *         blocked, @c FALSE otherwise.
  */
-int find_winner(Players *pls, Board *board);
+int are_players_at_start(Players *pls);
 
 /**
  * @brief Prints the positions of all players on the game board.
@@ -425,6 +632,17 @@ int find_winner(Players *pls, Board *board);
  */
 void print_positions(Board *board, Players *pls);
 
+/**
+ * @brief Prints the rating of each player after a rated game.
+ *
+ * @param[in] pls     The Players struct containing all the players.
+ * @param[in] changes The change of rating of each player in the game, in
+ *                    hundredths of a point (see rate_players()).
+ *
+ * @return void.
+ */
+void print_ratings(Players *pls, const int changes[]);
+
 /**
  * @brief Displays the pause menu and handles user input for navigating the
  *        menu.
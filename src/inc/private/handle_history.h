@@ -0,0 +1,85 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file private/handle_history.h
+ * @brief This file contains private functions and declarations related to the
+ *        history module.
+ *
+ * The history is a journal (see journal.h) with a record for every finished
+ * game:
+ *
+ * @code
+ * record  seed u64 | dim u8 | players u8 | players x username (3)
+ *         | turns varint
+ * @endcode
+ *
+ * A game of four players takes 24 bytes, plus the header of its journal
+ * record.
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-19 22:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef HISTORY_MODULE_PRIVATE_H
+#define HISTORY_MODULE_PRIVATE_H
+
+#include "../../common/inc/bytes.h"
+#include "../../common/inc/types/board.h"
+#include "../../common/inc/types/player.h"
+#include "../../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The size in bytes of the seed, the dimension and the number of
+ *        players at the start of a record.
+ */
+#define HISTORY_RECORD_HEADER_SIZE 10
+
+/**
+ * @brief The maximum size in bytes of a record.
+ */
+#define HISTORY_RECORD_MAX_SIZE                                                \
+  (HISTORY_RECORD_HEADER_SIZE + MAX_NUM_PLAYERS * MAX_USERNAME_LENGTH +        \
+   VARINT_MAX_SIZE)
+
+/**
+ * @brief The maximum number of turns of an archived game, so that a malformed
+ *        record can not keep the program replaying it.
+ */
+#define HISTORY_MAX_TURNS 1000000
+
+/**
+ * @brief The name given to a game rebuilt from the history.
+ */
+#define HISTORY_GAME_NAME "archived"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Encodes the record of a finished game and advances the cursor.
+ *
+ * @param[out] cursor The position where the record is written, with at least
+ *                    @c HISTORY_RECORD_MAX_SIZE bytes available.
+ * @param[in]  pls    The players in the game, in turn order.
+ * @param[in]  board  The game board.
+ * @param[in]  seed   The seed the dice of the game started from.
+ * @param[in]  turns  The number of turns played.
+ *
+ * @return The position right after the written record.
+ */
+unsigned char *encode_history_record(unsigned char *cursor, Players *pls,
+                                     Board *board,
+                                     const unsigned long long seed,
+                                     const int turns);
+
+#endif  // !HISTORY_MODULE_PRIVATE_H
@@ -3,105 +3,274 @@
 #ifndef LEADERBOARD_MODULE_PRIVATE_H
 #define LEADERBOARD_MODULE_PRIVATE_H
 
+#include "../../common/inc/journal.h"
 #include "../../common/inc/types/entries.h"
 
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
 /**
- * @brief Reads the leaderboard from a file.
+ * @brief The size in bytes of an entry inside the leaderboard journal, its
+ *        name padded to @c MAX_USERNAME_LENGTH followed by its score.
+ */
+#define LEADERBOARD_RECORD_SIZE (MAX_USERNAME_LENGTH + 4)
+
+/**
+ * @brief The time in milliseconds after merging a batch of entries into the
+ *        leaderboard during which the next entries are only queued.
+ */
+#define LEADERBOARD_BATCH_INTERVAL 500
+
+/**
+ * @brief The number of queued entries above which they are merged without
+ *        waiting for the end of the interval.
+ */
+#define LEADERBOARD_MAX_BATCH 1024
+
+/**
+ * @brief The memory in bytes taken by the sort of the winners of the history
+ *        when the leaderboard is rebuilt (see extsort.h).
+ */
+#define LEADERBOARD_REBUILD_BUDGET (64 * 1024 * 1024)
+
+/**
+ * @brief The key rebuilding the leaderboard from the leaderboard view.
+ */
+#define LEADERBOARD_REBUILD_KEY 'r'
+
+/**
+ * @brief The window of a leaderboard holding the best score of each player.
+ */
+#define LEADERBOARD_ALL_TIME 0
+
+/**
+ * @brief The window of a leaderboard holding the best scores of today.
+ */
+#define LEADERBOARD_TODAY 1
+
+/**
+ * @brief The window of a leaderboard holding the best scores of the last
+ *        @c WINDOW_DAYS days, today included.
+ */
+#define LEADERBOARD_THIS_WEEK 2
+
+/**
+ * @brief The window of a key showing no leaderboard.
+ */
+#define LEADERBOARD_NO_WINDOW -1
+
+/**
+ * @brief The keys showing the leaderboard of each window from the leaderboard
+ *        view.
+ */
+#define LEADERBOARD_TODAY_KEY 'd'
+#define LEADERBOARD_THIS_WEEK_KEY 'w'
+#define LEADERBOARD_ALL_TIME_KEY 'a'
+
+/**
+ * @brief The key asking for a player to find from the leaderboard view.
+ */
+#define LEADERBOARD_FIND_KEY 'f'
+
+/**
+ * @brief The maximum number of entries shown at once.
+ */
+#define LEADERBOARD_MAX_PAGE 100
+
+/**
+ * @brief The number of lines of the leaderboard view not showing entries: the
+ *        title bar, the column names, the statistics of the player looked for
+ *        and the keys of the view.
+ */
+#define LEADERBOARD_VIEW_LINES 13
+
+/**
+ * @brief The position marked when no player has been found.
+ */
+#define LEADERBOARD_NO_MARK -1
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief A struct representing the page of the leaderboard shown by the
+ *        leaderboard view.
  *
- * This function reads the leaderboard data from a file and populates the
- * provided Entries structure with the leaderboard entries. If the file is
- * empty, the number of entries is set to NO_ENTRIES.
+ * @var LeaderboardView::window
+ * The window of days shown, one of @c LEADERBOARD_ALL_TIME,
+ * @c LEADERBOARD_TODAY or @c LEADERBOARD_THIS_WEEK.
+ *
+ * @var LeaderboardView::first
+ * The position of the first entry shown, starting from 0.
+ *
+ * @var LeaderboardView::page_size
+ * The number of entries shown at once.
+ *
+ * @var LeaderboardView::num_entries
+ * The number of entries of the window.
  *
- * @param[in,out] es The Entries structure to populate with the leaderboard
- *                   data.
+ * @var LeaderboardView::entries
+ * The entries shown.
+ *
+ * @var LeaderboardView::num_shown
+ * The number of entries shown, less than @c page_size on the last page.
+ *
+ * @var LeaderboardView::first_rank
+ * The rank of the first entry shown.
+ *
+ * @var LeaderboardView::sought
+ * The name of the player last looked for, or an empty string.
+ *
+ * @var LeaderboardView::marked
+ * The position of the entry of that player, or @c LEADERBOARD_NO_MARK.
+ */
+typedef struct LeaderboardView {
+  int window;                             ///< The window of days shown.
+  int first;                              ///< The first entry shown.
+  int page_size;                          ///< The entries shown at once.
+  int num_entries;                        ///< The entries of the window.
+  Entry entries[LEADERBOARD_MAX_PAGE];    ///< The entries shown.
+  int num_shown;                          ///< The number of entries shown.
+  int first_rank;                         ///< The rank of the first one.
+  char sought[MAX_USERNAME_LENGTH + 1];   ///< The player looked for.
+  int marked;                             ///< The position of that player.
+} LeaderboardView;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Decodes a record of the leaderboard journal into an entry.
+ *
+ * @param[in]  rec The record, @c LEADERBOARD_RECORD_SIZE bytes long.
+ * @param[out] e   The decoded entry.
  *
  * @return void.
  */
-void read_leaderboard(Entries *es);
+void decode_entry(const JournalRecord *rec, Entry *e);
 
 /**
- * @brief Finds a duplicate entry in the leaderboard.
+ * @brief Converts a leaderboard written by older versions of the game.
+ *
+ * Older versions wrote either the raw bytes of an @c Entries struct or a
+ * journal of entries. If the leaderboard file is such a file, it is replaced
+ * with a leaderboard file holding its valid entries (see ranktree.h), each
+ * player keeping their best score.
+ *
+ * @return void.
  *
- * This function searches for another entry with the same username in the
- * leaderboard. If a duplicate entry is found, it returns the index of the
- * duplicate entry; otherwise, it returns INDEX_NOT_FOUND.
+ * @throws CORRUPTED_LEADERBOARD_ERROR If a legacy leaderboard has an invalid
+ *                                     number of entries.
+ */
+void migrate_leaderboard(void);
+
+/**
+ * @brief Opens the leaderboard file, unless it is already open.
  *
- * @param[in] es The Entries structure containing the leaderboard entries.
- * @param[in] e  The Entry to search for duplicates of.
+ * Only the meta pages of the file are read, so it takes the same time whatever
+ * the number of entries. The file is then kept open until
+ * @c unload_leaderboard(), so that later entries are merged into it without
+ * opening it again.
  *
- * @return The index of the duplicate entry, or INDEX_NOT_FOUND if no duplicate
- *         is found.
+ * @return void.
  */
-int find_duplicate_entry(Entries es, Entry e);
+void load_leaderboard(void);
 
 /**
- * @brief Swaps two leaderboard entries.
+ * @brief Reads the top entries of the leaderboard.
  *
- * This function swaps the positions of two leaderboard entries.
+ * The entries still queued are merged first. This function opens the
+ * leaderboard with @c load_leaderboard() and populates
+ * the provided Entries structure with its first @c MAX_ENTRIES entries, in
+ * order of rank. Only the pages holding them are read. If the leaderboard is
+ * empty, the number of entries is set to NO_ENTRIES.
  *
- * @param[in,out] first  Pointer to the first Entry to swap.
- * @param[in,out] second Pointer to the second Entry to swap.
+ * @param[out] es The Entries structure to populate with the top entries.
  *
  * @return void.
  */
-void swap_entries(Entry *first, Entry *second);
+void read_leaderboard(Entries *es);
 
 /**
- * @brief Removes duplicate entries from the leaderboard.
+ * @brief Reads the top entries of the leaderboard of a window of days.
  *
- * This function removes duplicate entries from the leaderboard by shifting the
- * subsequent entries to fill the gaps. It ensures that only unique entries
- * remain in the leaderboard.
+ * The best scores of today and of the last days are kept apart from the
+ * leaderboard, as the best @c WINDOW_TOP entries of each day (see
+ * timewindow.h), so only the few days of the window are merged, without
+ * reading the leaderboard or the history. They are read from their file the
+ * first time they are needed, and written with the batch of entries they were
+ * updated with.
  *
- * @param[in,out] es The Entries structure containing the leaderboard entries.
+ * @param[out] es     The Entries structure to populate with the top entries.
+ * @param[in]  window One of @c LEADERBOARD_ALL_TIME, @c LEADERBOARD_TODAY or
+ *                    @c LEADERBOARD_THIS_WEEK.
  *
  * @return void.
  */
-void rm_duplicate_entries(Entries *es);
+void read_window_leaderboard(Entries *es, const int window);
 
 /**
- * @brief Sorts the leaderboard entries.
+ * @brief Reads the page of the leaderboard shown by the leaderboard view.
  *
- * This function sorts the leaderboard entries based on the final score and
- * username. Entries with higher scores come first, and in case of ties, entries
- * with lexicographically smaller usernames come first. After sorting, any
- * duplicate entries are removed from the leaderboard.
+ * The position of the first entry is moved back within the window if needed,
+ * so that the last page is full. On the leaderboard of all time only the
+ * entries of the page are read, with a range query on the leaderboard file
+ * (see ranktree.h), and the rank of the first one is found from its score, so
+ * the time taken does not depend on the number of entries. The other windows
+ * hold a few entries only (see @c read_window_leaderboard()).
  *
- * @param[in,out] es The Entries structure containing the leaderboard entries.
+ * @param[in,out] v The view, whose window, first position and page size are
+ *                  set.
  *
  * @return void.
  */
-void sort_entries(Entries *es);
+void read_leaderboard_page(LeaderboardView *v);
 
 /**
- * @brief Prints the leaderboard to the console.
+ * @brief Looks for a player in the window of the leaderboard view, and moves
+ *        the view so that their entry is in the middle of the page.
  *
- * This function prints the leaderboard entries to the console. It displays the
- * rank, username, and final score for each entry. Entries are printed in
- * descending order based on the final score, and ties are broken by
- * lexicographically sorting the usernames. If the leaderboard is empty, it
- * prints an appropriate error message.
+ * @param[in,out] v    The view.
+ * @param[in]     name The name of the player.
  *
- * @param[in] es The Entries structure containing the leaderboard entries.
+ * @return void.
+ */
+void find_leaderboard_player(LeaderboardView *v, const char name[]);
+
+/**
+ * @brief Prints the page of the leaderboard view to the console.
+ *
+ * This function prints the entries of the page, with the rank, username, and
+ * final score of each one, followed by the keys of the view. Entries are in
+ * descending order of score, and ties are broken by sorting the usernames.
+ * Players with the same score share the same rank. The entry of the player
+ * found last is highlighted. If the leaderboard is empty, it prints an
+ * appropriate error message.
+ *
+ * The page is drawn at once over the previous one (see @c ScreenBuffer), so
+ * scrolling does not flicker.
+ *
+ * @param[in] v The view, with its page read by @c read_leaderboard_page().
  *
  * @return void.
  */
-void print_leaderboard(Entries es);
+void print_leaderboard(const LeaderboardView *v);
 
 /**
  * @brief Displays the leaderboard on the console.
  *
- * This function displays the leaderboard on the console by calling
- * print_leaderboard and adding additional formatting. It also waits for a back
- * key (b/ESC/ENTER/SPACEBAR) to be pressed before returning.
- *
- * @param[in] es The Entries structure containing the leaderboard entries.
+ * This function displays the leaderboard on the console one page at a time,
+ * filling the height of the terminal, and waits for a back key
+ * (b/ESC/ENTER/SPACEBAR) to be pressed before returning. It starts with the
+ * first page of the leaderboard of all time. PAGE UP and PAGE DOWN scroll by
+ * one page, HOME and END go to the first and last page, and
+ * @c LEADERBOARD_FIND_KEY asks for a player to show. The key of another
+ * window of days switches to its leaderboard, and @c LEADERBOARD_REBUILD_KEY
+ * rebuilds the leaderboard with @c rebuild_leaderboard(). The page is read
+ * and printed again after each of them.
  *
  * @return void.
  */
-void display_leaderboard(Entries es);
+void display_leaderboard(void);
 
 #endif  // !LEADERBOARD_MODULE_PRIVATE_H
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file private/handle_rating.h
+ * @brief This file contains private functions and declarations related to the
+ *        rating module.
+ *
+ * The ratings are a journal (see journal.h) whose records each hold players
+ * encoded with @c encode_ratings(), a player of a later record replacing the
+ * same player of an earlier one. Each rated game appends a record with its
+ * players, and once the journal holds @c RATINGS_COMPACT_RATIO records per
+ * player the I/O pool compacts it into a snapshot of every player right after
+ * the append (see @c append_compact_journal()).
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 09:10
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef RATING_MODULE_PRIVATE_H
+#define RATING_MODULE_PRIVATE_H
+
+#include "../../common/inc/rating.h"
+#include "../../common/inc/types/board.h"
+#include "../../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of records per player above which the journal of the
+ *        ratings is compacted.
+ */
+#define RATINGS_COMPACT_RATIO 4
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Finds the order in which the players finished a game.
+ *
+ * The winner comes first, then the others from the one closest to the last
+ * square, the players on the same square finishing together.
+ *
+ * @param[in]  pls   The players in the game.
+ * @param[in]  board The game board.
+ * @param[out] g     The outcome of the game.
+ *
+ * @return void.
+ */
+void get_game_outcome(Players *pls, Board *board, GameOutcome *g);
+
+#endif  // !RATING_MODULE_PRIVATE_H
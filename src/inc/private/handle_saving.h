@@ -36,6 +36,7 @@
 #ifndef SAVING_MODULE_PRIVATE_H
 #define SAVING_MODULE_PRIVATE_H
 
+#include "../../common/inc/savefile.h"
 #include "../../common/inc/types/gamestates.h"
 
 #include <stdio.h>
@@ -53,48 +54,109 @@
  */
 #define QUIT_GAME -1
 
+/**
+ * @brief The format used to print the date of a save.
+ */
+#define SAVE_DATE_FORMAT "%Y-%m-%d %H:%M"
+
+/**
+ * @brief Indicates that the number of saves is not limited.
+ */
+#define NO_SAVES_LIMIT 0
+
+/**
+ * @brief The maximum number of saves kept in the save file, or
+ *        @c NO_SAVES_LIMIT to keep every save.
+ */
+#define SAVES_LIMIT NO_SAVES_LIMIT
+
+/**
+ * @brief When the limit of saves is reached, asks the user which save to
+ *        overwrite.
+ */
+#define EVICT_PROMPT 0
+
+/**
+ * @brief When the limit of saves is reached, overwrites the save that was
+ *        saved first.
+ */
+#define EVICT_OLDEST 1
+
+/**
+ * @brief When the limit of saves is reached, overwrites the save that was
+ *        saved or loaded least recently.
+ */
+#define EVICT_LRU 2
+
+/**
+ * @brief The save overwritten when the limit of saves is reached, one of
+ *        @c EVICT_PROMPT, @c EVICT_OLDEST and @c EVICT_LRU.
+ */
+#define EVICTION_POLICY EVICT_LRU
+
 // -------------------------------------------------------------------------- //
 // -------------------------------------------------------------------------- //
 
+/**
+ * @brief Prints the details of a save.
+ *
+ * This function prints the players of the save with their positions, the size
+ * of the board and the date of the save, reading them from its summary.
+ *
+ * @param[in] sum The summary of the save.
+ *
+ * @return void.
+ */
+void print_save_details(const SaveSummary *sum);
+
 /**
  * @brief Asks the user to choose a save and returns the selected index.
  *
  * This function displays the available save games and prompts the user to
  * choose one. It prints the game name, number of players, player names with
- * their positions, and the board size for each save game. The user is then
- * prompted to enter the index of the desired save game. The function validates
- * the input and repeats the prompt until a valid index is entered. The chosen
- * index is returned.
+ * their positions, the board size and the date for each save game, reading
+ * only the summaries of the saves. The user is then prompted to enter the
+ * index of the desired save game. The function validates the input and
+ * repeats the prompt until a valid index is entered. The chosen index is
+ * returned.
  *
- * @param[in] gss The GameStates struct containing the available save games.
+ * @param[in] sf The save file containing the available save games.
  *
- * @return The index of the chosen save game.
+ * @return The index of the chosen save game, or @c QUIT_GAME.
  */
-int choose_save(GameStates gss);
+int choose_save(const SaveFile *sf);
 
 /**
- * @brief Reads the saved game states from a file.
+ * @brief Chooses the save to overwrite when the limit of saves is reached.
  *
- * This function attempts to read the saved game states from the specified file.
- * If the file is not readable or empty, it sets the number of games to
- * `NO_SAVED_GAMES`. Otherwise, it reads the game states from the file into the
- * provided GameStates struct.
+ * Depending on @c EVICTION_POLICY, the user is asked which save to overwrite,
+ * or the summaries are scanned for the save saved first or used least
+ * recently.
  *
- * @param[in,out] gss The GameStates struct to store the read game states.
+ * @param[in] sf The save file.
  *
- * @return void.
+ * @return The index of the save to overwrite, or @c QUIT_GAME.
+ */
+int choose_evicted_save(const SaveFile *sf);
+
+/**
+ * @brief Opens the save file.
+ *
+ * A file written by older versions of the game is migrated to the current
+ * format first (see @c migrate_save_file()).
+ *
+ * @return The opened save file, to close with @c close_save_file().
  */
-void read_saves(GameStates *gss);
+SaveFile *open_saves();
 
 /**
  * @brief Writes the current game state to the save file.
  *
- * This function attempts to save the current game state to the save file.
- * It first reads the existing game states from the file into a GameStates
- * struct. If the number of saves is within bounds, the current game state is
- * appended to the struct. If the maximum number of saves is reached, the user
- * is prompted to choose a game to overwrite. The updated GameStates struct is
- * then written back to the file.
+ * This function attempts to save the current game state to the save file. If
+ * a save with the same name exists it is updated, otherwise the current game
+ * state is added to the file. If @c SAVES_LIMIT is reached, a save is
+ * overwritten as chosen by @c choose_evicted_save(). The other saves are not
+ * rewritten.
  *
  * @param[in] gs The GameState struct representing the current game state to
  *               save.
@@ -0,0 +1,58 @@
+// Copyright (c) 2023 @authors. GNU GPLv3.
+
+/**
+ * @file private/handle_stats.h
+ * @brief This file contains private functions and declarations related to the
+ *        statistics module.
+ *
+ * The statistics are a journal (see journal.h) whose records each hold
+ * players encoded with @c encode_player_stats(), a player of a later record
+ * replacing the same player of an earlier one. Each counted game appends a
+ * record with its players, and once the journal holds
+ * @c STATS_COMPACT_RATIO records per player the I/O pool compacts it into a
+ * snapshot of every player right after the append (see
+ * @c append_compact_journal()).
+ *
+ * @authors
+ *    Amorese Emanuele
+ *    Blanco Lorenzo
+ *    Cannito Antonio
+ *    Fidanza Simone
+ *    Lecini Fabio
+ *
+ * @date 2026-10-20 11:30
+ * @version 1.0
+ * @copyright GNU GPLv3
+ */
+#ifndef STATS_MODULE_PRIVATE_H
+#define STATS_MODULE_PRIVATE_H
+
+#include "../../common/inc/playerstats.h"
+#include "../../common/inc/types/board.h"
+#include "../../common/inc/types/players.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The number of records per player above which the journal of the
+ *        statistics is compacted.
+ */
+#define STATS_COMPACT_RATIO 4
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Adds to the tally of a finished game the game played by each of its
+ *        players and the game won by its winner.
+ *
+ * @param[in,out] t     The tally of the moves of the game.
+ * @param[in]     pls   The players in the game.
+ * @param[in]     board The game board.
+ *
+ * @return void.
+ */
+void finish_game_tally(GameTally *t, Players *pls, Board *board);
+
+#endif  // !STATS_MODULE_PRIVATE_H
@@ -12,21 +12,27 @@
 #include <time.h>
 
 #include "./common/inc/error.h"
+#include "./common/inc/iopool.h"
 #include "./common/inc/logger.h"
+#include "./common/inc/math.h"
 #include "./common/inc/term.h"
 
 #include "./inc/globals.h"
 
+#include "./inc/handle_autosave.h"
 #include "./inc/handle_game.h"
 #include "./inc/handle_help.h"
 #include "./inc/handle_leaderboard.h"
+#include "./inc/handle_rating.h"
 #include "./inc/handle_saving.h"
+#include "./inc/handle_stats.h"
 
 void main_menu(void) {
   logger.enter_fn(__func__);
 
   new_screen();
   print_menu(MAIN_MENU);
+  printf("board theme: %s%s", get_board_theme()->name, LINE_END);
 
   logger.exit_fn();
 }
@@ -36,10 +42,16 @@ int main(void) {
   logger.start("goose.log");
   logger.enter_fn(__func__);
 
-  srand(time(NULL));
+  seed_dice(time(NULL));
+  start_io_pool();
+  // the board may be printed with UTF-8 borders (see theme.h)
+  use_utf8_output();
 
   // to read non-blocking warnings from compiler
   wait_keypress("press any key to launch game");
+
+  // a game interrupted by a crash can be resumed before anything else
+  resume_autosave();
   main_menu();
 
   int menu_loop = TRUE;
@@ -63,6 +75,10 @@ int main(void) {
       logger.log("displaying help menu");
       help_menu();
       main_menu();
+    } else if (key == 't') {
+      logger.log("changing board theme");
+      set_board_theme(get_next_theme(get_board_theme()));
+      main_menu();
     } else if (key == 'q' || key == ESC) {
       logger.log("exiting game");
       clear_line();
@@ -75,6 +91,11 @@ int main(void) {
     }
   }
 
+  finish_saving();
+  unload_leaderboard();
+  unload_ratings();
+  unload_stats();
+  stop_io_pool();
   logger.stop();
   return EXIT_SUCCESS;
 }
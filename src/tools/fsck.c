@@ -0,0 +1,379 @@
+// Copyright (c) 2023 @authors. GNU GPLv3
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+// Checks a directory of save files and leaderboards written by older versions
+// of the game, and converts them to the current formats.
+//
+//   fsck.exe <directory> [<output directory>]
+//
+// Every field of every record of the legacy files is checked (see legacy.h).
+// If an output directory is given, the valid records of each legacy file are
+// written there to a file with the same name, in the current format. Files are
+// read one record at a time by a pool of threads, each taking the next file of
+// the directory, so that any number of files can be checked with a few
+// kilobytes per thread.
+//
+// The process exits with EXIT_FAILURE if any file or record is not valid.
+
+#include <Windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/inc/legacy.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/ranktree.h"
+#include "../common/inc/savefile.h"
+#include "../common/inc/types/entries.h"
+#include "../common/inc/types/gamestates.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief The maximum number of threads checking files.
+ */
+#define FSCK_MAX_THREADS 16
+
+/**
+ * @brief The descriptions of the outcomes of the check of a record.
+ */
+static const char *outcome_texts[LEGACY_NUM_OUTCOMES] = {
+    "valid",
+    "game name not terminated",
+    "number of players out of range",
+    "board dimension out of range",
+    "invalid username",
+    "duplicate username",
+    "position outside the board",
+    "negative score",
+    "invalid number of turns blocked",
+    "truncated record",
+};
+
+/**
+ * @brief The outcome of the check of a file.
+ */
+typedef struct FileReport {
+  int kind;                              ///< The kind of legacy file.
+  int is_readable;                       ///< Whether the file was read.
+  int count;                             ///< The number of records stored.
+  int is_count_valid;                    ///< Whether the count fits the file.
+  int outcomes[LEGACY_NUM_OUTCOMES];     ///< The records by outcome.
+  int is_converted;                      ///< Whether the file was converted.
+} FileReport;
+
+/**
+ * @brief The totals of the files checked so far.
+ */
+typedef struct FsckTotals {
+  int num_files;       ///< The number of files checked.
+  int num_legacy;      ///< The number of legacy files.
+  int num_converted;   ///< The number of files converted.
+  int num_records;     ///< The number of records checked.
+  int num_invalid;     ///< The number of records not valid.
+  int num_unreadable;  ///< The number of files that could not be read.
+  int num_corrupted;   ///< The number of legacy files with a bad count.
+} FsckTotals;
+
+/**
+ * @brief The state shared by the threads checking files.
+ */
+typedef struct Fsck {
+  const char *dir;          ///< The directory checked.
+  const char *out_dir;      ///< The output directory, or @c NULL.
+  HANDLE find;              ///< The listing of the directory.
+  WIN32_FIND_DATAA found;   ///< The next file of the listing.
+  int has_next;             ///< Whether @c found holds a file not taken yet.
+  FsckTotals totals;        ///< The totals of the files checked.
+  CRITICAL_SECTION lock;    ///< The lock of the listing and the totals.
+} Fsck;
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Takes the next regular file of the directory.
+ *
+ * @return @c FALSE once every file has been taken.
+ */
+static int take_next_file(Fsck *fsck, char name[]) {
+  int is_taken = FALSE;
+  EnterCriticalSection(&fsck->lock);
+  while (fsck->has_next && !is_taken) {
+    if (!(fsck->found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      snprintf(name, MAX_PATH, "%s", fsck->found.cFileName);
+      is_taken = TRUE;
+    }
+    fsck->has_next = FindNextFileA(fsck->find, &fsck->found);
+  }
+  LeaveCriticalSection(&fsck->lock);
+  return is_taken;
+}
+
+/**
+ * @brief Writes a converted file to the output directory.
+ */
+static int write_output(const Fsck *fsck, const char name[],
+                        const unsigned char data[], const int size) {
+  char path[2 * MAX_PATH];
+  snprintf(path, 2 * MAX_PATH, "%s\\%s", fsck->out_dir, name);
+  FILE *fp;
+  if (fopen_s(&fp, path, "wb")) {
+    return FALSE;
+  }
+  const int written = fwrite(data, 1, size, fp);
+  return fclose(fp) == 0 && written == size;
+}
+
+/**
+ * @brief Reads the games of a legacy save file one at a time, keeping the
+ *        valid ones, and converts them if asked to.
+ */
+static void check_saves(const Fsck *fsck, const char name[], LegacyFile *lf,
+                        FileReport *report) {
+  GameState games[MAX_SAVED_GAMES];
+  int num_games = 0;
+  int i = 0;
+  while (i < lf->count) {
+    const int outcome = next_legacy_game(lf, &games[num_games]);
+    report->outcomes[outcome] = report->outcomes[outcome] + 1;
+    if (outcome == LEGACY_VALID) {
+      num_games = num_games + 1;
+    }
+    i = i + 1;
+  }
+
+  if (fsck->out_dir) {
+    int size;
+    unsigned char *data =
+        layout_save_file(games, num_games, SAVE_NO_TIMESTAMP, &size);
+    report->is_converted = data && write_output(fsck, name, data, size);
+    free(data);
+  }
+}
+
+/**
+ * @brief Adds an entry to entries in order of rank, or raises the score of the
+ *        entry of the same player.
+ */
+static void rank_entry(Entry entries[], int *num_entries, const Entry *e) {
+  int i = 0;
+  while (i < *num_entries && strcmp(get_name(&entries[i]), get_name(e)) != 0) {
+    i = i + 1;
+  }
+  if (i < *num_entries) {
+    if (get_final_score(&entries[i]) >= get_final_score(e)) {
+      return;
+    }
+    memmove(&entries[i], &entries[i + 1],
+            (*num_entries - i - 1) * sizeof(Entry));
+    *num_entries = *num_entries - 1;
+  }
+
+  // higher scores come first and ties are broken by name
+  i = 0;
+  while (i < *num_entries &&
+         (get_final_score(&entries[i]) > get_final_score(e) ||
+          (get_final_score(&entries[i]) == get_final_score(e) &&
+           strcmp(get_name(&entries[i]), get_name(e)) < 0))) {
+    i = i + 1;
+  }
+  memmove(&entries[i + 1], &entries[i], (*num_entries - i) * sizeof(Entry));
+  entries[i] = *e;
+  *num_entries = *num_entries + 1;
+}
+
+/**
+ * @brief Reads the entries of a legacy leaderboard one at a time, keeping the
+ *        best valid entry of each player, and converts them if asked to.
+ */
+static void check_leaderboard(const Fsck *fsck, const char name[],
+                              LegacyFile *lf, FileReport *report) {
+  Entry entries[MAX_ENTRIES];
+  int num_entries = 0;
+  int i = 0;
+  while (i < lf->count) {
+    Entry e;
+    const int outcome = next_legacy_entry(lf, &e);
+    report->outcomes[outcome] = report->outcomes[outcome] + 1;
+    if (outcome == LEGACY_VALID) {
+      rank_entry(entries, &num_entries, &e);
+    }
+    i = i + 1;
+  }
+
+  if (fsck->out_dir) {
+    int size;
+    unsigned char *data = layout_rank_tree(entries, num_entries, &size);
+    report->is_converted = data && write_output(fsck, name, data, size);
+    free(data);
+  }
+}
+
+/**
+ * @brief Checks a file of the directory, converting it if asked to.
+ */
+static void check_file(const Fsck *fsck, const char name[],
+                       FileReport *report) {
+  memset(report, 0, sizeof(*report));
+
+  char path[2 * MAX_PATH];
+  snprintf(path, 2 * MAX_PATH, "%s\\%s", fsck->dir, name);
+  LegacyFile lf;
+  report->is_readable = open_legacy(&lf, path);
+  if (!report->is_readable) {
+    return;
+  }
+  report->kind = lf.kind;
+  report->count = lf.count;
+  report->is_count_valid = is_legacy_count_valid(&lf);
+
+  if (lf.kind == LEGACY_SAVES && report->is_count_valid) {
+    check_saves(fsck, name, &lf, report);
+  } else if (lf.kind == LEGACY_LEADERBOARD && report->is_count_valid) {
+    check_leaderboard(fsck, name, &lf, report);
+  }
+  close_legacy(&lf);
+}
+
+/**
+ * @brief Prints the outcome of the check of a file and adds it to the totals.
+ *
+ * It is called with the lock held, so that the lines of different files are
+ * not mixed.
+ */
+static void report_file(Fsck *fsck, const char name[],
+                        const FileReport *report) {
+  FsckTotals *totals = &fsck->totals;
+  totals->num_files = totals->num_files + 1;
+  if (!report->is_readable) {
+    totals->num_unreadable = totals->num_unreadable + 1;
+    printf("%s: not readable\n", name);
+    return;
+  }
+  if (report->kind == LEGACY_NONE) {
+    printf("%s: not a legacy file, skipped\n", name);
+    return;
+  }
+
+  totals->num_legacy = totals->num_legacy + 1;
+  const char *kind =
+      report->kind == LEGACY_SAVES ? "legacy saves" : "legacy leaderboard";
+  if (!report->is_count_valid) {
+    totals->num_corrupted = totals->num_corrupted + 1;
+    printf("%s: %s with %i records, not converted\n", name, kind,
+           report->count);
+    return;
+  }
+
+  printf("%s: %s, %i records, %i valid", name, kind, report->count,
+         report->outcomes[LEGACY_VALID]);
+  totals->num_records = totals->num_records + report->count;
+  int outcome = LEGACY_VALID + 1;
+  while (outcome < LEGACY_NUM_OUTCOMES) {
+    if (report->outcomes[outcome] > 0) {
+      printf(", %i %s", report->outcomes[outcome], outcome_texts[outcome]);
+      totals->num_invalid = totals->num_invalid + report->outcomes[outcome];
+    }
+    outcome = outcome + 1;
+  }
+  if (fsck->out_dir) {
+    printf(report->is_converted ? ", converted" : ", not writable");
+    totals->num_converted = totals->num_converted + report->is_converted;
+  }
+  printf("\n");
+}
+
+/**
+ * @brief The body of a thread checking files until every file of the
+ *        directory has been taken.
+ */
+static DWORD WINAPI check_files(LPVOID arg) {
+  Fsck *fsck = (Fsck *)arg;
+
+  char name[MAX_PATH];
+  while (take_next_file(fsck, name)) {
+    FileReport report;
+    check_file(fsck, name, &report);
+
+    EnterCriticalSection(&fsck->lock);
+    report_file(fsck, name, &report);
+    LeaveCriticalSection(&fsck->lock);
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  // the logger keeps a single call stack, so it can not follow many threads
+  logger.disable();
+
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s <directory> [<output directory>]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Fsck fsck;
+  fsck.dir = argv[1];
+  fsck.out_dir = argc == 3 ? argv[2] : NULL;
+  memset(&fsck.totals, 0, sizeof(fsck.totals));
+
+  char pattern[MAX_PATH];
+  snprintf(pattern, MAX_PATH, "%s\\*", fsck.dir);
+  fsck.find = FindFirstFileA(pattern, &fsck.found);
+  if (fsck.find == INVALID_HANDLE_VALUE) {
+    fprintf(stderr, "can not list '%s'\n", fsck.dir);
+    return EXIT_FAILURE;
+  }
+  fsck.has_next = TRUE;
+  InitializeCriticalSection(&fsck.lock);
+
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int num_threads = info.dwNumberOfProcessors;
+  if (num_threads > FSCK_MAX_THREADS) {
+    num_threads = FSCK_MAX_THREADS;
+  }
+  HANDLE threads[FSCK_MAX_THREADS];
+  int i = 0;
+  while (i < num_threads) {
+    threads[i] = CreateThread(NULL, 0, check_files, &fsck, 0, NULL);
+    if (!threads[i]) {
+      fprintf(stderr, "can not start the threads\n");
+      return EXIT_FAILURE;
+    }
+    i = i + 1;
+  }
+  WaitForMultipleObjects(num_threads, threads, TRUE, INFINITE);
+  i = 0;
+  while (i < num_threads) {
+    CloseHandle(threads[i]);
+    i = i + 1;
+  }
+  FindClose(fsck.find);
+  DeleteCriticalSection(&fsck.lock);
+
+  const FsckTotals *totals = &fsck.totals;
+  printf("\nchecked %i files with %i threads: %i legacy, %i records, "
+         "%i invalid records, %i corrupted, %i unreadable",
+         totals->num_files, num_threads, totals->num_legacy,
+         totals->num_records, totals->num_invalid, totals->num_corrupted,
+         totals->num_unreadable);
+  if (fsck.out_dir) {
+    printf(", %i converted", totals->num_converted);
+  }
+  printf("\n");
+
+  const int is_clean = totals->num_invalid == 0 &&
+                       totals->num_corrupted == 0 &&
+                       totals->num_unreadable == 0 &&
+                       (!fsck.out_dir ||
+                        totals->num_converted == totals->num_legacy -
+                                                     totals->num_corrupted);
+  return is_clean ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2023 @authors. GNU GPLv3
+// @authors
+//    Amorese Emanuele
+//    Blanco Lorenzo
+//    Cannito Antonio
+//    Fidanza Simone
+//    Lecini Fabio
+
+// Merges leaderboards written apart, e.g. by games played on different threads
+// or processes, into a single leaderboard.
+//
+//   merge.exe <output file> <leaderboard>...
+//
+// Each leaderboard is already in order of rank, so they are merged with a
+// loser tree (see merge.h), reading each of them a few kilobytes at a time.
+// A player found in several leaderboards keeps their best score. The output
+// file must not be one of the leaderboards merged.
+//
+// The process exits with EXIT_FAILURE if the arguments are not valid, and
+// stops with the error of the game if a leaderboard can not be read or is
+// corrupted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/inc/error.h"
+#include "../common/inc/iopool.h"
+#include "../common/inc/logger.h"
+#include "../common/inc/merge.h"
+#include "../common/inc/ranktree.h"
+#include "../common/inc/types/entry.h"
+
+// -------------------------------------------------------------------------- //
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief Adds an entry at the end of the merged entries, making room for it if
+ *        needed.
+ */
+static void append_entry(Entry **entries, int *num_entries, int *capacity,
+                         const Entry *e) {
+  if (*num_entries == *capacity) {
+    *capacity = 2 * *capacity;
+    Entry *grown = (Entry *)realloc(  // NOLINT
+        *entries, *capacity * sizeof(Entry));
+    if (!grown) {
+      throw_err(ALLOCATION_ERROR);
+    }
+    *entries = grown;
+  }
+  (*entries)[*num_entries] = *e;
+  *num_entries = *num_entries + 1;
+}
+
+int main(int argc, char *argv[]) {
+  logger.disable();
+
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <output file> <leaderboard>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  const char *out_path = argv[1];
+  const int num_shards = argc - 2;
+  RankTree **shards = (RankTree **)malloc(  // NOLINT
+      num_shards * sizeof(RankTree *));
+  if (!shards) {
+    throw_err(ALLOCATION_ERROR);
+  }
+  int i = 0;
+  while (i < num_shards) {
+    if (strcmp(argv[i + 2], out_path) == 0) {
+      fprintf(stderr, "the output file can not be merged too\n");
+      return EXIT_FAILURE;
+    }
+    shards[i] = open_rank_tree(argv[i + 2]);
+    i = i + 1;
+  }
+
+  int capacity = MERGE_BUFFER_ENTRIES;
+  int num_entries = 0;
+  Entry *entries = (Entry *)malloc(capacity * sizeof(Entry));  // NOLINT
+  if (!entries) {
+    throw_err(ALLOCATION_ERROR);
+  }
+  Merge *m = start_merge(shards, num_shards);
+  Entry e;
+  while (next_merged(m, &e)) {
+    append_entry(&entries, &num_entries, &capacity, &e);
+  }
+  const int num_read = m->num_read;
+  end_merge(m);
+  i = 0;
+  while (i < num_shards) {
+    close_rank_tree(shards[i]);
+    i = i + 1;
+  }
+  free(shards);
+
+  finish_io(write_rank_tree(out_path, entries, num_entries));
+  free(entries);
+  printf("merged %i leaderboards, %i entries of %i players, into %s\n",
+         num_shards, num_read, num_entries, out_path);
+  return EXIT_SUCCESS;
+}